@@ -1,4 +1,4 @@
-QT += widgets
+QT += widgets concurrent sql
 
 TEMPLATE = app
 TARGET = rewise-app
@@ -10,22 +10,43 @@ INCLUDEPATH += $$PWD/src
 SOURCES += \
     src/main.cpp \
     src/mainwindow.cpp \
+    src/storage/CardBodyStore.cpp \
+    src/storage/CardStore.cpp \
+    src/storage/FuzzySearch.cpp \
     src/storage/Database.cpp \
     src/storage/Repository.cpp \
+    src/storage/ReviewLog.cpp \
+    src/storage/ReviewRollups.cpp \
+    src/storage/ReviewSessionFile.cpp \
+    src/storage/SqliteRepository.cpp \
+    src/storage/StorageBackend.cpp \
+    src/storage/TextArena.cpp \
+    src/storage/TextIndex.cpp \
+    src/review/AliasSampler.cpp \
+    src/review/CardOrder.cpp \
     src/review/Levenshtein.cpp \
+    src/review/ReferenceCache.cpp \
     src/review/ReviewEngine.cpp \
+    src/review/Scheduler.cpp \
     src/review/TextNormalize.cpp \
     src/review/WordDiff.cpp \
     src/ui/pages/LibraryPage.cpp \
     src/ui/pages/ReviewPage.cpp \
+    src/ui/pages/StatsPage.cpp \
     src/ui/widgets/CardEditDialog.cpp \
     src/ui/widgets/CardTableModel.cpp \
+    src/ui/widgets/DailyBarsWidget.cpp \
     src/ui/widgets/DiffTextWidget.cpp \
+    src/ui/widgets/ExamResultsWidget.cpp \
+    src/ui/widgets/ExamSetupDialog.cpp \
     src/ui/widgets/FolderEditDialog.cpp \
+    src/ui/widgets/FolderListDelegate.cpp \
     src/ui/widgets/FolderListModel.cpp \
+    src/ui/widgets/FolderScoringDialog.cpp \
     src/ui/widgets/InlineMessageWidget.cpp \
+    src/ui/widgets/ReviewFoldersDialog.cpp \
     src/ui/widgets/FolderNavButton.cpp \
-    src/ui/widgets/CardTileButton.cpp
+    src/ui/widgets/CardTileDelegate.cpp
 
 HEADERS += \
     src/mainwindow.h \
@@ -33,30 +54,59 @@ HEADERS += \
     src/domain/DomainJson.h \
     src/domain/Folder.h \
     src/domain/Id.h \
+    src/domain/ReviewSettings.h \
+    src/domain/ReviewState.h \
+    src/domain/UuidCodec.h \
+    src/storage/CardBodyStore.h \
+    src/storage/CardStore.h \
+    src/storage/FuzzySearch.h \
+    src/storage/ChangeEvents.h \
     src/storage/Database.h \
+    src/storage/PersistentHash.h \
+    src/storage/PersistentVector.h \
     src/storage/Repository.h \
+    src/storage/ReviewLog.h \
+    src/storage/ReviewRollups.h \
+    src/storage/ReviewSessionFile.h \
+    src/storage/SqliteRepository.h \
+    src/storage/StorageBackend.h \
     src/storage/StorageJson.h \
+    src/storage/TextArena.h \
+    src/storage/TextIndex.h \
+    src/review/AliasSampler.h \
+    src/review/CardOrder.h \
     src/review/Levenshtein.h \
+    src/review/ReferenceCache.h \
     src/review/ReviewEngine.h \
+    src/review/Scheduler.h \
     src/review/ReviewTypes.h \
     src/review/TextNormalize.h \
     src/review/WordDiff.h \
     src/ui/pages/LibraryPage.h \
     src/ui/pages/ReviewPage.h \
+    src/ui/pages/StatsPage.h \
     src/ui/widgets/CardEditDialog.h \
     src/ui/widgets/CardTableModel.h \
+    src/ui/widgets/DailyBarsWidget.h \
     src/ui/widgets/DiffTextWidget.h \
+    src/ui/widgets/ExamResultsWidget.h \
+    src/ui/widgets/ExamSetupDialog.h \
     src/ui/widgets/FolderEditDialog.h \
+    src/ui/widgets/FolderListDelegate.h \
     src/ui/widgets/FolderListModel.h \
+    src/ui/widgets/FolderScoringDialog.h \
     src/ui/widgets/InlineMessageWidget.h \
+    src/ui/widgets/ReviewFoldersDialog.h \
     src/ui/widgets/LayoutUtils.h \
+    src/ui/widgets/NumberItem.h \
     src/ui/widgets/FolderNavButton.h \
-    src/ui/widgets/CardTileButton.h
+    src/ui/widgets/CardTileDelegate.h
 
 FORMS += \
     src/mainwindow.ui \
     src/ui/pages/LibraryPage.ui \
-    src/ui/pages/ReviewPage.ui
+    src/ui/pages/ReviewPage.ui \
+    src/ui/pages/StatsPage.ui
 
 RESOURCES += \
     resources/resources.qrc
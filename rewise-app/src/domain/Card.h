@@ -3,6 +3,7 @@
 
 #include "Id.h"
 #include "DomainJson.h"
+#include "ReviewState.h"
 
 #include <QString>
 #include <QDateTime>
@@ -23,6 +24,23 @@ struct Card final {
     qint64 createdAtMsUtc = 0;
     qint64 updatedAtMsUtc = 0;
 
+    // Lazy-body mode (storage::CardBodyStore): question/answer hold only a preview;
+    // the backend that loaded the card reads the full text by id on demand.
+    // Not serialized; resolve before toJson().
+    bool textIsPreview = false;
+
+    // Spaced-repetition schedule. Not content: edits keep it, updatedAtMsUtc ignores it.
+    ReviewState review;
+
+    bool hasFullText() const { return !textIsPreview; }
+
+    // Replaces the text; the card is "full" (resident) from now on.
+    void setText(const QString& q, const QString& a) {
+        question = q;
+        answer = a;
+        textIsPreview = false;
+    }
+
     static qint64 nowUtcMs() {
         return QDateTime::currentDateTimeUtc().toMSecsSinceEpoch();
     }
@@ -80,6 +98,9 @@ struct Card final {
         // JSON numbers are stored as double in Qt JSON, but epoch ms is safe in our range.
         o.insert(json_keys::kCreatedAtMs, static_cast<double>(createdAtMsUtc));
         o.insert(json_keys::kUpdatedAtMs, static_cast<double>(updatedAtMsUtc));
+
+        // New cards carry no schedule (keeps files of fresh decks unchanged).
+        if (!review.isNew()) o.insert(json_keys::kReview, review.toJson());
         return o;
     }
 
@@ -144,6 +165,7 @@ struct Card final {
         tmp.answer = aV.toString();
         tmp.createdAtMsUtc = created;
         tmp.updatedAtMsUtc = updated;
+        tmp.review = ReviewState::fromJson(o.value(json_keys::kReview).toObject());
 
         QString why;
         if (!tmp.isValid(&why)) {
@@ -9,6 +9,14 @@ inline constexpr const char* kName = "name";
 
 // Folder
 inline constexpr const char* kFolders = "folders";
+inline constexpr const char* kScoring = "scoring";
+
+// ReviewSettings (nested in a folder)
+inline constexpr const char* kIgnoreCase        = "ignoreCase";
+inline constexpr const char* kSimplifySpaces    = "simplifySpaces";
+inline constexpr const char* kIgnorePunctuation = "ignorePunctuation";
+inline constexpr const char* kMetric            = "metric";
+inline constexpr const char* kPassPercent       = "passPercent";
 
 // Card
 inline constexpr const char* kCards       = "cards";
@@ -17,6 +25,15 @@ inline constexpr const char* kQuestion    = "question";
 inline constexpr const char* kAnswer      = "answer";
 inline constexpr const char* kCreatedAtMs = "createdAtMs";
 inline constexpr const char* kUpdatedAtMs = "updatedAtMs";
+inline constexpr const char* kReview      = "review";
+
+// ReviewState (nested in a card)
+inline constexpr const char* kDueAtMs        = "dueAtMs";
+inline constexpr const char* kLastReviewAtMs = "lastReviewAtMs";
+inline constexpr const char* kIntervalDays   = "intervalDays";
+inline constexpr const char* kRepetitions    = "repetitions";
+inline constexpr const char* kLapses         = "lapses";
+inline constexpr const char* kEase           = "ease";
 
 } // namespace rewise::domain::json_keys
 
@@ -3,6 +3,7 @@
 
 #include "Id.h"
 #include "DomainJson.h"
+#include "ReviewSettings.h"
 
 #include <QString>
 #include <QJsonObject>
@@ -14,6 +15,7 @@ namespace rewise::domain {
 struct Folder final {
     Id id;
     QString name;
+    ReviewSettings scoring;
 
     bool isValid(QString* whyNot = nullptr) const {
         if (!id.isValid()) {
@@ -31,6 +33,7 @@ struct Folder final {
         QJsonObject o;
         o.insert(json_keys::kId, id.toString());
         o.insert(json_keys::kName, name);
+        if (!scoring.isDefault()) o.insert(json_keys::kScoring, scoring.toJson());
         return o;
     }
 
@@ -60,6 +63,7 @@ struct Folder final {
         Folder tmp;
         tmp.id = parsedId;
         tmp.name = nameV.toString();
+        tmp.scoring = ReviewSettings::fromJson(o.value(json_keys::kScoring).toObject());
 
         QString why;
         if (!tmp.isValid(&why)) {
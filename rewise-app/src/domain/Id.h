@@ -1,15 +1,21 @@
 #ifndef REWISE_DOMAIN_ID_H
 #define REWISE_DOMAIN_ID_H
 
+#include "UuidCodec.h"
+
 #include <QString>
+#include <QStringView>
 #include <QUuid>
 #include <QHashFunctions>
 
+#include <cstring>
+
 namespace rewise::domain {
 
 /// Strong-ish ID wrapper on top of QUuid.
-/// - String form: "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx" (WithoutBraces)
-/// - Parsing: QUuid(QString) accepts with/without braces; invalid -> null UUID.
+/// - String form: "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx" (WithoutBraces, lowercase)
+/// - Parsing: accepts with/without braces; invalid -> null UUID.
+/// - Ordering: binary on the 128-bit value (same order as the lowercase string form).
 struct Id final {
     QUuid value;
 
@@ -22,26 +28,45 @@ struct Id final {
     bool isValid() const { return !value.isNull(); }
 
     QString toString() const {
-        // WithoutBraces yields 36-char canonical UUID string.
-        return value.toString(QUuid::WithoutBraces);
+        return uuid_codec::format(value);
+    }
+
+    static Id fromString(QStringView s) {
+        // If parsing fails, the id is null.
+        return Id{uuid_codec::parse(s)};
+    }
+
+    static Id fromLatin1(const char* s, qsizetype n) {
+        return Id{uuid_codec::parseLatin1(s, n)};
     }
 
-    static Id fromString(const QString& s) {
-        // If conversion fails, QUuid becomes null.
-        return Id{QUuid{s}};
+    // <0, 0, >0 — big-endian field order, no allocation.
+    static int compare(const Id& a, const Id& b) noexcept {
+        const QUuid& x = a.value;
+        const QUuid& y = b.value;
+        if (x.data1 != y.data1) return (x.data1 < y.data1) ? -1 : 1;
+        if (x.data2 != y.data2) return (x.data2 < y.data2) ? -1 : 1;
+        if (x.data3 != y.data3) return (x.data3 < y.data3) ? -1 : 1;
+        return std::memcmp(x.data4, y.data4, sizeof(x.data4));
     }
 
     friend bool operator==(const Id& a, const Id& b) { return a.value == b.value; }
     friend bool operator!=(const Id& a, const Id& b) { return !(a == b); }
-    friend bool operator<(const Id& a, const Id& b)  { return a.toString() < b.toString(); }
+    friend bool operator<(const Id& a, const Id& b)  { return compare(a, b) < 0; }
 };
 
-} // namespace rewise::domain
-
 // Allow Id as a key in QHash/QSet.
-inline uint qHash(const rewise::domain::Id& id, uint seed = 0) noexcept {
-    // QUuid has qHash in Qt; if not, this still works because QUuid is hashable in Qt6.
+// Declared next to Id so QHash finds it via argument-dependent lookup.
+// Hashes the binary 128-bit value (no string conversion).
+inline uint qHash(const Id& id, uint seed = 0) noexcept {
     return qHash(id.value, seed);
 }
 
+// Same hash as a functor, for non-Qt containers (storage::PersistentHash).
+struct IdHash final {
+    uint operator()(const Id& id) const noexcept { return qHash(id); }
+};
+
+} // namespace rewise::domain
+
 #endif // REWISE_DOMAIN_ID_H
@@ -0,0 +1,61 @@
+#ifndef REWISE_DOMAIN_REVIEWSETTINGS_H
+#define REWISE_DOMAIN_REVIEWSETTINGS_H
+
+#include "DomainJson.h"
+
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QString>
+#include <QtGlobal>
+
+namespace rewise::domain {
+
+enum class ScoreMetric {
+    Characters = 0,   // edit distance over normalized characters
+    Words = 1         // edit distance over word tokens
+};
+
+/// How answers to the cards of a folder are scored (see review::ReviewEngine).
+/// Defaults are what every folder used before settings existed.
+struct ReviewSettings final {
+    bool ignoreCase = true;
+    bool simplifySpaces = true;
+    bool ignorePunctuation = true;
+    ScoreMetric metric = ScoreMetric::Characters;
+    int passPercent = 70;   // lowest similarity that counts as remembered, 1..100
+
+    bool isDefault() const { return *this == ReviewSettings{}; }
+
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(json_keys::kIgnoreCase, ignoreCase);
+        o.insert(json_keys::kSimplifySpaces, simplifySpaces);
+        o.insert(json_keys::kIgnorePunctuation, ignorePunctuation);
+        o.insert(json_keys::kMetric, metric == ScoreMetric::Words ? QStringLiteral("words") : QStringLiteral("chars"));
+        o.insert(json_keys::kPassPercent, passPercent);
+        return o;
+    }
+
+    // Lenient, like ReviewState: odd fields fall back to the defaults.
+    static ReviewSettings fromJson(const QJsonObject& o) {
+        ReviewSettings s;
+        s.ignoreCase = o.value(json_keys::kIgnoreCase).toBool(s.ignoreCase);
+        s.simplifySpaces = o.value(json_keys::kSimplifySpaces).toBool(s.simplifySpaces);
+        s.ignorePunctuation = o.value(json_keys::kIgnorePunctuation).toBool(s.ignorePunctuation);
+        s.metric = (o.value(json_keys::kMetric).toString() == QLatin1String("words")) ? ScoreMetric::Words
+                                                                                   : ScoreMetric::Characters;
+        s.passPercent = qBound(1, o.value(json_keys::kPassPercent).toInt(s.passPercent), 100);
+        return s;
+    }
+
+    friend bool operator==(const ReviewSettings& a, const ReviewSettings& b) {
+        return a.ignoreCase == b.ignoreCase && a.simplifySpaces == b.simplifySpaces
+               && a.ignorePunctuation == b.ignorePunctuation && a.metric == b.metric
+               && a.passPercent == b.passPercent;
+    }
+    friend bool operator!=(const ReviewSettings& a, const ReviewSettings& b) { return !(a == b); }
+};
+
+} // namespace rewise::domain
+
+#endif // REWISE_DOMAIN_REVIEWSETTINGS_H
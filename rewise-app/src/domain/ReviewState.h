@@ -0,0 +1,64 @@
+#ifndef REWISE_DOMAIN_REVIEWSTATE_H
+#define REWISE_DOMAIN_REVIEWSTATE_H
+
+#include "DomainJson.h"
+
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QtGlobal>
+
+namespace rewise::domain {
+
+/// Spaced-repetition state of one card (see review::Scheduler).
+/// A default-constructed state means "never reviewed".
+struct ReviewState final {
+    // UTC milliseconds since epoch; 0 while the card is new.
+    qint64 dueAtMsUtc = 0;
+    qint64 lastReviewAtMsUtc = 0;
+
+    int intervalDays = 0;   // 0 while (re)learning
+    int repetitions = 0;    // successful checks in a row
+    int lapses = 0;         // failed checks after the card had been learned
+    double ease = 2.5;      // SM-2 easiness factor, >= 1.3
+
+    bool isNew() const { return lastReviewAtMsUtc <= 0; }
+
+    // Due-queue key: new cards are due from their creation, in creation order.
+    qint64 dueKey(qint64 createdAtMsUtc) const { return isNew() ? createdAtMsUtc : dueAtMsUtc; }
+
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(json_keys::kDueAtMs, static_cast<double>(dueAtMsUtc));
+        o.insert(json_keys::kLastReviewAtMs, static_cast<double>(lastReviewAtMsUtc));
+        o.insert(json_keys::kIntervalDays, intervalDays);
+        o.insert(json_keys::kRepetitions, repetitions);
+        o.insert(json_keys::kLapses, lapses);
+        o.insert(json_keys::kEase, ease);
+        return o;
+    }
+
+    // Lenient: missing or malformed fields keep their defaults, so an odd
+    // record only costs the card its schedule, never the card itself.
+    static ReviewState fromJson(const QJsonObject& o) {
+        ReviewState s;
+        s.dueAtMsUtc = static_cast<qint64>(o.value(json_keys::kDueAtMs).toDouble(0));
+        s.lastReviewAtMsUtc = static_cast<qint64>(o.value(json_keys::kLastReviewAtMs).toDouble(0));
+        s.intervalDays = qMax(0, o.value(json_keys::kIntervalDays).toInt(0));
+        s.repetitions = qMax(0, o.value(json_keys::kRepetitions).toInt(0));
+        s.lapses = qMax(0, o.value(json_keys::kLapses).toInt(0));
+        s.ease = qMax(1.3, o.value(json_keys::kEase).toDouble(2.5));
+        if (s.isNew()) s = ReviewState{};
+        return s;
+    }
+
+    friend bool operator==(const ReviewState& a, const ReviewState& b) {
+        return a.dueAtMsUtc == b.dueAtMsUtc && a.lastReviewAtMsUtc == b.lastReviewAtMsUtc
+               && a.intervalDays == b.intervalDays && a.repetitions == b.repetitions
+               && a.lapses == b.lapses && a.ease == b.ease;
+    }
+    friend bool operator!=(const ReviewState& a, const ReviewState& b) { return !(a == b); }
+};
+
+} // namespace rewise::domain
+
+#endif // REWISE_DOMAIN_REVIEWSTATE_H
@@ -0,0 +1,229 @@
+#ifndef REWISE_DOMAIN_UUIDCODEC_H
+#define REWISE_DOMAIN_UUIDCODEC_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QStringView>
+#include <QUuid>
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QByteArrayView>
+#endif
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define REWISE_UUID_CODEC_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace rewise::domain::uuid_codec {
+
+// Text codec for the canonical 36-char UUID form "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx"
+// (optionally wrapped in braces on input). Works directly on string views:
+// no QString temporaries, no per-digit branches. Output is lowercase, like
+// QUuid::toString(QUuid::WithoutBraces).
+
+inline constexpr int kTextLength = 36;
+
+namespace detail {
+
+// Hex digit value, or 0x80 for anything that is not [0-9a-fA-F].
+struct HexTable final {
+    std::uint8_t v[256];
+
+    constexpr HexTable() : v{} {
+        for (int i = 0; i < 256; ++i) v[i] = 0x80;
+        for (int i = 0; i < 10; ++i) v['0' + i] = static_cast<std::uint8_t>(i);
+        for (int i = 0; i < 6; ++i) {
+            v['a' + i] = static_cast<std::uint8_t>(10 + i);
+            v['A' + i] = static_cast<std::uint8_t>(10 + i);
+        }
+    }
+};
+
+inline constexpr HexTable kHex{};
+inline constexpr char kDigits[] = "0123456789abcdef";
+
+// Dash positions and hex groups of the canonical form.
+inline constexpr int kDashPos[4]    = {8, 13, 18, 23};
+inline constexpr int kGroupStart[5] = {0, 9, 14, 19, 24};
+inline constexpr int kGroupLen[5]   = {8, 4, 4, 4, 12};
+
+template <typename Ch>
+inline unsigned unit(Ch c) {
+    return static_cast<unsigned>(static_cast<std::make_unsigned_t<Ch>>(c));
+}
+
+// 32 hex code units -> 16 bytes. Any code unit above 0xFF maps to "invalid".
+template <typename Ch>
+inline bool decodeHex32Scalar(const Ch* hex, std::uint8_t out[16]) {
+    unsigned bad = 0;
+    for (int i = 0; i < 16; ++i) {
+        const unsigned c0 = unit(hex[2 * i]);
+        const unsigned c1 = unit(hex[2 * i + 1]);
+        const unsigned n0 = kHex.v[c0 & 0xFF] | ((0u - unsigned(c0 > 0xFF)) & 0x80);
+        const unsigned n1 = kHex.v[c1 & 0xFF] | ((0u - unsigned(c1 > 0xFF)) & 0x80);
+        bad |= n0 | n1;
+        out[i] = static_cast<std::uint8_t>((n0 << 4) | (n1 & 0x0F));
+    }
+    return (bad & 0x80) == 0;
+}
+
+#ifdef REWISE_UUID_CODEC_SSE2
+// 16 ASCII hex chars -> 8 bytes in the low half of each 16-bit lane; sets *ok=false on bad input.
+inline __m128i decodeHex16Sse2(__m128i x, bool* ok) {
+    const __m128i bias = _mm_set1_epi8(static_cast<char>(0x80));
+
+    // Unsigned "d < 10" / "l < 6" via signed compare on bias-flipped values.
+    const __m128i d = _mm_sub_epi8(x, _mm_set1_epi8('0'));
+    const __m128i isDigit = _mm_cmplt_epi8(_mm_xor_si128(d, bias), _mm_set1_epi8(static_cast<char>(10 ^ 0x80)));
+
+    const __m128i l = _mm_sub_epi8(_mm_or_si128(x, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    const __m128i isAlpha = _mm_cmplt_epi8(_mm_xor_si128(l, bias), _mm_set1_epi8(static_cast<char>(6 ^ 0x80)));
+
+    if (_mm_movemask_epi8(_mm_or_si128(isDigit, isAlpha)) != 0xFFFF) *ok = false;
+
+    const __m128i nib = _mm_or_si128(_mm_and_si128(isDigit, d),
+                                     _mm_and_si128(isAlpha, _mm_add_epi8(l, _mm_set1_epi8(10))));
+
+    // Lane = hi | (lo << 8)  ->  (hi << 4) | lo in the low byte.
+    const __m128i hi = _mm_and_si128(_mm_slli_epi16(nib, 4), _mm_set1_epi16(0x00F0));
+    const __m128i lo = _mm_srli_epi16(nib, 8);
+    return _mm_or_si128(hi, lo);
+}
+
+inline bool decodeHex32Sse2(const char* hex, std::uint8_t out[16]) {
+    bool ok = true;
+    const __m128i a = decodeHex16Sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex)), &ok);
+    const __m128i b = decodeHex16Sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + 16)), &ok);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(a, b));
+    return ok;
+}
+
+inline bool decodeHex32Sse2(const char16_t* hex, std::uint8_t out[16]) {
+    // Narrow UTF-16 to bytes; packus saturates non-Latin1 units to 0x00/0xFF,
+    // neither of which is a hex digit, so validation still catches them.
+    alignas(16) char narrow[32];
+    const __m128i w0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hex));
+    const __m128i w1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + 8));
+    const __m128i w2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + 16));
+    const __m128i w3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + 24));
+    _mm_store_si128(reinterpret_cast<__m128i*>(narrow), _mm_packus_epi16(w0, w1));
+    _mm_store_si128(reinterpret_cast<__m128i*>(narrow + 16), _mm_packus_epi16(w2, w3));
+    return decodeHex32Sse2(narrow, out);
+}
+#endif
+
+template <typename Ch>
+inline bool decodeHex32(const Ch* hex, std::uint8_t out[16]) {
+#ifdef REWISE_UUID_CODEC_SSE2
+    if constexpr (sizeof(Ch) == 1) {
+        return decodeHex32Sse2(reinterpret_cast<const char*>(hex), out);
+    } else if constexpr (sizeof(Ch) == 2) {
+        return decodeHex32Sse2(reinterpret_cast<const char16_t*>(hex), out);
+    }
+#endif
+    return decodeHex32Scalar(hex, out);
+}
+
+// Canonical text (36 units, or 38 with braces) -> 16 big-endian bytes.
+template <typename Ch>
+inline bool parseBytes(const Ch* s, qsizetype n, std::uint8_t out[16]) {
+    if (n == kTextLength + 2) {
+        if (unit(s[0]) != '{' || unit(s[n - 1]) != '}') return false;
+        ++s;
+        n -= 2;
+    }
+    if (n != kTextLength) return false;
+
+    unsigned dashes = 0;
+    for (int p : kDashPos) dashes |= unit(s[p]) ^ unsigned('-');
+
+    // Gather the 32 hex digits contiguously (fixed-size copies, no branching on content).
+    Ch hex[32];
+    Ch* dst = hex;
+    for (int g = 0; g < 5; ++g) {
+        std::memcpy(dst, s + kGroupStart[g], sizeof(Ch) * kGroupLen[g]);
+        dst += kGroupLen[g];
+    }
+
+    const bool digitsOk = decodeHex32(hex, out);
+    return digitsOk && dashes == 0;
+}
+
+// 16 big-endian bytes -> 36 units of canonical lowercase text.
+template <typename Ch>
+inline void formatBytes(const std::uint8_t in[16], Ch* out) {
+    int byte = 0;
+    int pos = 0;
+    for (int g = 0; g < 5; ++g) {
+        if (g > 0) out[pos++] = Ch('-');
+        for (int k = 0; k < kGroupLen[g] / 2; ++k, ++byte) {
+            out[pos++] = Ch(kDigits[in[byte] >> 4]);
+            out[pos++] = Ch(kDigits[in[byte] & 0x0F]);
+        }
+    }
+}
+
+inline void toBytes(const QUuid& u, std::uint8_t out[16]) {
+    out[0] = static_cast<std::uint8_t>(u.data1 >> 24);
+    out[1] = static_cast<std::uint8_t>(u.data1 >> 16);
+    out[2] = static_cast<std::uint8_t>(u.data1 >> 8);
+    out[3] = static_cast<std::uint8_t>(u.data1);
+    out[4] = static_cast<std::uint8_t>(u.data2 >> 8);
+    out[5] = static_cast<std::uint8_t>(u.data2);
+    out[6] = static_cast<std::uint8_t>(u.data3 >> 8);
+    out[7] = static_cast<std::uint8_t>(u.data3);
+    std::memcpy(out + 8, u.data4, 8);
+}
+
+inline QUuid fromBytes(const std::uint8_t b[16]) {
+    const uint l = (uint(b[0]) << 24) | (uint(b[1]) << 16) | (uint(b[2]) << 8) | uint(b[3]);
+    const ushort w1 = static_cast<ushort>((b[4] << 8) | b[5]);
+    const ushort w2 = static_cast<ushort>((b[6] << 8) | b[7]);
+    return QUuid(l, w1, w2, b[8], b[9], b[10], b[11], b[12], b[13], b[14], b[15]);
+}
+
+} // namespace detail
+
+// Parsing: null QUuid on malformed input (same contract as QUuid(QString)).
+inline QUuid parse(QStringView s) {
+    std::uint8_t bytes[16];
+    if (!detail::parseBytes(s.utf16(), s.size(), bytes)) return QUuid{};
+    return detail::fromBytes(bytes);
+}
+
+inline QUuid parseLatin1(const char* s, qsizetype n) {
+    std::uint8_t bytes[16];
+    if (!s || !detail::parseBytes(s, n, bytes)) return QUuid{};
+    return detail::fromBytes(bytes);
+}
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+inline QUuid parse(QByteArrayView s) {
+    return parseLatin1(s.data(), s.size());
+}
+#endif
+
+inline QString format(const QUuid& u) {
+    std::uint8_t bytes[16];
+    detail::toBytes(u, bytes);
+
+    QString s(kTextLength, Qt::Uninitialized);
+    detail::formatBytes(bytes, reinterpret_cast<char16_t*>(s.data()));
+    return s;
+}
+
+// Writes exactly 36 chars (no terminator).
+inline void formatLatin1(const QUuid& u, char* out) {
+    std::uint8_t bytes[16];
+    detail::toBytes(u, bytes);
+    detail::formatBytes(bytes, out);
+}
+
+} // namespace rewise::domain::uuid_codec
+
+#endif // REWISE_DOMAIN_UUIDCODEC_H
@@ -1,16 +1,81 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 
+#include "review/Scheduler.h"
+#include "storage/Repository.h"
+#include "storage/SqliteRepository.h"
 #include "ui/pages/LibraryPage.h"
 #include "ui/pages/ReviewPage.h"
+#include "ui/pages/StatsPage.h"
 
+#include <QDir>
+#include <QHash>
 #include <QMessageBox>
+#include <QRandomGenerator>
+#include <QSettings>
+#include <QSet>
+#include <QShortcut>
 #include <QStackedWidget>
+#include <QStringList>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// "storage/backend": "json" (default) or "sqlite" (imports the JSON DB on first start).
+// "storage/layout":  JSON only — "sharded" (default) or "single". Switching migrates on next start.
+// "storage/lazyBodies": SQLite only — long card text stays in the store; memory holds previews.
+//                       The JSON files are read whole: there the setting is ignored, with a notice.
+static constexpr int kMaxUndo = 100;
+
+namespace {
+
+// One folder's due cards as a review stream (merged by review::DueOrder).
+class DueStream final : public rewise::review::CardStream {
+public:
+    explicit DueStream(rewise::storage::Database::DueCursor cursor)
+        : m_cursor(std::move(cursor))
+    {}
+
+    bool atEnd() const override { return m_cursor.atEnd(); }
+    qint64 key() const override { return m_cursor.key(); }
+    int card() const override { return m_cursor.card(); }
+    void advance() override { m_cursor.advance(); }
+
+private:
+    rewise::storage::Database::DueCursor m_cursor;
+};
+
+} // namespace
+
+static std::unique_ptr<rewise::storage::StorageBackend> createStorageBackend() {
+    const QSettings settings;
+    if (settings.value("storage/backend", "json").toString() == "sqlite") {
+        auto repo = std::make_unique<rewise::storage::SqliteRepository>("rewise.sqlite");
+        repo->setLazyBodies(settings.value("storage/lazyBodies", false).toBool());
+        return repo;
+    }
+
+    const QString layout = settings.value("storage/layout", "sharded").toString();
+    return std::make_unique<rewise::storage::Repository>(
+        "db.json",
+        (layout == "single") ? rewise::storage::Repository::Layout::SingleFile
+                             : rewise::storage::Repository::Layout::Sharded);
+}
+
+// "storage/lazyBodies" is on, but the JSON backend is in use.
+static bool lazyBodiesIgnored() {
+    const QSettings settings;
+    return settings.value("storage/lazyBodies", false).toBool()
+           && settings.value("storage/backend", "json").toString() != "sqlite";
+}
 
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
-    , m_repo("db.json")
+    , m_repo(createStorageBackend())
 {
     ui->setupUi(this);
     setWindowTitle("Rewise");
@@ -20,9 +85,11 @@ MainWindow::MainWindow(QWidget* parent)
 
     m_library = new rewise::ui::pages::LibraryPage(this);
     m_review = new rewise::ui::pages::ReviewPage(this);
+    m_stats = new rewise::ui::pages::StatsPage(this);
 
     m_stack->addWidget(m_library);
     m_stack->addWidget(m_review);
+    m_stack->addWidget(m_stats);
     m_stack->setCurrentWidget(m_library);
 
     // Autosave debounce
@@ -30,26 +97,68 @@ MainWindow::MainWindow(QWidget* parent)
     m_autosave.setInterval(250);
     connect(&m_autosave, &QTimer::timeout, this, &MainWindow::saveNow);
 
+    m_dayTimer.setSingleShot(true);
+    connect(&m_dayTimer, &QTimer::timeout, this, [this] {
+        refreshDueHorizon();
+        publish({}); // only the due counts changed
+    });
+
     // Wire library signals
     connect(m_library, &rewise::ui::pages::LibraryPage::folderCreateRequested, this, &MainWindow::onFolderCreate);
     connect(m_library, &rewise::ui::pages::LibraryPage::folderRenameRequested, this, &MainWindow::onFolderRename);
     connect(m_library, &rewise::ui::pages::LibraryPage::folderDeleteRequested, this, &MainWindow::onFolderDelete);
+    connect(m_library, &rewise::ui::pages::LibraryPage::folderScoringRequested, this, &MainWindow::onFolderScoring);
 
     connect(m_library, &rewise::ui::pages::LibraryPage::cardCreateRequested, this, &MainWindow::onCardCreate);
     connect(m_library, &rewise::ui::pages::LibraryPage::cardUpdateRequested, this, &MainWindow::onCardUpdate);
     connect(m_library, &rewise::ui::pages::LibraryPage::cardDeleteRequested, this, &MainWindow::onCardDelete);
 
     connect(m_library, &rewise::ui::pages::LibraryPage::startReviewRequested, this, &MainWindow::onStartReview);
+    connect(m_library, &rewise::ui::pages::LibraryPage::resumeReviewRequested, this, &MainWindow::onResumeReview);
+    connect(m_library, &rewise::ui::pages::LibraryPage::startExamRequested, this, &MainWindow::onStartExam);
+    connect(m_library, &rewise::ui::pages::LibraryPage::statsRequested, this, &MainWindow::onShowStats);
+    connect(m_library, &rewise::ui::pages::LibraryPage::checkDatabaseRequested, this, &MainWindow::onCheckDatabase);
 
     connect(m_review, &rewise::ui::pages::ReviewPage::exitRequested, this, [this] {
         m_stack->setCurrentWidget(m_library);
     });
+    connect(m_review, &rewise::ui::pages::ReviewPage::cardChecked, this, &MainWindow::onCardChecked);
+    connect(m_review, &rewise::ui::pages::ReviewPage::examGraded, this, &MainWindow::onExamGraded);
+    connect(m_review, &rewise::ui::pages::ReviewPage::sessionFinished, this, [this] {
+        if (m_session) m_session->remove();
+        refreshResumeOffer();
+    });
+    connect(m_stats, &rewise::ui::pages::StatsPage::exitRequested, this, [this] {
+        m_stack->setCurrentWidget(m_library);
+    });
+
+    // Published versions reach the pages through the change bus.
+    connect(&m_bus, &rewise::storage::ChangeBus::changed, m_library, &rewise::ui::pages::LibraryPage::applyChanges);
+
+    // Undo/redo of library edits. Text fields keep their own Ctrl+Z while focused.
+    connect(new QShortcut(QKeySequence::Undo, this), &QShortcut::activated, this, &MainWindow::undo);
+    connect(new QShortcut(QKeySequence::Redo, this), &QShortcut::activated, this, &MainWindow::redo);
+
+    // History writes are batched: checks within the interval go out in one write.
+    m_historyFlush.setSingleShot(true);
+    m_historyFlush.setInterval(2000);
+    connect(&m_historyFlush, &QTimer::timeout, this, &MainWindow::flushHistoryAsync);
+    connect(&m_historyWriter, &QFutureWatcher<QString>::finished, this, [this] {
+        const QString err = m_historyWriter.result();
+        if (!err.isEmpty()) m_library->showError("Не удалось записать историю повторений: " + err);
+    });
 
     loadDb();
+    refreshDueHorizon();
     applyAndRefresh();
+    openHistory();
+    if (lazyBodiesIgnored()) {
+        m_library->showInfo("Ленивая загрузка текста карточек (storage/lazyBodies) работает только с хранилищем "
+                            "SQLite (storage/backend = sqlite). Сейчас весь текст загружен в память.");
+    }
 
 #ifndef QT_NO_DEBUG
-    statusBar()->showMessage("DB: " + m_repo.databaseFilePath());
+    statusBar()->showMessage("DB: " + m_repo->storagePath());
 #else
     statusBar()->hide();
 #endif
@@ -57,6 +166,8 @@ MainWindow::MainWindow(QWidget* parent)
 
 MainWindow::~MainWindow() {
     // Попытка сохранить перед выходом (best-effort)
+    m_historyWriter.waitForFinished();
+    if (m_history) m_history->flush();
     saveNow();
     delete ui;
 }
@@ -64,30 +175,87 @@ MainWindow::~MainWindow() {
 void MainWindow::loadDb() {
     QString err;
     rewise::storage::Database db;
-    if (!m_repo.load(&db, &err)) {
+    if (!m_repo->load(&db, &err)) {
         QMessageBox::warning(this, "Rewise",
                              "Не удалось загрузить базу.\n\n" + err + "\n\nБудет создана новая база.");
-        db.folders.clear();
-        db.cards.clear();
+        db = rewise::storage::Database{};
         db.ensureDefaultFolder();
     }
+
     m_db = std::move(db);
 }
 
 void MainWindow::applyAndRefresh(const QString& successInfo) {
-    // self-heal names
-    m_db.ensureUniqueFolderNames();
-
-    QString why;
-    if (!m_db.validate(&why)) {
-        m_library->showError("DB invalid: " + why);
-    } else if (!successInfo.isEmpty()) {
+    // Invariants are checked per mutation (Database::checkFolder/checkCard);
+    // the full validator only runs on load and on explicit request.
+    if (!successInfo.isEmpty()) {
         m_library->showInfo(successInfo);
     } else {
         m_library->clearMessage();
     }
 
-    m_library->setDatabase(m_db);
+    rewise::storage::ChangeEvents events = m_db.takeChangeEvents();
+    bool dropped = !m_redo.isEmpty();
+    if (m_published) {
+        m_undo.push_back({m_published, m_publishedGeneration});
+        if (m_undo.size() > kMaxUndo) {
+            m_undo.removeFirst();
+            dropped = true;
+        }
+    } else {
+        events = {rewise::storage::ChangeEvent{}}; // first publish: Reset
+    }
+    m_redo.clear();
+
+    publish(events);
+    if (dropped) releaseBodies();
+    scheduleSave();
+}
+
+void MainWindow::publish(const rewise::storage::ChangeEvents& events) {
+    // A left review session holds card indices: they shift when cards come or go.
+    using Kind = rewise::storage::ChangeEvent::Kind;
+    for (const auto& e : events) {
+        if (e.kind == Kind::Reset || e.kind == Kind::CardInserted || e.kind == Kind::CardRemoved
+            || e.kind == Kind::FolderRemoved) {
+            if (m_review) m_review->dropLeftSession();
+            break;
+        }
+    }
+
+    m_published = rewise::storage::makeSnapshot(m_db);
+    m_publishedGeneration = m_dbGeneration;
+    emit m_bus.changed(m_published, events);
+}
+
+void MainWindow::undo() {
+    if (m_stack->currentWidget() != m_library || m_undo.isEmpty()) return;
+    m_redo.push_back({m_published, m_publishedGeneration});
+    restoreVersion(m_undo.takeLast());
+    m_library->showInfo("Действие отменено.");
+}
+
+void MainWindow::redo() {
+    if (m_stack->currentWidget() != m_library || m_redo.isEmpty()) return;
+    m_undo.push_back({m_published, m_publishedGeneration});
+    restoreVersion(m_redo.takeLast());
+    m_library->showInfo("Действие повторено.");
+}
+
+void MainWindow::restoreVersion(const Version& version) {
+    rewise::storage::Database restored = *version.db;
+    // Undo/redo edits, not review progress.
+    restored.adoptReviewStates(m_db);
+    restored.setDueHorizon(m_db.dueHorizon());
+    // Save exactly what differs from the store: unsaved work + the diff to the old version.
+    restored.inheritPendingChanges(m_db);
+    m_db = std::move(restored);
+    m_db.takeChangeEvents();
+    // Until the next save writes its lazy cards' text back, it reads what its
+    // own generation could.
+    m_dbGeneration = version.bodyGeneration;
+
+    publish({rewise::storage::ChangeEvent{}}); // Reset
     scheduleSave();
 }
 
@@ -96,33 +264,106 @@ void MainWindow::scheduleSave() {
 }
 
 void MainWindow::saveNow() {
-    if (!m_db.validate()) return;
     QString err;
-    if (!m_repo.save(m_db, &err)) {
+    if (m_rollups && !m_rollups->save(&err)) {
+        if (m_library) m_library->showError("Не удалось сохранить статистику: " + err);
+        err.clear();
+    }
+    if (!m_repo->save(m_db, &err)) {
         // Только сообщение: не рушим работу пользователя.
         if (m_library) m_library->showError("Не удалось сохранить базу: " + err);
+        return;
     }
+    m_db.clearPendingChanges();
+    // The rows now hold what the lazy cards of m_db refer to.
+    if (const auto bodies = m_db.bodyStore()) m_dbGeneration = bodies->saveGeneration();
+}
+
+void MainWindow::releaseBodies() {
+    const auto bodies = m_db.bodyStore();
+    if (!bodies) return;
+    // Pages and workers only hold recent versions; an older one a left review
+    // session still holds falls back to the row's current text.
+    quint64 oldest = qMin(m_dbGeneration, m_publishedGeneration);
+    for (const Version& v : qAsConst(m_undo)) oldest = qMin(oldest, v.bodyGeneration);
+    for (const Version& v : qAsConst(m_redo)) oldest = qMin(oldest, v.bodyGeneration);
+    bodies->releaseBefore(oldest);
+}
+
+void MainWindow::refreshDueHorizon() {
+    const qint64 now = rewise::domain::Card::nowUtcMs();
+    const qint64 endOfDay = rewise::review::Scheduler::endOfLocalDayMsUtc(now);
+    m_db.setDueHorizon(endOfDay);
+    m_dayTimer.start(static_cast<int>(std::min<qint64>(endOfDay - now + 1000, std::numeric_limits<int>::max())));
+}
+
+void MainWindow::openHistory() {
+    const QDir dir(rewise::storage::StorageBackend::databaseDirPath());
+    QString err;
+
+    auto rollups = std::make_unique<rewise::storage::ReviewRollups>(dir.filePath("stats.dat"));
+    if (rollups->load(&err)) {
+        m_rollups = std::move(rollups);
+    } else {
+        m_library->showError("Статистика недоступна: " + err);
+    }
+
+    m_session = std::make_unique<rewise::storage::ReviewSessionFile>(dir.filePath("session.dat"));
+    refreshResumeOffer();
+
+    auto history = std::make_shared<rewise::storage::ReviewLog>(dir.filePath("history.dat"));
+    if (!history->open(&err)) {
+        m_library->showError("История повторений недоступна: " + err);
+        return;
+    }
+    m_history = std::move(history);
+}
+
+void MainWindow::flushHistoryAsync() {
+    if (!m_history || !m_history->hasPending()) return;
+    if (m_historyWriter.isRunning()) {
+        m_historyFlush.start(); // after the write in flight
+        return;
+    }
+
+    auto history = m_history;
+    m_historyWriter.setFuture(QtConcurrent::run([history] {
+        QString err;
+        return history->flush(&err) ? QString() : err;
+    }));
 }
 
 void MainWindow::onFolderCreate(const QString& name) {
     rewise::domain::Folder f;
     f.id = rewise::domain::Id::create();
-    f.name = name.trimmed();
-    if (!f.isValid()) {
+    f.name = m_db.uniqueFolderName(name);
+    if (!m_db.checkFolder(f)) {
         m_library->showError("Некорректное имя папки.");
         return;
     }
-    m_db.folders.push_back(f);
+    m_db.addFolder(f);
     applyAndRefresh("Папка создана.");
 }
 
 void MainWindow::onFolderRename(const rewise::domain::Id& id, const QString& newName) {
-    auto* f = m_db.folderById(id);
+    const auto* f = m_db.folderById(id);
     if (!f) return;
-    f->name = newName.trimmed();
+
+    rewise::domain::Folder renamed = *f;
+    renamed.name = m_db.uniqueFolderName(newName, id);
+    if (!m_db.checkFolder(renamed)) {
+        m_library->showError("Некорректное имя папки.");
+        return;
+    }
+    m_db.renameFolder(id, renamed.name);
     applyAndRefresh("Папка переименована.");
 }
 
+void MainWindow::onFolderScoring(const rewise::domain::Id& id, const rewise::domain::ReviewSettings& scoring) {
+    if (!m_db.setFolderScoring(id, scoring)) return;
+    applyAndRefresh("Настройки проверки сохранены.");
+}
+
 void MainWindow::onFolderDelete(const rewise::domain::Id& id) {
     // Перенос карточек в Default
     const auto defaultId = m_db.ensureDefaultFolder();
@@ -131,17 +372,13 @@ void MainWindow::onFolderDelete(const rewise::domain::Id& id) {
         return;
     }
 
-    for (auto& c : m_db.cards) {
-        if (c.folderId == id) {
-            c.folderId = defaultId;
-            c.touchUpdatedNow();
-        }
+    const QVector<int> inFolder = m_db.cardIndicesInFolder(id);
+    for (int idx : inFolder) {
+        m_db.cards.mutableAt(idx).touchUpdatedNow();
+        m_db.moveCard(m_db.cards[idx].id, defaultId);
     }
 
-    const int idx = m_db.folderIndexById(id);
-    if (idx >= 0 && idx < m_db.folders.size()) {
-        m_db.folders.removeAt(idx);
-    }
+    m_db.removeFolder(id);
     applyAndRefresh("Папка удалена, карточки перенесены в Default.");
 }
 
@@ -157,52 +394,360 @@ void MainWindow::onCardCreate(const rewise::domain::Id& folderId, const QString&
     c.touchCreatedNow();
 
     QString why;
-    if (!c.isValid(&why)) {
+    if (!m_db.checkCard(c, &why)) {
         m_library->showError("Карточка невалидна: " + why);
         return;
     }
 
-    m_db.cards.push_back(c);
+    m_db.addCard(c);
     applyAndRefresh("Карточка создана.");
 }
 
 void MainWindow::onCardUpdate(const rewise::domain::Id& cardId, const QString& q, const QString& a) {
-    auto* c = m_db.cardById(cardId);
+    const auto* c = m_db.cardById(cardId);
     if (!c) return;
-    c->question = q.trimmed();
-    c->answer = a.trimmed();
-    c->touchUpdatedNow();
+
+    rewise::domain::Card updated = *c;
+    updated.setText(q.trimmed(), a.trimmed());
+    updated.touchUpdatedNow();
+
+    QString why;
+    if (!m_db.checkCard(updated, &why)) {
+        m_library->showError("Карточка невалидна: " + why);
+        return;
+    }
+
+    m_db.updateCard(updated);
     applyAndRefresh("Карточка обновлена.");
 }
 
 void MainWindow::onCardDelete(const rewise::domain::Id& cardId) {
-    const int idx = m_db.cardIndexById(cardId);
-    if (idx < 0 || idx >= m_db.cards.size()) return;
-    m_db.cards.removeAt(idx);
+    if (!m_db.removeCard(cardId)) return;
     applyAndRefresh("Карточка удалена.");
 }
 
-void MainWindow::onStartReview(const rewise::domain::Id& folderId) {
-    QVector<rewise::domain::Card> cards;
-    cards.reserve(m_db.cards.size());
+void MainWindow::onCheckDatabase() {
+    QString why;
+    if (!m_db.validate(&why)) {
+        m_library->showError("База повреждена: " + why);
+        return;
+    }
+    m_library->showInfo(QString("База в порядке: папок %1, карточек %2.")
+                            .arg(m_db.folders.size())
+                            .arg(m_db.cards.size()));
+}
 
-    QString title = "Все карточки";
-    if (folderId.isValid()) {
-        const auto* f = m_db.folderById(folderId);
-        title = f ? f->name : "Папка";
+void MainWindow::onStartReview(const QVector<rewise::domain::Id>& selectedFolderIds,
+                               rewise::review::SessionOrder sessionOrder) {
+    using rewise::review::SessionOrder;
+
+    rewise::storage::SessionHeader header;
+    header.order = static_cast<quint8>(sessionOrder);
+    header.startedAtMsUtc = rewise::domain::Card::nowUtcMs();
+
+    QVector<rewise::domain::Id> folderIds;
+    QStringList names;
+    for (const auto& id : selectedFolderIds) {
+        const auto* f = m_db.folderById(id);
+        if (!f) continue;
+        folderIds.push_back(id);
+        names.push_back(f->name);
+    }
+    header.folderIds = folderIds;
+    header.title = names.join(", ");
+    if (selectedFolderIds.isEmpty()) {
+        for (const auto& f : m_db.folders) folderIds.push_back(f.id);
+        header.title = "Все карточки";
     }
 
-    for (const auto& c : m_db.cards) {
-        if (!folderId.isValid() || c.folderId == folderId) {
-            cards.push_back(c);
+    switch (sessionOrder) {
+    case SessionOrder::Due: {
+        // With nothing due, practise ahead: the whole selection in due order.
+        refreshDueHorizon();
+        int due = 0;
+        for (const auto& id : folderIds) due += m_db.dueCountInFolder(id);
+        if (due == 0) {
+            header.horizonMsUtc = std::numeric_limits<qint64>::max();
+            header.title += " (досрочно)";
         }
+        break;
+    }
+    case SessionOrder::Shuffled:
+        header.title += " (вперемешку)";
+        break;
+    case SessionOrder::Weighted:
+        header.title += " (сначала трудные)";
+        break;
+    }
+
+    auto order = buildSessionOrder(&header, {});
+    if (!order) {
+        m_library->showError(folderIds.size() > 1 ? "В выбранных папках нет карточек." : "В выбранной папке нет карточек.");
+        return;
+    }
+
+    QString err;
+    if (m_session && !m_session->begin(header, &err)) {
+        m_library->showError("Сессию не удастся продолжить после выхода: " + err);
     }
+    refreshResumeOffer();
 
-    if (cards.isEmpty()) {
+    // The session reads cards by index from its own snapshot: no per-card copies.
+    m_review->startSession(rewise::storage::makeSnapshot(m_db), std::move(order), header.title);
+    m_stack->setCurrentWidget(m_review);
+}
+
+void MainWindow::onStartExam(const QVector<rewise::domain::Id>& selectedFolderIds, int cardCount, int timeLimitMinutes) {
+    QVector<int> cards;
+    QStringList names;
+    for (const auto& id : selectedFolderIds) {
+        const auto* f = m_db.folderById(id);
+        if (!f) continue;
+        cards += m_db.cardIndicesInFolder(id);
+        names.push_back(f->name);
+    }
+    if (selectedFolderIds.isEmpty()) {
+        cards.resize(m_db.cards.size());
+        for (int i = 0; i < cards.size(); ++i) cards[i] = i;
+        names = QStringList{"Все карточки"};
+    }
+    if (cards.isEmpty() || cardCount <= 0) {
         m_library->showError("В выбранной папке нет карточек.");
         return;
     }
 
-    m_review->startSession(std::move(cards), title);
+    // Partial Fisher–Yates: a random sample of cardCount cards in random order.
+    const int n = qMin(cardCount, cards.size());
+    auto* rng = QRandomGenerator::global();
+    for (int i = 0; i < n; ++i) std::swap(cards[i], cards[i + rng->bounded(cards.size() - i)]);
+    cards.resize(n);
+
+    m_review->startExam(rewise::storage::makeSnapshot(m_db),
+                        std::make_unique<rewise::review::ListOrder>(std::move(cards)),
+                        names.join(", "),
+                        qint64(timeLimitMinutes) * 60 * 1000);
     m_stack->setCurrentWidget(m_review);
 }
+
+void MainWindow::onResumeReview() {
+    rewise::storage::SessionHeader header;
+    QVector<rewise::storage::SessionCheck> checks;
+    QString err;
+    if (!m_session || !m_session->load(&header, &checks, &err)) {
+        m_library->showError(err.isEmpty() ? "Прерванного повторения нет." : "Не удалось продолжить повторение: " + err);
+        refreshResumeOffer();
+        return;
+    }
+
+    // A shuffled or weighted session left in this run goes on as it was; after
+    // a restart it is set up again from the card list and seed in its file.
+    if (static_cast<rewise::review::SessionOrder>(header.order) == rewise::review::SessionOrder::Due) {
+        m_review->dropLeftSession(); // due sessions pick up what became due since
+    } else if (m_review->resumeLeftSession(rewise::storage::makeSnapshot(m_db))) {
+        m_stack->setCurrentWidget(m_review);
+        return;
+    }
+
+    auto order = buildSessionOrder(&header, checks);
+    if (!order || order->remaining() == 0) {
+        m_session->remove();
+        refreshResumeOffer();
+        m_library->showInfo("Прерванное повторение уже пройдено.");
+        return;
+    }
+
+    m_review->startSession(rewise::storage::makeSnapshot(m_db), std::move(order), header.title);
+    m_stack->setCurrentWidget(m_review);
+}
+
+std::unique_ptr<rewise::review::CardOrder> MainWindow::buildSessionOrder(
+    rewise::storage::SessionHeader* header, const QVector<rewise::storage::SessionCheck>& checks) {
+    using rewise::review::SessionOrder;
+
+    QVector<rewise::domain::Id> folderIds;
+    for (const auto& id : header->folderIds) {
+        if (m_db.folderById(id)) folderIds.push_back(id);
+    }
+    const bool allFolders = header->folderIds.isEmpty();
+    if (allFolders) {
+        for (const auto& f : m_db.folders) folderIds.push_back(f.id);
+    } else if (folderIds.isEmpty()) {
+        return nullptr;
+    }
+
+    // Checks so far (resume): O(checks) id lookups, no pass over the cards.
+    QSet<int> asked;
+    QHash<int, int> lastPercent;          // card -> percent of its latest check
+    QHash<int, bool> lastPassed;
+    QVector<int> failedInOrder;           // cards whose latest check failed, by that check
+    int lastRound = 0;
+    for (const auto& c : checks) lastRound = qMax<int>(lastRound, c.round);
+    QSet<int> dealtThisRound;
+    int lastDealt = -1;                   // card of the latest check in that round
+    for (const auto& c : checks) {
+        const int idx = m_db.cardIndexById(c.cardId);
+        if (idx < 0) continue;
+        asked.insert(idx);
+        lastPercent.insert(idx, c.percent);
+        lastPassed.insert(idx, c.passed);
+        if (c.round == lastRound) {
+            dealtThisRound.insert(idx);
+            lastDealt = idx;
+        }
+    }
+    QSet<int> queued;
+    for (const auto& c : checks) {
+        const int idx = m_db.cardIndexById(c.cardId);
+        if (idx < 0 || lastPassed.value(idx, true) || queued.contains(idx)) continue;
+        queued.insert(idx);
+        failedInOrder.push_back(idx);
+    }
+
+    switch (static_cast<SessionOrder>(header->order)) {
+    case SessionOrder::Due: {
+        // Due today (as of now, so resuming on a later day picks up what became
+        // due since), or everything when practising ahead.
+        refreshDueHorizon();
+        const bool ahead = header->horizonMsUtc == std::numeric_limits<qint64>::max();
+        const qint64 horizon = ahead ? header->horizonMsUtc : m_db.dueHorizon();
+
+        int count = 0;
+        for (const auto& id : folderIds) count += ahead ? m_db.cardCountInFolder(id) : m_db.dueCountInFolder(id);
+        // Asked cards still in the due window are skipped by the merge.
+        const QSet<rewise::domain::Id> selected(folderIds.cbegin(), folderIds.cend());
+        for (int idx : asked) {
+            const auto& c = m_db.cards[idx];
+            if (selected.contains(c.folderId) && c.review.dueKey(c.createdAtMsUtc) <= horizon) --count;
+        }
+        if (count <= 0 && failedInOrder.isEmpty()) return nullptr;
+
+        std::vector<std::unique_ptr<rewise::review::CardStream>> streams;
+        streams.reserve(folderIds.size());
+        for (const auto& id : folderIds) streams.push_back(std::make_unique<DueStream>(m_db.dueCursor(id, horizon)));
+        auto order = std::make_unique<rewise::review::DueOrder>(std::move(streams), qMax(0, count));
+        if (!checks.isEmpty()) order->resume(std::move(asked), std::move(failedInOrder));
+        return order;
+    }
+    case SessionOrder::Shuffled:
+    case SessionOrder::Weighted:
+        break;
+    }
+
+    // The session's cards and seed are in the header from begin() on: a resume
+    // looks up that list (O(cards of the session + checks)) instead of walking
+    // the selection, and deals the same deck.
+    QVector<int> cards;
+    bool sameCards = true;                // every card of the list still exists
+    if (!header->cardIds.isEmpty()) {
+        cards.reserve(header->cardIds.size());
+        for (const auto& id : header->cardIds) {
+            const int idx = m_db.cardIndexById(id);
+            if (idx >= 0) cards.push_back(idx);
+            else sameCards = false;
+        }
+    } else {
+        if (allFolders) {
+            cards.resize(m_db.cards.size());
+            for (int i = 0; i < cards.size(); ++i) cards[i] = i;
+        } else {
+            for (const auto& id : folderIds) cards += m_db.cardIndicesInFolder(id);
+        }
+        // A new session records them; a version 1 file had none, nor a seed.
+        sameCards = checks.isEmpty();
+        if (sameCards) {
+            header->seed = QRandomGenerator::global()->generate();
+            header->cardIds.reserve(cards.size());
+            for (int idx : cards) header->cardIds.push_back(m_db.cards[idx].id);
+        }
+    }
+    if (cards.isEmpty()) return nullptr;
+
+    if (static_cast<SessionOrder>(header->order) == SessionOrder::Shuffled) {
+        if (!sameCards) {
+            // Cards went away (or no seed): a new shuffle, the round's dealt cards first.
+            auto order = std::make_unique<rewise::review::ShuffledDeck>(std::move(cards));
+            if (!checks.isEmpty()) order->resume(lastRound, dealtThisRound);
+            return order;
+        }
+        auto order = std::make_unique<rewise::review::ShuffledDeck>(std::move(cards), header->seed);
+        if (!checks.isEmpty()) order->replay(lastRound, lastDealt);
+        return order;
+    }
+
+    // Weights come from the schedule, or from the latest check in this session.
+    QVector<double> weights(cards.size());
+    for (int i = 0; i < cards.size(); ++i) {
+        const auto it = lastPercent.constFind(cards[i]);
+        weights[i] = (it != lastPercent.constEnd())
+                         ? rewise::review::WeightedOrder::weightFromPercent(*it)
+                         : rewise::review::WeightedOrder::weightOf(m_db.cards[cards[i]].review);
+    }
+    return std::make_unique<rewise::review::WeightedOrder>(std::move(cards), std::move(weights));
+}
+
+void MainWindow::refreshResumeOffer() {
+    rewise::storage::SessionHeader header;
+    const bool ok = m_session && m_session->loadHeader(&header);
+    m_library->setResumableSession(ok ? header.title : QString());
+}
+
+bool MainWindow::applyCheck(const rewise::storage::ReviewRecord& record, bool* passed) {
+    if (m_history) {
+        m_history->append(record);
+        if (!m_historyFlush.isActive()) m_historyFlush.start();
+    }
+
+    const auto* c = m_db.cardById(record.cardId);
+    if (!c) return false;
+
+    const auto* folder = m_db.folderById(c->folderId);
+    const int passPercent = folder ? folder->scoring.passPercent : rewise::review::Scheduler::kDefaultPassPercent;
+    const int grade = rewise::review::Scheduler::gradeFromPercent(record.percent, passPercent);
+    *passed = rewise::review::Scheduler::isPass(grade);
+    if (m_rollups) m_rollups->add(record, c->folderId, *passed);
+
+    const auto next = rewise::review::Scheduler::next(c->review, grade, record.atMsUtc);
+    m_db.setReviewState(record.cardId, next);
+    return true;
+}
+
+void MainWindow::onCardChecked(const rewise::storage::ReviewRecord& record) {
+    bool passed = false;
+    if (!applyCheck(record, &passed)) return;
+
+    if (m_session) {
+        rewise::storage::SessionCheck check;
+        check.cardId = record.cardId;
+        check.answerMs = record.answerMs;
+        check.round = static_cast<quint16>(qBound(0, m_review->sessionRound(), 0xffff));
+        check.percent = record.percent;
+        check.passed = passed;
+        QString err;
+        if (!m_session->appendCheck(check, &err)) m_library->showError("Не удалось сохранить ход повторения: " + err);
+    }
+
+    publish(m_db.takeChangeEvents());
+    scheduleSave();
+}
+
+void MainWindow::onExamGraded(const QVector<rewise::storage::ReviewRecord>& records) {
+    // Not part of any resumable session: the session file is left alone.
+    bool any = false;
+    for (const auto& record : records) {
+        bool passed = false;
+        any = applyCheck(record, &passed) || any;
+    }
+    if (!any) return;
+    publish(m_db.takeChangeEvents());
+    scheduleSave();
+}
+
+void MainWindow::onShowStats() {
+    if (!m_rollups) {
+        m_library->showError("Статистика недоступна.");
+        return;
+    }
+    const qint32 today = rewise::storage::ReviewLog::localDayOf(rewise::domain::Card::nowUtcMs());
+    m_stats->showStats(*m_rollups, m_db.folders, today);
+    m_stack->setCurrentWidget(m_stats);
+}
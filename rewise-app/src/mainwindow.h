@@ -1,11 +1,21 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include <QFutureWatcher>
 #include <QMainWindow>
 #include <QTimer>
 
-#include "storage/Repository.h"
+#include "review/CardOrder.h"
+#include "storage/ChangeEvents.h"
+#include "storage/StorageBackend.h"
 #include "storage/Database.h"
+#include "storage/ReviewLog.h"
+#include "storage/ReviewRollups.h"
+#include "storage/ReviewSessionFile.h"
+
+#include <QVector>
+
+#include <memory>
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -16,6 +26,7 @@ class QStackedWidget;
 namespace rewise::ui::pages {
 class LibraryPage;
 class ReviewPage;
+class StatsPage;
 }
 
 class MainWindow final : public QMainWindow {
@@ -26,32 +37,96 @@ public:
 
 private:
     void loadDb();
+    // After a mutation of m_db: records the previous version for undo and publishes.
     void applyAndRefresh(const QString& successInfo = {});
+    // Shares m_db as a new immutable snapshot (O(folders)) and announces it on m_bus.
+    void publish(const rewise::storage::ChangeEvents& events);
     void scheduleSave();
     void saveNow();
+    // Moves the due horizon of m_db to the end of today and re-arms m_dayTimer.
+    void refreshDueHorizon();
+
+    // Opens the review history, its statistics and the interrupted session (all next to the database).
+    void openHistory();
+    // Writes queued history records on a worker thread (one write at a time).
+    void flushHistoryAsync();
 
     // Mutations
     void onFolderCreate(const QString& name);
     void onFolderRename(const rewise::domain::Id& id, const QString& newName);
     void onFolderDelete(const rewise::domain::Id& id);
+    void onFolderScoring(const rewise::domain::Id& id, const rewise::domain::ReviewSettings& scoring);
 
     void onCardCreate(const rewise::domain::Id& folderId, const QString& q, const QString& a);
     void onCardUpdate(const rewise::domain::Id& cardId, const QString& q, const QString& a);
     void onCardDelete(const rewise::domain::Id& cardId);
 
-    void onStartReview(const rewise::domain::Id& folderId);
+    // Explicit full consistency check ("fsck").
+    void onCheckDatabase();
+
+    // Empty selection = all folders.
+    void onStartReview(const QVector<rewise::domain::Id>& selectedFolderIds, rewise::review::SessionOrder sessionOrder);
+    // A timed exam over `cardCount` random cards of the selection (0 minutes = no limit).
+    void onStartExam(const QVector<rewise::domain::Id>& selectedFolderIds, int cardCount, int timeLimitMinutes);
+    // Continues the session in m_session where it stopped.
+    void onResumeReview();
+    // Card order for a session; with `checks`, the order continues after them.
+    // A new shuffled or weighted session records its cards and seed in *header.
+    // Null if there is nothing to ask.
+    std::unique_ptr<rewise::review::CardOrder> buildSessionOrder(rewise::storage::SessionHeader* header,
+                                                                 const QVector<rewise::storage::SessionCheck>& checks);
+    void refreshResumeOffer();
+    // Logs the check and reschedules the card. Review progress is not an edit:
+    // no undo step, and undo/redo keep it (see restoreVersion).
+    void onCardChecked(const rewise::storage::ReviewRecord& record);
+    // Every graded answer of an exam, as one published change.
+    void onExamGraded(const QVector<rewise::storage::ReviewRecord>& records);
+    // History, statistics and schedule of one check; false if the card is gone.
+    // Doesn't publish.
+    bool applyCheck(const rewise::storage::ReviewRecord& record, bool* passed);
+
+    void onShowStats();
+
+    // History of published versions (structurally shared, so cheap to keep).
+    // Each carries the body-store save generation it may read lazy text from.
+    struct Version final {
+        rewise::storage::DatabaseSnapshot db;
+        quint64 bodyGeneration = 0;
+    };
+    void undo();
+    void redo();
+    void restoreVersion(const Version& version);
+    // Lets the lazy-body store drop text only versions gone from the history read.
+    void releaseBodies();
 
 private:
     Ui::MainWindow* ui = nullptr;
 
-    rewise::storage::Repository m_repo;
-    rewise::storage::Database m_db;
+    std::unique_ptr<rewise::storage::StorageBackend> m_repo;
+    rewise::storage::Database m_db;                      // working copy, mutated in place
+    rewise::storage::DatabaseSnapshot m_published;       // what the pages currently show
+    quint64 m_publishedGeneration = 0;
+    quint64 m_dbGeneration = 0;                          // last save, or the restored version's
+    QVector<Version> m_undo;
+    QVector<Version> m_redo;
+    rewise::storage::ChangeBus m_bus;
 
     QStackedWidget* m_stack = nullptr;
     rewise::ui::pages::LibraryPage* m_library = nullptr;
     rewise::ui::pages::ReviewPage* m_review = nullptr;
+    rewise::ui::pages::StatsPage* m_stats = nullptr;
 
     QTimer m_autosave;
+    QTimer m_dayTimer;   // fires after midnight: cards become due
+
+    // Review history: checks are queued in memory and written in batches off the GUI thread.
+    std::shared_ptr<rewise::storage::ReviewLog> m_history;
+    QTimer m_historyFlush;
+    QFutureWatcher<QString> m_historyWriter;   // result: error text, empty on success
+    // Per-day x folder totals of the history; saved together with the database.
+    std::unique_ptr<rewise::storage::ReviewRollups> m_rollups;
+    // The running review session, appended to after every check.
+    std::unique_ptr<rewise::storage::ReviewSessionFile> m_session;
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,118 @@
+#include "AliasSampler.h"
+
+#include <utility>
+
+namespace rewise::review {
+
+AliasSampler::AliasSampler(QVector<double> weights)
+    : m_weights(std::move(weights))
+{
+    for (double& w : m_weights) w = qMax(0.0, w);
+    rebuild();
+}
+
+void AliasSampler::rebuild() {
+    const int n = m_weights.size();
+    m_built = m_weights;
+    m_prob = QVector<double>(n, 1.0);
+    m_alias = QVector<int>(n, 0);
+    m_excess = QVector<double>(n, 0.0);
+    m_excessTree = QVector<double>(n + 1, 0.0);
+    m_extraCount = 0;
+    m_extraTotal = 0.0;
+
+    m_builtTotal = 0.0;
+    for (double w : m_built) m_builtTotal += w;
+    m_total = m_builtTotal;
+    if (n == 0 || m_builtTotal <= 0.0) return;
+
+    // Vose: split columns into under- and over-full ones (scaled to average 1),
+    // then top up each small column from a large one.
+    QVector<double> scaled(n);
+    QVector<int> small;
+    QVector<int> large;
+    for (int i = 0; i < n; ++i) {
+        scaled[i] = m_built[i] * n / m_builtTotal;
+        (scaled[i] < 1.0 ? small : large).push_back(i);
+    }
+    while (!small.isEmpty() && !large.isEmpty()) {
+        const int s = small.takeLast();
+        const int l = large.last();
+        m_prob[s] = scaled[s];
+        m_alias[s] = l;
+        scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+        if (scaled[l] < 1.0) {
+            large.removeLast();
+            small.push_back(l);
+        }
+    }
+    // Leftovers are full columns up to rounding.
+    for (int i : large) m_prob[i] = 1.0;
+    for (int i : small) m_prob[i] = 1.0;
+}
+
+void AliasSampler::setExcess(int i, double excess) {
+    excess = qMax(0.0, excess);
+    const double delta = excess - m_excess[i];
+    if (delta == 0.0) return;
+
+    if (m_excess[i] <= 0.0) ++m_extraCount;
+    if (excess <= 0.0) --m_extraCount;
+    m_excess[i] = excess;
+    m_extraTotal = (m_extraCount > 0) ? qMax(0.0, m_extraTotal + delta) : 0.0; // no drift once all are gone
+
+    const int n = m_excessTree.size() - 1;
+    for (int k = i + 1; k <= n; k += k & -k) m_excessTree[k] += delta;
+}
+
+int AliasSampler::findExcess(double u) const {
+    // Fenwick descent: the largest prefix whose sum is <= u ends right before the answer.
+    const int n = m_excessTree.size() - 1;
+    int step = 1;
+    while (step * 2 <= n) step *= 2;
+
+    int pos = 0;
+    for (; step > 0; step /= 2) {
+        if (pos + step <= n && m_excessTree[pos + step] <= u) {
+            pos += step;
+            u -= m_excessTree[pos];
+        }
+    }
+    return pos; // 0-based index; == n only through rounding
+}
+
+void AliasSampler::setWeight(int i, double w) {
+    if (i < 0 || i >= m_weights.size()) return;
+    w = qMax(0.0, w);
+    m_total += w - m_weights[i];
+    m_weights[i] = w;
+    setExcess(i, w - m_built[i]);
+}
+
+int AliasSampler::sample(QRandomGenerator& rng) {
+    const int n = m_weights.size();
+    if (n == 0) return -1;
+
+    const bool bloated = m_extraCount > qMax(kMinExtra, n / 4);
+    const bool wasteful = m_total < 0.5 * (m_builtTotal + m_extraTotal);
+    if (bloated || wasteful) rebuild();
+    if (m_total <= 0.0) return -1;
+
+    for (;;) {
+        const double u = rng.generateDouble() * (m_builtTotal + m_extraTotal);
+        if (u < m_builtTotal) {
+            const int col = rng.bounded(n);
+            const int i = (rng.generateDouble() < m_prob[col]) ? col : m_alias[col];
+            const double built = m_built[i];
+            if (built <= 0.0) continue;
+            if (m_weights[i] >= built || rng.generateDouble() * built < m_weights[i]) return i;
+            continue;
+        }
+
+        // Rounding can land past the last excess or on a zero one: draw again.
+        const int i = findExcess(u - m_builtTotal);
+        if (i < n && m_excess[i] > 0.0) return i;
+    }
+}
+
+} // namespace rewise::review
@@ -0,0 +1,64 @@
+#ifndef REWISE_REVIEW_ALIASSAMPLER_H
+#define REWISE_REVIEW_ALIASSAMPLER_H
+
+#include <QRandomGenerator>
+#include <QVector>
+
+namespace rewise::review {
+
+// Weighted sampling of indices 0..n-1 with Vose's alias method: O(1) per draw
+// after an O(n) build.
+//
+// Weight changes don't rebuild the table. A draw proposes an index from the
+// table built with the old weights and accepts it with probability
+// min(new, old) / old; the part of a weight above its built value (the excess)
+// is drawn from a Fenwick tree instead. Both together give every index exactly
+// its current weight.
+//
+// setWeight() is O(log n). A draw is O(1) expected from the table and O(log n)
+// from the excess tree. The table is rebuilt once more than max(kMinExtra, n/4)
+// indices carry an excess, or fewer than half of the proposals would be accepted.
+// Both take Θ(n) updates when weights stay within a constant ratio (as review
+// weights do), so the O(n) rebuild adds O(1) amortized per update.
+class AliasSampler final {
+public:
+    static constexpr int kMinExtra = 64;
+
+    AliasSampler() = default;
+    // Negative weights count as 0.
+    explicit AliasSampler(QVector<double> weights);
+
+    int size() const { return m_weights.size(); }
+    double weight(int i) const { return m_weights[i]; }
+    double totalWeight() const { return m_total; }
+
+    void setWeight(int i, double w);
+
+    // -1 if every weight is 0.
+    int sample(QRandomGenerator& rng);
+
+private:
+    void rebuild();
+    void setExcess(int i, double excess);
+    // Index whose excess covers `u` in [0, m_extraTotal) (prefix sums in index order).
+    int findExcess(double u) const;
+
+    QVector<double> m_weights;   // current
+    double m_total = 0.0;
+
+    // Table built from m_built.
+    QVector<double> m_built;
+    QVector<double> m_prob;      // chance to keep column i rather than its alias
+    QVector<int> m_alias;
+    double m_builtTotal = 0.0;
+
+    // Weight above the built one, per index, plus a Fenwick tree over it (1-based).
+    QVector<double> m_excess;
+    QVector<double> m_excessTree;
+    int m_extraCount = 0;        // indices with excess > 0
+    double m_extraTotal = 0.0;
+};
+
+} // namespace rewise::review
+
+#endif // REWISE_REVIEW_ALIASSAMPLER_H
@@ -0,0 +1,174 @@
+#include "CardOrder.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+namespace rewise::review {
+
+// --- DueOrder ---
+
+DueOrder::DueOrder(std::vector<std::unique_ptr<CardStream>> streams, int cardCount)
+    : m_streams(std::move(streams))
+    , m_cardCount(cardCount)
+{
+    for (int i = 0; i < static_cast<int>(m_streams.size()); ++i) {
+        if (m_streams[i] && !m_streams[i]->atEnd()) m_heads.push_back({m_streams[i]->key(), i});
+    }
+    std::make_heap(m_heads.begin(), m_heads.end(), std::greater<Head>());
+}
+
+int DueOrder::pull() {
+    while (!m_heads.empty()) {
+        std::pop_heap(m_heads.begin(), m_heads.end(), std::greater<Head>());
+        const int s = m_heads.back().second;
+        m_heads.pop_back();
+
+        CardStream& stream = *m_streams[s];
+        const int card = stream.card();
+        stream.advance();
+        if (!stream.atEnd()) {
+            m_heads.push_back({stream.key(), s});
+            std::push_heap(m_heads.begin(), m_heads.end(), std::greater<Head>());
+        }
+        if (m_skip.contains(card)) continue;
+        ++m_pulled;
+        return card;
+    }
+    return -1;
+}
+
+void DueOrder::resume(QSet<int> asked, QVector<int> retry) {
+    m_skip = std::move(asked);
+    m_retry = std::move(retry);
+    m_retryPos = 0;
+}
+
+int DueOrder::next() {
+    if (!m_ahead.isEmpty()) return m_ahead.takeFirst();
+    const int card = pull();
+    if (card >= 0) return card;
+    return (m_retryPos < m_retry.size()) ? m_retry[m_retryPos++] : -1;
+}
+
+QVector<int> DueOrder::peek(int count) {
+    while (m_ahead.size() < count) {
+        const int card = pull();
+        if (card < 0) break;
+        m_ahead.push_back(card);
+    }
+    QVector<int> out = m_ahead.mid(0, count);
+    if (out.size() < count) out += m_retry.mid(m_retryPos, count - out.size());
+    return out;
+}
+
+void DueOrder::checked(int card, int percent, bool passed) {
+    Q_UNUSED(percent);
+    if (!passed) m_retry.push_back(card);
+}
+
+int DueOrder::remaining() const {
+    return qMax(0, m_cardCount - m_pulled) + m_ahead.size() + (m_retry.size() - m_retryPos);
+}
+
+// --- ShuffledDeck ---
+
+ShuffledDeck::ShuffledDeck(QVector<int> cards, quint32 seed)
+    : m_deck(std::move(cards))
+    , m_rng(seed)
+{
+    shuffle();
+}
+
+void ShuffledDeck::shuffle() {
+    for (int i = m_deck.size() - 1; i > 0; --i) {
+        const int j = m_rng.bounded(i + 1);
+        std::swap(m_deck[i], m_deck[j]);
+    }
+}
+
+void ShuffledDeck::nextPass() {
+    const int last = m_deck.last();
+    shuffle();
+    if (m_deck.size() > 1 && m_deck.first() == last) std::swap(m_deck.first(), m_deck[1 + m_rng.bounded(m_deck.size() - 1)]);
+    m_pos = 0;
+    ++m_pass;
+}
+
+int ShuffledDeck::next() {
+    if (m_deck.isEmpty()) return -1;
+    if (m_pos == m_deck.size()) nextPass();
+    return m_deck[m_pos++];
+}
+
+void ShuffledDeck::resume(int pass, const QSet<int>& dealt) {
+    // The deck is freshly shuffled: moving the dealt cards to the front keeps
+    // both parts in random order.
+    const auto mid = std::stable_partition(m_deck.begin(), m_deck.end(), [&](int c) { return dealt.contains(c); });
+    m_pos = static_cast<int>(mid - m_deck.begin());
+    m_pass = qMax(1, pass);
+}
+
+void ShuffledDeck::replay(int pass, int lastDealt) {
+    if (m_deck.isEmpty()) return;
+    // Every reshuffle draws from m_rng: going through them in order reproduces the deck.
+    while (m_pass < pass) nextPass();
+    m_pos = m_deck.indexOf(lastDealt) + 1; // 0 if it isn't in the deck
+}
+
+QVector<int> ShuffledDeck::peek(int count) {
+    // The next pass isn't shuffled yet: peek stops at the end of this one.
+    return m_deck.mid(m_pos, count);
+}
+
+// --- WeightedOrder ---
+
+WeightedOrder::WeightedOrder(QVector<int> cards, QVector<double> weights, quint32 seed)
+    : m_cards(std::move(cards))
+    , m_sampler(std::move(weights))
+    , m_rng(seed)
+{}
+
+double WeightedOrder::weightOf(const rewise::domain::ReviewState& s) {
+    if (s.isNew()) return (kMinWeight + kMaxWeight) / 2;
+    // Ease 2.5+ (easy) .. 1.3 (hard) -> 0..1.
+    const double hardness = qBound(0.0, (2.5 - s.ease) / 1.2, 1.0);
+    return qMin(kMaxWeight, kMinWeight + (kMaxWeight - kMinWeight) * hardness + s.lapses);
+}
+
+double WeightedOrder::weightFromPercent(int percent) {
+    return kMinWeight + (kMaxWeight - kMinWeight) * (100 - qBound(0, percent, 100)) / 100.0;
+}
+
+int WeightedOrder::draw(int avoid) {
+    // A few redraws are enough unless one card holds nearly all the weight.
+    int pos = m_sampler.sample(m_rng);
+    for (int tries = 0; pos == avoid && m_cards.size() > 1 && tries < 8; ++tries) pos = m_sampler.sample(m_rng);
+    return pos;
+}
+
+int WeightedOrder::next() {
+    const int pos = m_ahead.isEmpty() ? draw(m_lastPos) : m_ahead.takeFirst();
+    m_lastPos = pos;
+    return (pos >= 0) ? m_cards[pos] : -1;
+}
+
+QVector<int> WeightedOrder::peek(int count) {
+    while (m_ahead.size() < count) {
+        const int pos = draw(m_ahead.isEmpty() ? m_lastPos : m_ahead.last());
+        if (pos < 0) break;
+        m_ahead.push_back(pos);
+    }
+    QVector<int> out;
+    out.reserve(count);
+    for (int i = 0; i < count && i < m_ahead.size(); ++i) out.push_back(m_cards[m_ahead[i]]);
+    return out;
+}
+
+void WeightedOrder::checked(int card, int percent, bool passed) {
+    Q_UNUSED(passed);
+    if (m_lastPos < 0 || m_cards[m_lastPos] != card) return;
+    m_sampler.setWeight(m_lastPos, weightFromPercent(percent));
+}
+
+} // namespace rewise::review
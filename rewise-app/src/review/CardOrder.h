@@ -0,0 +1,178 @@
+#ifndef REWISE_REVIEW_CARDORDER_H
+#define REWISE_REVIEW_CARDORDER_H
+
+#include "AliasSampler.h"
+#include "../domain/ReviewState.h"
+
+#include <QRandomGenerator>
+#include <QSet>
+#include <QVector>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace rewise::review {
+
+// How a session picks its cards (see DueOrder, ShuffledDeck, WeightedOrder).
+enum class SessionOrder {
+    Due,        // due cards, earliest first
+    Shuffled,   // all cards, each once per pass
+    Weighted    // all cards, poorly answered ones more often
+};
+
+// Order in which a review session asks its cards. Cards are opaque indices
+// (the session's database snapshot knows what they mean).
+class CardOrder {
+public:
+    virtual ~CardOrder() = default;
+
+    // Next card to ask; -1 ends the session.
+    virtual int next() = 0;
+    // Up to `count` cards next() will return, without consuming them (prefetch).
+    virtual QVector<int> peek(int count) = 0;
+    // The check of a card just returned by next() scored `percent`; `passed`
+    // is that score measured against the card's folder threshold.
+    virtual void checked(int card, int percent, bool passed) { Q_UNUSED(card); Q_UNUSED(percent); Q_UNUSED(passed); }
+
+    // Distinct cards in the session.
+    virtual int cardCount() const = 0;
+    // Cards still to ask after the current one; -1 for orders that never run out.
+    virtual int remaining() const = 0;
+    // Pass the card last returned by next() belongs to (shuffled decks), 0 otherwise.
+    virtual int round() const { return 0; }
+};
+
+// Cards in non-decreasing key order, produced lazily (e.g. one folder's due cards).
+class CardStream {
+public:
+    virtual ~CardStream() = default;
+
+    virtual bool atEnd() const = 0;
+    // Current card; only valid while !atEnd().
+    virtual qint64 key() const = 0;
+    virtual int card() const = 0;
+    virtual void advance() = 0;
+};
+
+// Cards of several streams by key, earliest first; failed cards are asked again
+// at the end. A lazy k-way merge: a min-heap holds the head of every stream,
+// so a card costs O(log streams) and nothing is collected or sorted up front.
+// Ties go to the earlier stream.
+class DueOrder final : public CardOrder {
+public:
+    // `cardCount` = cards the streams hold together (shown as "remaining").
+    DueOrder(std::vector<std::unique_ptr<CardStream>> streams, int cardCount);
+
+    int next() override;
+    QVector<int> peek(int count) override;
+    void checked(int card, int percent, bool passed) override;
+    int cardCount() const override { return m_cardCount; }
+    int remaining() const override;
+
+    // Resuming a session, before the first next(): `asked` cards are left out
+    // of the merge (and of `cardCount`), `retry` ones are asked at the end.
+    void resume(QSet<int> asked, QVector<int> retry);
+
+private:
+    using Head = std::pair<qint64, int>; // key, stream
+
+    int pull();   // next card of the merge, -1 when every stream is done
+
+    std::vector<std::unique_ptr<CardStream>> m_streams;
+    std::vector<Head> m_heads;   // min-heap (std::greater)
+    int m_cardCount = 0;
+    int m_pulled = 0;
+
+    QVector<int> m_ahead;        // pulled for peek(), not asked yet
+    QVector<int> m_retry;        // failed cards, asked after the merge
+    int m_retryPos = 0;
+    QSet<int> m_skip;            // asked before a resume
+};
+
+// The given cards once each, in the given order (e.g. an exam's questions).
+class ListOrder final : public CardOrder {
+public:
+    explicit ListOrder(QVector<int> cards)
+        : m_cards(std::move(cards))
+    {}
+
+    int next() override { return m_pos < m_cards.size() ? m_cards[m_pos++] : -1; }
+    QVector<int> peek(int count) override { return m_cards.mid(m_pos, count); }
+    int cardCount() const override { return m_cards.size(); }
+    int remaining() const override { return m_cards.size() - m_pos; }
+
+private:
+    QVector<int> m_cards;
+    int m_pos = 0;
+};
+
+// Fisher–Yates shuffled deck: every card exactly once per pass, reshuffled when
+// the pass is over (never starting with the card that ended the last one).
+// The same cards (in the same order) and seed deal the same passes.
+// Endless; O(1) per card.
+class ShuffledDeck final : public CardOrder {
+public:
+    explicit ShuffledDeck(QVector<int> cards, quint32 seed = QRandomGenerator::global()->generate());
+
+    int next() override;
+    QVector<int> peek(int count) override;
+    int cardCount() const override { return m_deck.size(); }
+    int remaining() const override { return -1; }
+    int round() const override { return m_pass; }   // 1-based
+
+    // Resuming a session, before the first next(): continues pass `pass`, in
+    // which the `dealt` cards have been asked already (a new shuffle of the rest).
+    void resume(int pass, const QSet<int>& dealt);
+    // Resuming with the cards and seed the session began with, before the first
+    // next(): deals again up to `lastDealt` in pass `pass`, so the session goes
+    // on with the same deck. O(cards * pass), i.e. O(cards + checks so far).
+    void replay(int pass, int lastDealt);
+
+private:
+    void shuffle();
+    void nextPass();
+
+    QVector<int> m_deck;
+    int m_pos = 0;
+    int m_pass = 1;
+    QRandomGenerator m_rng;
+};
+
+// Weighted random order favouring cards that went badly (see weightOf):
+// a weight comes from the card's schedule and is replaced by the similarity of
+// each check in the session. Never asks the same card twice in a row when
+// there is a choice. Endless; O(log n) per card (AliasSampler), amortized.
+class WeightedOrder final : public CardOrder {
+public:
+    static constexpr double kMinWeight = 1.0;
+    static constexpr double kMaxWeight = 10.0;
+
+    // weights[i] belongs to cards[i].
+    WeightedOrder(QVector<int> cards, QVector<double> weights,
+                  quint32 seed = QRandomGenerator::global()->generate());
+
+    int next() override;
+    QVector<int> peek(int count) override;
+    void checked(int card, int percent, bool passed) override;
+    int cardCount() const override { return m_cards.size(); }
+    int remaining() const override { return -1; }
+
+    // New cards sit in the middle; reviewed ones by ease (which SM-2 lowers on
+    // every poor check) and lapses.
+    static double weightOf(const rewise::domain::ReviewState& s);
+    static double weightFromPercent(int percent);
+
+private:
+    int draw(int avoid);   // position in m_cards
+
+    QVector<int> m_cards;
+    AliasSampler m_sampler;      // over positions in m_cards
+    QVector<int> m_ahead;        // positions drawn for peek(), in order
+    int m_lastPos = -1;          // position of the card returned by next()
+    QRandomGenerator m_rng;
+};
+
+} // namespace rewise::review
+
+#endif // REWISE_REVIEW_CARDORDER_H
@@ -2,10 +2,16 @@
 
 #include <QVector>
 #include <algorithm>
+#include <cmath>
+#include <cstdlib>
 
 namespace rewise::review {
 
-int Levenshtein::distance(const QString& a, const QString& b) {
+namespace {
+
+// Two-row DP over any sequence with size() and at(): characters or word tokens.
+template <class Sequence>
+int editDistance(const Sequence& a, const Sequence& b) {
     const int n = a.size();
     const int m = b.size();
     if (n == 0) return m;
@@ -18,11 +24,10 @@ int Levenshtein::distance(const QString& a, const QString& b) {
 
     for (int i = 1; i <= n; ++i) {
         cur[0] = i;
-        const QChar ca = a.at(i - 1);
+        const auto& ca = a.at(i - 1);
 
         for (int j = 1; j <= m; ++j) {
-            const QChar cb = b.at(j - 1);
-            const int cost = (ca == cb) ? 0 : 1;
+            const int cost = (ca == b.at(j - 1)) ? 0 : 1;
 
             const int del = prev[j] + 1;
             const int ins = cur[j - 1] + 1;
@@ -36,34 +41,76 @@ int Levenshtein::distance(const QString& a, const QString& b) {
     return prev[m];
 }
 
-SimilarityResult Levenshtein::similarityFromNormalized(const QString& normalizedA,
-                                                       const QString& normalizedB) {
+SimilarityResult similarityFromDistance(int distance, int maxLen) {
     SimilarityResult r;
-
-    const int lenA = normalizedA.size();
-    const int lenB = normalizedB.size();
-    r.maxLen = std::max(lenA, lenB);
-
-    // Define: if both empty => 100%, else if one empty => 0%.
-    if (r.maxLen == 0) {
-        r.distance = 0;
+    r.distance = distance;
+    r.maxLen = maxLen;
+    if (maxLen == 0) {
         r.similarity = 1.0;
         r.percent = 100;
         return r;
     }
+    r.similarity = std::clamp(1.0 - static_cast<double>(distance) / static_cast<double>(maxLen), 0.0, 1.0);
+    r.percent = std::clamp(static_cast<int>(std::lround(r.similarity * 100.0)), 0, 100);
+    return r;
+}
 
-    r.distance = distance(normalizedA, normalizedB);
-    r.similarity = 1.0 - (static_cast<double>(r.distance) / static_cast<double>(r.maxLen));
+} // namespace
 
-    // Clamp due to any potential rounding.
-    if (r.similarity < 0.0) r.similarity = 0.0;
-    if (r.similarity > 1.0) r.similarity = 1.0;
+int Levenshtein::distance(const QString& a, const QString& b) {
+    return editDistance(a, b);
+}
 
-    r.percent = static_cast<int>(std::lround(r.similarity * 100.0));
-    if (r.percent < 0) r.percent = 0;
-    if (r.percent > 100) r.percent = 100;
+int Levenshtein::distance(const QVector<QString>& a, const QVector<QString>& b) {
+    return editDistance(a, b);
+}
 
-    return r;
+int Levenshtein::boundedDistance(const QString& a, const QString& b, int maxDistance) {
+    const int n = a.size();
+    const int m = b.size();
+    const int limit = maxDistance + 1;
+    if (std::abs(n - m) > maxDistance) return limit;
+    if (n == 0 || m == 0) return std::max(n, m);
+
+    QVector<int> prev(m + 1);
+    QVector<int> cur(m + 1);
+
+    for (int j = 0; j <= m; ++j) prev[j] = std::min(j, limit);
+
+    for (int i = 1; i <= n; ++i) {
+        // Cells farther than maxDistance from the diagonal can't be within bound.
+        const int lo = std::max(1, i - maxDistance);
+        const int hi = std::min(m, i + maxDistance);
+        cur[lo - 1] = (lo == 1) ? std::min(i, limit) : limit;
+        int rowMin = cur[lo - 1];
+        const QChar ca = a.at(i - 1);
+
+        for (int j = lo; j <= hi; ++j) {
+            const int sub = prev[j - 1] + ((ca == b.at(j - 1)) ? 0 : 1);
+            const int v = std::min({sub, prev[j] + 1, cur[j - 1] + 1, limit});
+            cur[j] = v;
+            rowMin = std::min(rowMin, v);
+        }
+        if (hi < m) cur[hi + 1] = limit; // read as prev[j] by the next row's band edge
+
+        if (rowMin >= limit) return limit;
+        prev.swap(cur);
+    }
+
+    return prev[m];
+}
+
+SimilarityResult Levenshtein::similarityFromNormalized(const QString& normalizedA,
+                                                       const QString& normalizedB) {
+    // Both empty => 100%, one empty => 0%.
+    const int maxLen = std::max(normalizedA.size(), normalizedB.size());
+    return similarityFromDistance(maxLen ? distance(normalizedA, normalizedB) : 0, maxLen);
+}
+
+SimilarityResult Levenshtein::similarityFromTokens(const QVector<QString>& tokensA,
+                                                   const QVector<QString>& tokensB) {
+    const int maxLen = std::max(tokensA.size(), tokensB.size());
+    return similarityFromDistance(maxLen ? distance(tokensA, tokensB) : 0, maxLen);
 }
 
 } // namespace rewise::review
@@ -12,10 +12,20 @@ public:
     // Standard Levenshtein distance (insert/delete/replace).
     // Uses UTF-16 code units (QString indexing). Good for typical short texts.
     static int distance(const QString& a, const QString& b);
+    // Same over word tokens (a whole word is inserted, deleted or replaced).
+    static int distance(const QVector<QString>& a, const QVector<QString>& b);
+
+    // Same distance, but only computed up to `maxDistance`: returns maxDistance + 1
+    // as soon as the result is known to exceed it. Only a diagonal band of width
+    // 2 * maxDistance + 1 is filled, so this is O(len * maxDistance).
+    static int boundedDistance(const QString& a, const QString& b, int maxDistance);
 
     // Convenience: compute SimilarityResult from already-normalized strings.
     static SimilarityResult similarityFromNormalized(const QString& normalizedA,
                                                      const QString& normalizedB);
+    // Word-level similarity; distance and maxLen count tokens.
+    static SimilarityResult similarityFromTokens(const QVector<QString>& tokensA,
+                                                 const QVector<QString>& tokensB);
 };
 
 } // namespace rewise::review
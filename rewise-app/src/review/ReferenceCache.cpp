@@ -0,0 +1,41 @@
+#include "ReferenceCache.h"
+#include "ReviewEngine.h"
+
+#include <QMutexLocker>
+
+namespace rewise::review {
+
+namespace {
+
+int costOf(const PreparedReference& p) {
+    int chars = p.text.size() + p.normalized.size();
+    for (const auto& t : p.tokens) chars += t.size();
+    return qMax(1, chars * 2);
+}
+
+} // namespace
+
+ReferenceCache::ReferenceCache(int cacheBytes) {
+    m_cache.setMaxCost(cacheBytes);
+}
+
+PreparedReference ReferenceCache::get(const Key& key, const QString& answer, const NormalizeOptions& opt) {
+    {
+        QMutexLocker locker(&m_mutex);
+        if (const PreparedReference* cached = m_cache.object(key)) return *cached;
+    }
+
+    // Prepared outside the lock; two threads racing on one card just both prepare it.
+    PreparedReference prepared = ReviewEngine::prepare(answer, opt);
+
+    QMutexLocker locker(&m_mutex);
+    m_cache.insert(key, new PreparedReference(prepared), costOf(prepared));
+    return prepared;
+}
+
+void ReferenceCache::clear() {
+    QMutexLocker locker(&m_mutex);
+    m_cache.clear();
+}
+
+} // namespace rewise::review
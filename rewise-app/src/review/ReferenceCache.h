@@ -0,0 +1,48 @@
+#ifndef REWISE_REVIEW_REFERENCECACHE_H
+#define REWISE_REVIEW_REFERENCECACHE_H
+
+#include "ReviewTypes.h"
+#include "../domain/Id.h"
+
+#include <QCache>
+#include <QMutex>
+
+namespace rewise::review {
+
+// Prepared reference answers (ReviewEngine::prepare), kept across sessions.
+//
+// Keyed by (card id, content version, scoring hash): an edited card or a folder
+// whose scoring settings changed simply misses, and stale entries age out of
+// the bounded LRU (cost = UTF-16 bytes of text). Thread-safe, so prefetch
+// workers can share one cache.
+class ReferenceCache final {
+public:
+    struct Key final {
+        rewise::domain::Id cardId;
+        qint64 version = 0;        // Card::updatedAtMsUtc
+        quint32 scoringHash = 0;   // ReviewEngine::scoringHash
+
+        friend bool operator==(const Key& a, const Key& b) {
+            return a.cardId == b.cardId && a.version == b.version && a.scoringHash == b.scoringHash;
+        }
+        friend uint qHash(const Key& k, uint seed = 0) noexcept {
+            uint h = qHash(k.cardId, seed);
+            h = h * 31 + qHash(k.version, seed);
+            return h * 31 + k.scoringHash;
+        }
+    };
+
+    explicit ReferenceCache(int cacheBytes = 4 * 1024 * 1024);
+
+    // The cached reference for `key`, or `answer` prepared with `opt` (and cached).
+    PreparedReference get(const Key& key, const QString& answer, const NormalizeOptions& opt);
+    void clear();
+
+private:
+    mutable QMutex m_mutex;
+    QCache<Key, PreparedReference> m_cache;
+};
+
+} // namespace rewise::review
+
+#endif // REWISE_REVIEW_REFERENCECACHE_H
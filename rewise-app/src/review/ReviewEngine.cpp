@@ -8,17 +8,63 @@ namespace rewise::review {
 ReviewResult ReviewEngine::evaluate(const QString& referenceAnswer,
                                     const QString& userAnswer,
                                     const NormalizeOptions& opt) {
+    return evaluate(prepare(referenceAnswer, opt), userAnswer);
+}
+
+PreparedReference ReviewEngine::prepare(const QString& referenceAnswer,
+                                        const NormalizeOptions& opt) {
+    PreparedReference p;
+    p.text = referenceAnswer;
+    p.options = opt;
+    p.normalized = TextNormalize::normalize(referenceAnswer, opt);
+    p.tokens = TextNormalize::tokenizeWords(referenceAnswer, opt);
+    return p;
+}
+
+ReviewResult ReviewEngine::evaluate(const PreparedReference& reference,
+                                    const QString& userAnswer,
+                                    rewise::domain::ScoreMetric metric) {
     ReviewResult r;
 
-    r.normalizedReference = TextNormalize::normalize(referenceAnswer, opt);
-    r.normalizedUser = TextNormalize::normalize(userAnswer, opt);
+    r.normalizedReference = reference.normalized;
+    r.normalizedUser = TextNormalize::normalize(userAnswer, reference.options);
 
-    r.similarity = Levenshtein::similarityFromNormalized(r.normalizedReference,
-                                                         r.normalizedUser);
+    const QVector<QString> userTokens = TextNormalize::tokenizeWords(userAnswer, reference.options);
+    if (metric == rewise::domain::ScoreMetric::Words) {
+        r.similarity = Levenshtein::similarityFromTokens(reference.tokens, userTokens);
+    } else {
+        r.similarity = Levenshtein::similarityFromNormalized(r.normalizedReference,
+                                                             r.normalizedUser);
+    }
 
-    r.diff = WordDiff::diffByWords(referenceAnswer, userAnswer, opt);
+    r.diff = WordDiff::diffTokens(reference.tokens, userTokens);
 
     return r;
 }
 
+SimilarityResult ReviewEngine::score(const PreparedReference& reference,
+                                     const QString& userAnswer,
+                                     rewise::domain::ScoreMetric metric) {
+    if (metric == rewise::domain::ScoreMetric::Words) {
+        return Levenshtein::similarityFromTokens(reference.tokens,
+                                                 TextNormalize::tokenizeWords(userAnswer, reference.options));
+    }
+    return Levenshtein::similarityFromNormalized(reference.normalized,
+                                                 TextNormalize::normalize(userAnswer, reference.options));
+}
+
+NormalizeOptions ReviewEngine::normalizeOptions(const rewise::domain::ReviewSettings& settings) {
+    NormalizeOptions opt;
+    opt.toLower = settings.ignoreCase;
+    opt.simplifySpaces = settings.simplifySpaces;
+    opt.removePunctuation = settings.ignorePunctuation;
+    return opt;
+}
+
+quint32 ReviewEngine::scoringHash(const rewise::domain::ReviewSettings& settings) {
+    // Character scoring keeps the plain option hash, so older records still match.
+    return normalizeOptions(settings).hash()
+           | (settings.metric == rewise::domain::ScoreMetric::Words ? 8u : 0u);
+}
+
 } // namespace rewise::review
@@ -2,6 +2,7 @@
 #define REWISE_REVIEW_REVIEWENGINE_H
 
 #include "ReviewTypes.h"
+#include "../domain/ReviewSettings.h"
 
 namespace rewise::review {
 
@@ -11,6 +12,23 @@ public:
     static ReviewResult evaluate(const QString& referenceAnswer,
                                  const QString& userAnswer,
                                  const NormalizeOptions& opt = {});
+
+    // Normalizes and tokenizes the reference once; cheap to evaluate against afterwards.
+    static PreparedReference prepare(const QString& referenceAnswer,
+                                     const NormalizeOptions& opt = {});
+    static ReviewResult evaluate(const PreparedReference& reference,
+                                 const QString& userAnswer,
+                                 rewise::domain::ScoreMetric metric = rewise::domain::ScoreMetric::Characters);
+    // Similarity only, without the word diff (batch grading; the diff can be
+    // produced later with evaluate()).
+    static SimilarityResult score(const PreparedReference& reference,
+                                  const QString& userAnswer,
+                                  rewise::domain::ScoreMetric metric = rewise::domain::ScoreMetric::Characters);
+
+    // A folder's scoring settings as normalize options.
+    static NormalizeOptions normalizeOptions(const rewise::domain::ReviewSettings& settings);
+    // Identifies options + metric in stored results (history records, cached references).
+    static quint32 scoringHash(const rewise::domain::ReviewSettings& settings);
 };
 
 } // namespace rewise::review
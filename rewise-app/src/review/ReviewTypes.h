@@ -10,6 +10,20 @@ struct NormalizeOptions final {
     bool toLower = true;
     bool simplifySpaces = true;      // collapse whitespace + trim (via QString::simplified)
     bool removePunctuation = true;   // treat non-letter/digit as separators
+
+    // Identifies the option set in stored results (history records).
+    quint32 hash() const {
+        return (toLower ? 1u : 0u) | (simplifySpaces ? 2u : 0u) | (removePunctuation ? 4u : 0u);
+    }
+};
+
+// Reference answer with the per-answer work done ahead of time (see
+// ReviewEngine::prepare), so a check only has to process the user's text.
+struct PreparedReference final {
+    QString text;               // as written on the card
+    NormalizeOptions options;   // what `normalized` and `tokens` were produced with
+    QString normalized;
+    QVector<QString> tokens;    // word tokens for the diff
 };
 
 struct SimilarityResult final {
@@ -0,0 +1,68 @@
+#include "Scheduler.h"
+
+#include <QDateTime>
+
+#include <cmath>
+
+namespace rewise::review {
+
+using rewise::domain::ReviewState;
+
+static constexpr qint64 kDayMs = 24 * 60 * 60 * 1000;
+static constexpr double kMinEase = 1.3;
+static constexpr int kMaxIntervalDays = 36500;
+
+int Scheduler::gradeFromPercent(int percent, int passPercent) {
+    percent = qBound(0, percent, 100);
+    passPercent = qBound(1, passPercent, 100);
+    if (passPercent != kDefaultPassPercent) {
+        // [0, pass) -> [0, 70), [pass, 100] -> [70, 100].
+        if (percent < passPercent) percent = percent * kDefaultPassPercent / passPercent;
+        else if (passPercent == 100) percent = 100;
+        else percent = kDefaultPassPercent + (percent - passPercent) * (100 - kDefaultPassPercent) / (100 - passPercent);
+    }
+    if (percent >= 95) return 5;
+    if (percent >= 85) return 4;
+    if (percent >= 70) return 3;
+    if (percent >= 50) return 2;
+    if (percent >= 25) return 1;
+    return 0;
+}
+
+ReviewState Scheduler::next(const ReviewState& state, int grade, qint64 nowMsUtc) {
+    grade = qBound(0, grade, 5);
+    ReviewState s = state;
+
+    // SM-2 easiness update, applied to every grade.
+    const int miss = 5 - grade;
+    s.ease = qMax(kMinEase, s.ease + 0.1 - miss * (0.08 + miss * 0.02));
+    s.lastReviewAtMsUtc = nowMsUtc;
+
+    if (!isPass(grade)) {
+        if (state.repetitions > 0) ++s.lapses;
+        s.repetitions = 0;
+        s.intervalDays = 0;
+        s.dueAtMsUtc = nowMsUtc + kRelearnDelayMs;
+        return s;
+    }
+
+    ++s.repetitions;
+    if (s.repetitions == 1) {
+        s.intervalDays = 1;
+    } else if (s.repetitions == 2) {
+        s.intervalDays = 6;
+    } else {
+        const double grown = std::ceil(state.intervalDays * s.ease);
+        s.intervalDays = static_cast<int>(qMin<double>(kMaxIntervalDays, qMax<double>(state.intervalDays + 1, grown)));
+    }
+    s.dueAtMsUtc = nowMsUtc + s.intervalDays * kDayMs;
+    return s;
+}
+
+qint64 Scheduler::endOfLocalDayMsUtc(qint64 msUtc) {
+    const QDateTime local = QDateTime::fromMSecsSinceEpoch(msUtc).toLocalTime();
+    const QDateTime nextMidnight(local.date().addDays(1), QTime(0, 0));
+    return nextMidnight.toMSecsSinceEpoch() - 1;
+}
+
+} // namespace rewise::review
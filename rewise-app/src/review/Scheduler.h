@@ -0,0 +1,36 @@
+#ifndef REWISE_REVIEW_SCHEDULER_H
+#define REWISE_REVIEW_SCHEDULER_H
+
+#include "../domain/ReviewState.h"
+
+#include <QtGlobal>
+
+namespace rewise::review {
+
+// SM-2 spaced repetition driven by the similarity percent of a check.
+//
+// Grades use the SM-2 scale 0..5; 3 and up is a pass. A pass grows the
+// interval (1 day, 6 days, then interval * ease); a failure restarts the card
+// with a short relearning step so it comes back within the same session.
+class Scheduler final {
+public:
+    static constexpr int kPassGrade = 3;
+    static constexpr int kDefaultPassPercent = 70;
+    static constexpr qint64 kRelearnDelayMs = 10 * 60 * 1000;
+
+    // 100..95 -> 5, ..85 -> 4, ..70 -> 3, ..50 -> 2, ..25 -> 1, below -> 0.
+    // Another pass threshold (a folder's ReviewSettings::passPercent) first
+    // rescales the percent so the threshold lands on 70.
+    static int gradeFromPercent(int percent, int passPercent = kDefaultPassPercent);
+    static bool isPass(int grade) { return grade >= kPassGrade; }
+
+    // State after a check graded `grade` at `nowMsUtc`.
+    static rewise::domain::ReviewState next(const rewise::domain::ReviewState& state, int grade, qint64 nowMsUtc);
+
+    // Last millisecond of the local day containing `msUtc`: the "due today" horizon.
+    static qint64 endOfLocalDayMsUtc(qint64 msUtc);
+};
+
+} // namespace rewise::review
+
+#endif // REWISE_REVIEW_SCHEDULER_H
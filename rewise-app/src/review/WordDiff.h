@@ -13,8 +13,7 @@ public:
     static DiffResult diffByWords(const QString& referenceText,
                                   const QString& userText,
                                   const NormalizeOptions& opt = {});
-
-private:
+    // Same, with both sides already tokenized.
     static DiffResult diffTokens(const QVector<QString>& refTokens,
                                  const QVector<QString>& userTokens);
 };
@@ -0,0 +1,60 @@
+#include "CardBodyStore.h"
+
+#include <QMutexLocker>
+
+#include <limits>
+#include <utility>
+
+namespace rewise::storage {
+
+using rewise::domain::Card;
+
+CardBodyStore::CardBodyStore(qint64 cacheBytes) {
+    m_cache.setMaxCost(static_cast<int>(qMin<qint64>(cacheBytes, std::numeric_limits<int>::max())));
+}
+
+bool CardBodyStore::read(const rewise::domain::Id& id, CardBody* out, QString* error, bool cache) const {
+    {
+        QMutexLocker locker(&m_mutex);
+        if (const CardBody* cached = m_cache.object(id)) {
+            *out = *cached;
+            return true;
+        }
+    }
+
+    // Unlocked: a slow read doesn't stall cache hits on other threads. Two threads
+    // missing on the same card both read it; the second insert just replaces the first.
+    CardBody body;
+    if (!readBody(id, &body, error)) return false;
+
+    if (cache) {
+        const int cost = (body.question.size() + body.answer.size()) * 2;
+        QMutexLocker locker(&m_mutex);
+        m_cache.insert(id, new CardBody(body), cost);
+    }
+    *out = std::move(body);
+    return true;
+}
+
+bool CardBodyStore::resolve(const Card& c, Card* out, QString* error) const {
+    if (c.hasFullText()) {
+        *out = c;
+        return true;
+    }
+
+    CardBody body;
+    if (!read(c.id, &body, error)) return false;
+
+    *out = c;
+    out->setText(body.question, body.answer);
+    return true;
+}
+
+QString CardBodyStore::preview(const QString& s) {
+    if (s.size() <= kPreviewChars) return s;
+    // Don't split a surrogate pair.
+    const int n = s.at(kPreviewChars - 1).isHighSurrogate() ? kPreviewChars - 1 : kPreviewChars;
+    return s.left(n);
+}
+
+} // namespace rewise::storage
@@ -0,0 +1,77 @@
+#ifndef REWISE_STORAGE_CARDBODYSTORE_H
+#define REWISE_STORAGE_CARDBODYSTORE_H
+
+#include "../domain/Card.h"
+#include "../domain/Id.h"
+
+#include <QCache>
+#include <QMutex>
+#include <QString>
+
+#include <functional>
+
+namespace rewise::storage {
+
+struct CardBody final {
+    QString question;
+    QString answer;
+};
+
+// Full card text in lazy-body mode.
+//
+// The backend that loaded the cards keeps the text where it already is
+// (SqliteRepository: the `cards` rows); a lazy card holds a preview of at most
+// kPreviewChars per field and is looked up by id. A lazy card always refers to
+// the text it had when it was loaded: edits make the card resident again, and
+// the backend keeps the old body aside before overwriting or deleting a row, so
+// older snapshots (undo) still resolve.
+//
+// Reads go through a bounded LRU (cost = UTF-16 bytes). Thread-safe;
+// implementations of readBody() must be too.
+class CardBodyStore {
+public:
+    // Characters of question/answer kept resident: what the card table shows.
+    static constexpr int kPreviewChars = 120;
+
+    explicit CardBodyStore(qint64 cacheBytes = 8 * 1024 * 1024);
+    virtual ~CardBodyStore() = default;
+
+    CardBodyStore(const CardBodyStore&) = delete;
+    CardBodyStore& operator=(const CardBodyStore&) = delete;
+
+    // Full text of a lazy card (by id). `cache = false` for one-off scans (building the
+    // search index), so they don't flush the bodies that are actually in use.
+    bool read(const rewise::domain::Id& id, CardBody* out, QString* error = nullptr, bool cache = true) const;
+
+    // Streams the full text of every card that may be lazy, in the backend's
+    // order, without caching: one pass instead of a read per card (search index
+    // builds). Ids the caller doesn't know are its to skip.
+    virtual bool scan(const std::function<void(const rewise::domain::Id&, const CardBody&)>& visit,
+                      QString* error = nullptr) const = 0;
+
+    // Card with full text in *out. Cards with resident text are copied unchanged.
+    // Fails (leaving *out untouched) if the body can't be read.
+    bool resolve(const rewise::domain::Card& c, rewise::domain::Card* out, QString* error = nullptr) const;
+
+    // --- Bodies kept aside for older versions (see above) ---
+    // A version stamped with saveGeneration() when it was made may need what
+    // later saves keep aside. releaseBefore(g) drops what only versions stamped
+    // before g could read: call it when the oldest live version changes (undo
+    // history trimmed). Stores that keep nothing aside ignore both.
+    virtual quint64 saveGeneration() const { return 0; }
+    virtual void releaseBefore(quint64 generation) { Q_UNUSED(generation); }
+
+    // At most kPreviewChars UTF-16 units, never splitting a surrogate pair.
+    static QString preview(const QString& s);
+
+protected:
+    virtual bool readBody(const rewise::domain::Id& id, CardBody* out, QString* error) const = 0;
+
+private:
+    mutable QMutex m_mutex;
+    mutable QCache<rewise::domain::Id, CardBody> m_cache;
+};
+
+} // namespace rewise::storage
+
+#endif // REWISE_STORAGE_CARDBODYSTORE_H
@@ -0,0 +1,117 @@
+#include "CardStore.h"
+#include "Database.h"
+
+namespace rewise::storage {
+
+using rewise::domain::Card;
+using rewise::domain::Id;
+
+Card CardStore::CardView::toCard() const {
+    Card c;
+    if (!isValid()) return c;
+
+    c.id = id();
+    c.folderId = folderId();
+    c.question = question();
+    c.answer = answer();
+    c.createdAtMsUtc = createdAtMsUtc();
+    c.updatedAtMsUtc = updatedAtMsUtc();
+    c.textIsPreview = !hasFullText();
+    return c;
+}
+
+CardStore CardStore::fromDatabase(const Database& db) {
+    CardStore store;
+    store.reserve(db.cards.size());
+    for (int i = 0; i < db.cards.size(); ++i) store.append(db, i);
+    return store;
+}
+
+void CardStore::clear() {
+    m_ids.clear();
+    m_folderIds.clear();
+    m_createdAt.clear();
+    m_updatedAt.clear();
+    m_question.clear();
+    m_answer.clear();
+    m_preview.clear();
+    m_dead.clear();
+    m_deadCount = 0;
+    m_text.clear();
+    m_rowById.clear();
+    m_rowsByFolder.clear();
+}
+
+void CardStore::reserve(int cards) {
+    m_ids.reserve(cards);
+    m_folderIds.reserve(cards);
+    m_createdAt.reserve(cards);
+    m_updatedAt.reserve(cards);
+    m_question.reserve(cards);
+    m_answer.reserve(cards);
+    m_preview.reserve(cards);
+    m_dead.reserve(cards);
+    m_rowById.reserve(cards);
+}
+
+int CardStore::append(const Database& db, int idx) {
+    const Card& c = db.cards[idx];
+    const int row = m_ids.size();
+    m_ids.push_back(c.id);
+    m_folderIds.push_back(c.folderId);
+    m_createdAt.push_back(c.createdAtMsUtc);
+    m_updatedAt.push_back(c.updatedAtMsUtc);
+    m_question.push_back(db.questionRef(idx));
+    m_answer.push_back(db.answerRef(idx));
+    m_preview.push_back(c.textIsPreview ? 1 : 0);
+    m_dead.push_back(0);
+    m_rowsByFolder[c.folderId].push_back(row);
+    // The arena only grows: the newer one still holds every older row's text.
+    m_text = db.textArena();
+
+    const auto it = m_rowById.find(c.id);
+    if (it != m_rowById.end()) {
+        m_dead[*it] = 1;
+        ++m_deadCount;
+        *it = row;
+    } else {
+        m_rowById.insert(c.id, row);
+    }
+    return row;
+}
+
+bool CardStore::remove(const Id& id) {
+    const auto it = m_rowById.find(id);
+    if (it == m_rowById.end()) return false;
+    m_dead[*it] = 1;
+    ++m_deadCount;
+    m_rowById.erase(it);
+    return true;
+}
+
+QVector<int> CardStore::liveRows() const {
+    QVector<int> rows;
+    rows.reserve(size() - m_deadCount);
+    for (int i = 0; i < size(); ++i) {
+        if (!m_dead[i]) rows.push_back(i);
+    }
+    return rows;
+}
+
+CardStore::CardView CardStore::at(int row) const {
+    if (row < 0 || row >= size()) return {};
+    return CardView(this, row);
+}
+
+QVector<int> CardStore::rowsInFolder(const Id& folderId) const {
+    QVector<int> rows;
+    const auto it = m_rowsByFolder.constFind(folderId);
+    if (it == m_rowsByFolder.constEnd()) return rows;
+    rows.reserve(it->size());
+    for (int row : *it) {
+        if (!m_dead[row]) rows.push_back(row);
+    }
+    return rows;
+}
+
+} // namespace rewise::storage
@@ -0,0 +1,117 @@
+#ifndef REWISE_STORAGE_CARDSTORE_H
+#define REWISE_STORAGE_CARDSTORE_H
+
+#include "../domain/Card.h"
+#include "../domain/Id.h"
+#include "TextArena.h"
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+namespace rewise::storage {
+
+struct Database;
+
+// Columnar (struct-of-arrays) card table for read-heavy scans.
+//
+// Ids, folder ids and timestamps live in dense parallel arrays. Question/answer
+// are offset/length columns into the Database's UTF-8 text arena, which the
+// store shares rather than copies: the text is held once, however many
+// snapshots and stores refer to it, and is decoded only when read.
+// Rows are append-only: build a store from a Database, then filter/sort row
+// numbers over the columns. Database stays the mutable source of truth.
+// Updates append a new row for the id and retire the old one (removals just
+// retire); callers rebuild once dead rows dominate, or when the rows come from
+// a version that doesn't descend from the store's (undo).
+class CardStore final {
+public:
+    // Read-only handle to one row. Cheap to copy; valid while the store is alive
+    // and unchanged.
+    class CardView final {
+    public:
+        CardView() = default;
+
+        bool isValid() const { return m_store && m_row >= 0; }
+        int row() const { return m_row; }
+
+        const rewise::domain::Id& id() const { return m_store->m_ids[m_row]; }
+        const rewise::domain::Id& folderId() const { return m_store->m_folderIds[m_row]; }
+        qint64 createdAtMsUtc() const { return m_store->m_createdAt[m_row]; }
+        qint64 updatedAtMsUtc() const { return m_store->m_updatedAt[m_row]; }
+
+        // In lazy-body mode this is the resident preview.
+        QString question() const { return m_store->question(m_row); }
+        QString answer() const { return m_store->answer(m_row); }
+
+        bool hasFullText() const { return !m_store->m_preview[m_row]; }
+
+        // Materializes the row (lazy cards stay previews; the review schedule is
+        // not part of the store).
+        rewise::domain::Card toCard() const;
+
+    private:
+        friend class CardStore;
+        CardView(const CardStore* store, int row) : m_store(store), m_row(row) {}
+
+        const CardStore* m_store = nullptr;
+        int m_row = -1;
+    };
+
+    CardStore() = default;
+
+    // One pass over db.cards; row i corresponds to db.cards[i].
+    static CardStore fromDatabase(const Database& db);
+
+    void clear();
+    void reserve(int cards);
+    // Adds a row for db.cards[idx]; if the id already has one, that row is retired.
+    // db must be the store's database or a later version of it.
+    int append(const Database& db, int idx);
+    // Retires the id's row. Its columns stay readable until the store is rebuilt.
+    bool remove(const rewise::domain::Id& id);
+
+    // Rows ever appended, including retired ones.
+    int size() const { return m_ids.size(); }
+    bool isEmpty() const { return m_ids.isEmpty(); }
+    int deadRows() const { return m_deadCount; }
+    bool isLive(int row) const { return !m_dead[row]; }
+    bool hasFullText(int row) const { return !m_preview[row]; }
+    QVector<int> liveRows() const;
+
+    CardView at(int row) const;
+    int rowById(const rewise::domain::Id& id) const { return m_rowById.value(id, -1); }
+
+    // --- Column access (dense, row-aligned) ---
+    const QVector<rewise::domain::Id>& ids() const { return m_ids; }
+    const QVector<rewise::domain::Id>& folderIds() const { return m_folderIds; }
+    const QVector<qint64>& createdAt() const { return m_createdAt; }
+    const QVector<qint64>& updatedAt() const { return m_updatedAt; }
+
+    // Live rows whose folderId matches, in row order. O(rows ever filed in the folder).
+    QVector<int> rowsInFolder(const rewise::domain::Id& folderId) const;
+
+    // Text columns, decoded from the arena shared with the Database.
+    QString question(int row) const { return m_text.text(m_question[row]); }
+    QString answer(int row) const { return m_text.text(m_answer[row]); }
+
+private:
+
+    QVector<rewise::domain::Id> m_ids;
+    QVector<rewise::domain::Id> m_folderIds;
+    QVector<qint64> m_createdAt;
+    QVector<qint64> m_updatedAt;
+    QVector<TextArena::Ref> m_question;
+    QVector<TextArena::Ref> m_answer;
+    QVector<quint8> m_preview;      // 1 = lazy-body preview (see Card::textIsPreview)
+    QVector<quint8> m_dead;         // 1 = retired row
+    int m_deadCount = 0;
+    TextArena m_text;               // the newest Database arena appended from
+
+    QHash<rewise::domain::Id, int> m_rowById;
+    QHash<rewise::domain::Id, QVector<int>> m_rowsByFolder;  // append-only, dead rows included
+};
+
+} // namespace rewise::storage
+
+#endif // REWISE_STORAGE_CARDSTORE_H
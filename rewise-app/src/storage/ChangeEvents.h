@@ -0,0 +1,49 @@
+#ifndef REWISE_STORAGE_CHANGEEVENTS_H
+#define REWISE_STORAGE_CHANGEEVENTS_H
+
+#include "../domain/Id.h"
+
+#include <QObject>
+#include <QVector>
+
+#include <memory>
+
+namespace rewise::storage {
+
+struct Database;
+
+// One record-level change, logged by the Database mutation helpers.
+struct ChangeEvent final {
+    enum class Kind {
+        Reset,            // anything may have changed (load, undo/redo, bulk edits)
+        CardInserted,
+        CardUpdated,      // text, timestamps, folder or review state
+        CardRemoved,
+        FolderInserted,
+        FolderRenamed,
+        FolderSettingsChanged,   // review scoring settings
+        FolderRemoved
+    };
+
+    Kind kind = Kind::Reset;
+    rewise::domain::Id id;
+};
+
+using ChangeEvents = QVector<ChangeEvent>;
+
+// Fan-out point for published versions: the owner of the working Database
+// emits every new snapshot together with the events that produced it, and
+// views/indexes apply them incrementally instead of reloading everything.
+class ChangeBus final : public QObject {
+    Q_OBJECT
+public:
+    using QObject::QObject;
+
+signals:
+    void changed(const std::shared_ptr<const rewise::storage::Database>& snapshot,
+                 const rewise::storage::ChangeEvents& events);
+};
+
+} // namespace rewise::storage
+
+#endif // REWISE_STORAGE_CHANGEEVENTS_H
@@ -1,30 +1,37 @@
 #include "Database.h"
+#include "CardBodyStore.h"
 
 #include <QSet>
 #include <QHash>
 
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
 namespace rewise::storage {
 
 using rewise::domain::Id;
 using rewise::domain::Folder;
 using rewise::domain::Card;
+using rewise::domain::ReviewState;
 
 static QString normNameKey(const QString& s) {
     return s.trimmed().toLower();
 }
 
+// updatedAtMsUtc of a card re-filed now: strictly later than before, even if the
+// clock went back, so the sharded load prefers this copy (Repository::loadSharded).
+static qint64 movedAtMs(qint64 previous) {
+    return qMax(Card::nowUtcMs(), previous + 1);
+}
+
 int Database::folderIndexById(const Id& id) const {
-    for (int i = 0; i < folders.size(); ++i) {
-        if (folders[i].id == id) return i;
-    }
-    return -1;
+    return m_folderIndex.value(id, -1);
 }
 
 int Database::cardIndexById(const Id& id) const {
-    for (int i = 0; i < cards.size(); ++i) {
-        if (cards[i].id == id) return i;
-    }
-    return -1;
+    return m_cardIndex.value(id, -1);
 }
 
 const Folder* Database::folderById(const Id& id) const {
@@ -44,7 +51,477 @@ const Card* Database::cardById(const Id& id) const {
 
 Card* Database::cardById(const Id& id) {
     const int idx = cardIndexById(id);
-    return (idx >= 0) ? &cards[idx] : nullptr;
+    return (idx >= 0) ? &cards.mutableAt(idx) : nullptr;
+}
+
+QVector<int> Database::cardIndicesInFolder(const Id& folderId) const {
+    QVector<int> out;
+    const auto it = m_cardsByFolder.constFind(folderId);
+    if (it == m_cardsByFolder.constEnd()) return out;
+    out.reserve(it->size());
+    for (int idx : *it) out.push_back(idx);
+    return out;
+}
+
+int Database::cardCountInFolder(const Id& folderId) const {
+    const auto it = m_cardsByFolder.constFind(folderId);
+    return (it != m_cardsByFolder.constEnd()) ? it->size() : 0;
+}
+
+void Database::indexCardInFolder(int cardIdx) {
+    PersistentVector<int>& bucket = m_cardsByFolder[cards[cardIdx].folderId];
+    m_folderSlot.set(cardIdx, bucket.size());
+    bucket.push_back(cardIdx);
+}
+
+void Database::unindexCardInFolder(int cardIdx) {
+    const Id folderId = cards[cardIdx].folderId;
+    auto it = m_cardsByFolder.find(folderId);
+    if (it == m_cardsByFolder.end()) return;
+
+    PersistentVector<int>& bucket = *it;
+    const int slot = m_folderSlot[cardIdx];
+    const int lastCard = bucket.last();
+    bucket.set(slot, lastCard);
+    m_folderSlot.set(lastCard, slot);
+    bucket.removeLast();
+    if (bucket.isEmpty()) m_cardsByFolder.erase(it);
+}
+
+qint64 Database::dueKey(int cardIdx) const {
+    const Card& c = cards[cardIdx];
+    return c.review.dueKey(c.createdAtMsUtc);
+}
+
+void Database::placeDue(DueHeap& heap, int pos, const DueEntry& e) {
+    heap.set(pos, e);
+    m_dueSlot.set(e.card, pos);
+}
+
+void Database::siftDueUp(DueHeap& heap, int pos) {
+    const DueEntry e = heap[pos];
+    while (pos > 0) {
+        const int parent = (pos - 1) / 2;
+        const DueEntry p = heap[parent];
+        if (p.key <= e.key) break;
+        placeDue(heap, pos, p);
+        pos = parent;
+    }
+    placeDue(heap, pos, e);
+}
+
+void Database::siftDueDown(DueHeap& heap, int pos) {
+    const int n = heap.size();
+    const DueEntry e = heap[pos];
+    for (;;) {
+        int child = 2 * pos + 1;
+        if (child >= n) break;
+        if (child + 1 < n && heap[child + 1].key < heap[child].key) ++child;
+        const DueEntry c = heap[child];
+        if (e.key <= c.key) break;
+        placeDue(heap, pos, c);
+        pos = child;
+    }
+    placeDue(heap, pos, e);
+}
+
+void Database::indexDue(int cardIdx) {
+    const Id& folderId = cards[cardIdx].folderId;
+    DueHeap& heap = m_dueHeaps[folderId];
+    const DueEntry e{dueKey(cardIdx), cardIdx};
+    heap.push_back(e);
+    siftDueUp(heap, heap.size() - 1);
+
+    if (e.key <= m_dueHorizon) {
+        ++m_dueCount[folderId];
+        ++m_dueTotal;
+    }
+}
+
+void Database::unindexDue(int cardIdx) {
+    const Id folderId = cards[cardIdx].folderId;
+    auto it = m_dueHeaps.find(folderId);
+    if (it == m_dueHeaps.end()) return;
+
+    DueHeap& heap = *it;
+    const int pos = m_dueSlot[cardIdx];
+    const qint64 key = heap[pos].key;
+    const DueEntry last = heap.last();
+    heap.removeLast();
+    if (pos < heap.size()) {
+        placeDue(heap, pos, last);
+        if (last.key < key) siftDueUp(heap, pos);
+        else siftDueDown(heap, pos);
+    }
+    if (heap.isEmpty()) m_dueHeaps.erase(it);
+
+    if (key <= m_dueHorizon) {
+        auto c = m_dueCount.find(folderId);
+        if (c != m_dueCount.end() && --*c == 0) m_dueCount.erase(c);
+        --m_dueTotal;
+    }
+}
+
+void Database::recountDue() {
+    m_dueCount.clear();
+    m_dueTotal = 0;
+
+    // Only nodes with key <= horizon are visited: a later node's subtree is later still.
+    QVector<int> stack;
+    for (auto it = m_dueHeaps.cbegin(); it != m_dueHeaps.cend(); ++it) {
+        const DueHeap& heap = *it;
+        int n = 0;
+        stack.clear();
+        if (!heap.isEmpty()) stack.push_back(0);
+        while (!stack.isEmpty()) {
+            const int pos = stack.takeLast();
+            if (heap[pos].key > m_dueHorizon) continue;
+            ++n;
+            for (int child = 2 * pos + 1; child <= 2 * pos + 2 && child < heap.size(); ++child) stack.push_back(child);
+        }
+        if (n > 0) m_dueCount.insert(it.key(), n);
+        m_dueTotal += n;
+    }
+}
+
+void Database::setDueHorizon(qint64 msUtc) {
+    if (msUtc == m_dueHorizon) return;
+    m_dueHorizon = msUtc;
+    recountDue();
+}
+
+Database::DueCursor Database::dueCursor(const Id& folderId, qint64 msUtc) const {
+    DueCursor c;
+    c.m_limit = msUtc;
+    const auto it = m_dueHeaps.constFind(folderId);
+    if (it != m_dueHeaps.constEnd() && !it->isEmpty()) {
+        c.m_heap = *it;
+        c.push(0);
+    }
+    return c;
+}
+
+void Database::DueCursor::push(int pos) {
+    m_frontier.push_back({m_heap[pos].key, pos});
+    std::push_heap(m_frontier.begin(), m_frontier.end(), std::greater<Item>());
+}
+
+void Database::DueCursor::advance() {
+    if (m_frontier.empty()) return;
+    std::pop_heap(m_frontier.begin(), m_frontier.end(), std::greater<Item>());
+    const int pos = m_frontier.back().second;
+    m_frontier.pop_back();
+    for (int child = 2 * pos + 1; child <= 2 * pos + 2 && child < m_heap.size(); ++child) push(child);
+}
+
+bool Database::fullCard(int idx, Card* out, QString* error) const {
+    if (idx < 0 || idx >= cards.size()) {
+        if (error) *error = QString("Card index out of range: %1").arg(idx);
+        return false;
+    }
+    Card c = cards[idx];
+    c.question = question(idx);
+    c.answer = answer(idx);
+    if (c.hasFullText() || !m_bodies) {
+        *out = std::move(c);
+        return true;
+    }
+    return m_bodies->resolve(c, out, error);
+}
+
+Card Database::fullCard(int idx) const {
+    if (idx < 0 || idx >= cards.size()) return Card{};
+    Card out = cards[idx];
+    out.question = question(idx);
+    out.answer = answer(idx);
+    fullCard(idx, &out);
+    return out;
+}
+
+Id Database::folderIdByName(const QString& name) const {
+    return m_folderByName.value(normNameKey(name));
+}
+
+void Database::addFolder(const Folder& f) {
+    m_folderIndex.insert(f.id, folders.size());
+    m_folderByName.insert(normNameKey(f.name), f.id);
+    folders.push_back(f);
+    logEvent(ChangeEvent::Kind::FolderInserted, f.id);
+
+    m_pending.manifest = true;
+    m_pending.folders.insert(f.id);
+    m_pending.removedFolders.remove(f.id);
+}
+
+bool Database::renameFolder(const Id& id, const QString& newName) {
+    Folder* f = folderById(id);
+    if (!f) return false;
+
+    const QString oldKey = normNameKey(f->name);
+    if (m_folderByName.value(oldKey) == id) m_folderByName.remove(oldKey);
+    f->name = newName;
+    m_folderByName.insert(normNameKey(newName), id);
+    m_pending.manifest = true;
+    logEvent(ChangeEvent::Kind::FolderRenamed, id);
+    return true;
+}
+
+bool Database::setFolderScoring(const Id& id, const rewise::domain::ReviewSettings& scoring) {
+    Folder* f = folderById(id);
+    if (!f) return false;
+    if (f->scoring == scoring) return true;
+
+    f->scoring = scoring;
+    m_pending.manifest = true;
+    logEvent(ChangeEvent::Kind::FolderSettingsChanged, id);
+    return true;
+}
+
+bool Database::removeFolder(const Id& id) {
+    const int idx = folderIndexById(id);
+    if (idx < 0) return false;
+    if (cardCountInFolder(id) > 0) return false;
+
+    // Folder order is user-visible (first one is the default), so no swap-remove here.
+    const QString key = normNameKey(folders[idx].name);
+    if (m_folderByName.value(key) == id) m_folderByName.remove(key);
+
+    folders.removeAt(idx);
+    m_folderIndex.remove(id);
+    for (int i = idx; i < folders.size(); ++i) m_folderIndex[folders[i].id] = i;
+
+    m_pending.manifest = true;
+    m_pending.folders.remove(id);
+    m_pending.removedFolders.insert(id);
+    logEvent(ChangeEvent::Kind::FolderRemoved, id);
+    return true;
+}
+
+Database::TextRefs Database::internText(Card* c) {
+    const TextRefs refs{m_text.append(c->question), m_text.append(c->answer)};
+    c->question = QString();
+    c->answer = QString();
+    return refs;
+}
+
+void Database::addCard(const Card& c) {
+    const int idx = cards.size();
+    Card stored = c;
+    m_textRefs.push_back(internText(&stored));
+    cards.push_back(std::move(stored));
+    m_folderSlot.push_back(-1);
+    m_dueSlot.push_back(-1);
+    m_cardIndex.insert(c.id, idx);
+    indexCardInFolder(idx);
+    indexDue(idx);
+    m_pending.folders.insert(c.folderId);
+    m_pending.cards.insert(c.id);
+    m_pending.removedCards.remove(c.id);
+    logEvent(ChangeEvent::Kind::CardInserted, c.id);
+}
+
+bool Database::removeCard(const Id& id) {
+    const int idx = cardIndexById(id);
+    if (idx < 0) return false;
+
+    m_pending.folders.insert(cards[idx].folderId);
+    m_pending.cards.remove(id);
+    m_pending.removedCards.insert(id);
+    logEvent(ChangeEvent::Kind::CardRemoved, id);
+    unindexCardInFolder(idx);
+    unindexDue(idx);
+    m_cardIndex.remove(id);
+
+    const int last = cards.size() - 1;
+    if (idx != last) {
+        // Move the last card into the hole and patch its index entries.
+        cards.set(idx, cards[last]);
+        m_textRefs.set(idx, m_textRefs[last]);
+        m_folderSlot.set(idx, m_folderSlot[last]);
+        m_dueSlot.set(idx, m_dueSlot[last]);
+        m_cardIndex.insert(cards[idx].id, idx);
+        m_cardsByFolder[cards[idx].folderId].set(m_folderSlot[idx], idx);
+        m_dueHeaps[cards[idx].folderId].mutableAt(m_dueSlot[idx]).card = idx;
+    }
+    cards.removeLast();
+    m_textRefs.removeLast();
+    m_folderSlot.removeLast();
+    m_dueSlot.removeLast();
+    return true;
+}
+
+bool Database::moveCard(const Id& cardId, const Id& folderId) {
+    const int idx = cardIndexById(cardId);
+    if (idx < 0) return false;
+    if (cards[idx].folderId == folderId) return true;
+
+    m_pending.folders.insert(cards[idx].folderId);
+    m_pending.folders.insert(folderId);
+    m_pending.cards.insert(cardId);
+
+    unindexCardInFolder(idx);
+    unindexDue(idx);
+    Card& c = cards.mutableAt(idx);
+    c.folderId = folderId;
+    c.updatedAtMsUtc = movedAtMs(c.updatedAtMsUtc);
+    indexCardInFolder(idx);
+    indexDue(idx);
+    logEvent(ChangeEvent::Kind::CardUpdated, cardId);
+    return true;
+}
+
+bool Database::updateCard(const Card& c) {
+    const int idx = cardIndexById(c.id);
+    if (idx < 0) return false;
+
+    // Re-filed here rather than through moveCard(): one CardUpdated per edit.
+    const bool moved = cards[idx].folderId != c.folderId;
+    const qint64 previousUpdate = cards[idx].updatedAtMsUtc;
+    if (moved) {
+        m_pending.folders.insert(cards[idx].folderId);
+        unindexCardInFolder(idx);
+    }
+    unindexDue(idx);
+    Card stored = c;
+    if (!c.question.isEmpty() || !c.answer.isEmpty()) m_textRefs.set(idx, internText(&stored));
+    else stored.textIsPreview = cards[idx].textIsPreview;
+    cards.set(idx, std::move(stored));
+    if (moved) {
+        Card& filed = cards.mutableAt(idx);
+        filed.updatedAtMsUtc = qMax(filed.updatedAtMsUtc, movedAtMs(previousUpdate));
+        indexCardInFolder(idx);
+    }
+    indexDue(idx);
+    m_pending.folders.insert(c.folderId);
+    m_pending.cards.insert(c.id);
+    logEvent(ChangeEvent::Kind::CardUpdated, c.id);
+    return true;
+}
+
+bool Database::setReviewState(const Id& cardId, const ReviewState& state) {
+    const int idx = cardIndexById(cardId);
+    if (idx < 0) return false;
+
+    unindexDue(idx);
+    cards.mutableAt(idx).review = state;
+    indexDue(idx);
+    m_pending.folders.insert(cards[idx].folderId);
+    m_pending.cards.insert(cardId);
+    logEvent(ChangeEvent::Kind::CardUpdated, cardId);
+    return true;
+}
+
+void Database::adoptReviewStates(const Database& other) {
+    // Collect first: setReviewState() rewrites the nodes the diff walks.
+    QVector<int> differing;
+    other.cards.forEachDifference(cards, [&](int i) {
+        if (i < other.cards.size()) differing.push_back(i);
+    });
+
+    for (int i : differing) {
+        const Card& theirs = other.cards[i];
+        const int idx = cardIndexById(theirs.id);
+        if (idx >= 0 && cards[idx].review != theirs.review) setReviewState(theirs.id, theirs.review);
+    }
+}
+
+void Database::logEvent(ChangeEvent::Kind kind, const Id& id) {
+    // Once a Reset is queued, finer events add nothing.
+    if (!m_events.isEmpty() && m_events.last().kind == ChangeEvent::Kind::Reset) return;
+    if (kind == ChangeEvent::Kind::Reset) m_events.clear();
+    m_events.push_back(ChangeEvent{kind, id});
+}
+
+ChangeEvents Database::takeChangeEvents() {
+    ChangeEvents out;
+    out.swap(m_events);
+    return out;
+}
+
+void Database::markAllPending() {
+    m_pending.everything = true;
+    m_pending.manifest = true;
+}
+
+void Database::rebuildNameIndex() {
+    m_folderByName.clear();
+    m_folderByName.reserve(folders.size());
+    for (const Folder& f : folders) m_folderByName.insert(normNameKey(f.name), f.id);
+}
+
+void Database::rebuildIndexes() {
+    m_folderIndex.clear();
+    m_folderIndex.reserve(folders.size());
+    for (int i = 0; i < folders.size(); ++i) m_folderIndex.insert(folders[i].id, i);
+    rebuildNameIndex();
+
+    m_cardIndex.clear();
+    m_cardsByFolder.clear();
+    m_folderSlot.clear();
+    m_dueHeaps.clear();
+    m_dueSlot.clear();
+    m_textRefs.clear();
+    m_text.clear();
+    for (int i = 0; i < cards.size(); ++i) {
+        m_folderSlot.push_back(-1);
+        m_dueSlot.push_back(-1);
+        m_textRefs.push_back(internText(&cards.mutableAt(i)));
+    }
+    for (int i = 0; i < cards.size(); ++i) {
+        m_cardIndex.insert(cards[i].id, i);
+        indexCardInFolder(i);
+
+        DueHeap& heap = m_dueHeaps[cards[i].folderId];
+        m_dueSlot.set(i, heap.size());
+        heap.push_back(DueEntry{dueKey(i), i});
+    }
+    // Bottom-up heapify: O(n) overall, cheaper than n pushes.
+    for (auto it = m_dueHeaps.begin(); it != m_dueHeaps.end(); ++it) {
+        for (int pos = it->size() / 2 - 1; pos >= 0; --pos) siftDueDown(*it, pos);
+    }
+    recountDue();
+    logEvent(ChangeEvent::Kind::Reset);
+}
+
+void Database::inheritPendingChanges(const Database& current) {
+    PendingChanges p = current.m_pending;
+
+    // Folders: few, compare directly.
+    bool foldersChanged = folders.size() != current.folders.size();
+    for (int i = 0; i < folders.size() && !foldersChanged; ++i) {
+        foldersChanged = folders[i].id != current.folders[i].id || folders[i].name != current.folders[i].name
+                         || folders[i].scoring != current.folders[i].scoring;
+    }
+    if (foldersChanged) p.manifest = true;
+
+    // Cards: only slots outside shared subtrees can differ.
+    QSet<Id> touched = p.cards + p.removedCards;
+    cards.forEachDifference(current.cards, [&](int i) {
+        if (i < cards.size()) {
+            touched.insert(cards[i].id);
+            p.folders.insert(cards[i].folderId);
+        }
+        if (i < current.cards.size()) {
+            touched.insert(current.cards[i].id);
+            p.folders.insert(current.cards[i].folderId);
+        }
+    });
+
+    // Normalize against this version: what exists is upserted, the rest removed.
+    p.cards.clear();
+    p.removedCards.clear();
+    for (const Id& id : touched) {
+        if (cardIndexById(id) >= 0) p.cards.insert(id);
+        else p.removedCards.insert(id);
+    }
+
+    for (const Folder& f : current.folders) {
+        if (folderIndexById(f.id) < 0) p.removedFolders.insert(f.id);
+    }
+    for (const Folder& f : folders) p.removedFolders.remove(f.id);
+    for (const Id& id : p.removedFolders) p.folders.remove(id);
+
+    m_pending = std::move(p);
 }
 
 Id Database::ensureDefaultFolder(const QString& defaultName) {
@@ -57,7 +534,7 @@ Id Database::ensureDefaultFolder(const QString& defaultName) {
     f.id = Id::create();
     f.name = defaultName.trimmed().isEmpty() ? QString("Default") : defaultName.trimmed();
 
-    folders.push_back(f);
+    addFolder(f);
     return f.id;
 }
 
@@ -98,61 +575,113 @@ bool Database::ensureUniqueFolderNames() {
         changed = true;
     }
 
+    if (changed) {
+        rebuildNameIndex();
+        m_pending.manifest = true;
+        logEvent(ChangeEvent::Kind::Reset);
+    }
     return changed;
 }
 
+QString Database::uniqueFolderName(const QString& base, const Id& self) const {
+    const QString trimmed = base.trimmed();
+
+    auto isFree = [&](const QString& name) {
+        const Id owner = folderIdByName(name);
+        return !owner.isValid() || owner == self;
+    };
+
+    if (isFree(trimmed)) return trimmed;
+
+    for (int suffix = 2;; ++suffix) {
+        const QString candidate = QString("%1 (%2)").arg(trimmed).arg(suffix);
+        if (isFree(candidate)) return candidate;
+    }
+}
+
+bool Database::checkFolder(const Folder& f, QString* error) const {
+    QString why;
+    if (!f.isValid(&why)) {
+        if (error) *error = QString("Invalid folder: %1").arg(why);
+        return false;
+    }
+
+    const Id owner = folderIdByName(f.name);
+    if (owner.isValid() && owner != f.id) {
+        if (error) *error = "Folder name already taken: " + f.name.trimmed();
+        return false;
+    }
+    return true;
+}
+
+bool Database::checkCard(const Card& c, QString* error) const {
+    QString why;
+    if (!c.isValid(&why)) {
+        if (error) *error = QString("Invalid card: %1").arg(why);
+        return false;
+    }
+
+    if (folderIndexById(c.folderId) < 0) {
+        if (error) *error = "Card references missing folderId: " + c.folderId.toString();
+        return false;
+    }
+    return true;
+}
+
 bool Database::validate(QString* error) const {
     if (version != json_keys::kSchemaVersion) {
         if (error) *error = QString("Unsupported DB schema version: %1").arg(version);
         return false;
     }
 
-    // Folder ids unique
-    {
-        QSet<QString> ids;
-        for (const Folder& f : folders) {
-            QString why;
-            if (!f.isValid(&why)) {
-                if (error) *error = QString("Invalid folder: %1").arg(why);
-                return false;
-            }
-            const QString idStr = f.id.toString();
-            if (ids.contains(idStr)) {
-                if (error) *error = "Duplicate folder id: " + idStr;
-                return false;
-            }
-            ids.insert(idStr);
+    // Folder ids unique (binary ids: no string conversion per record)
+    QSet<Id> folderIds;
+    folderIds.reserve(folders.size());
+    for (const Folder& f : folders) {
+        QString why;
+        if (!f.isValid(&why)) {
+            if (error) *error = QString("Invalid folder: %1").arg(why);
+            return false;
         }
+        if (folderIds.contains(f.id)) {
+            if (error) *error = "Duplicate folder id: " + f.id.toString();
+            return false;
+        }
+        folderIds.insert(f.id);
     }
 
     // Card ids unique + folderId exists
-    {
-        QSet<QString> cardIds;
-        QSet<QString> folderIds;
-        folderIds.reserve(folders.size());
-        for (const Folder& f : folders) folderIds.insert(f.id.toString());
-
-        for (const Card& c : cards) {
-            QString why;
-            if (!c.isValid(&why)) {
-                if (error) *error = QString("Invalid card: %1").arg(why);
-                return false;
-            }
+    QSet<Id> cardIds;
+    cardIds.reserve(cards.size());
+    for (int i = 0; i < cards.size(); ++i) {
+        Card c = cards[i];
+        c.question = question(i);
+        c.answer = answer(i);
+        QString why;
+        if (!c.isValid(&why)) {
+            if (error) *error = QString("Invalid card: %1").arg(why);
+            return false;
+        }
 
-            const QString cid = c.id.toString();
-            if (cardIds.contains(cid)) {
-                if (error) *error = "Duplicate card id: " + cid;
-                return false;
-            }
-            cardIds.insert(cid);
+        if (cardIds.contains(c.id)) {
+            if (error) *error = "Duplicate card id: " + c.id.toString();
+            return false;
+        }
+        cardIds.insert(c.id);
 
-            if (!folderIds.contains(c.folderId.toString())) {
-                if (error) *error = "Card references missing folderId: " + c.folderId.toString();
-                return false;
-            }
+        if (!folderIds.contains(c.folderId)) {
+            if (error) *error = "Card references missing folderId: " + c.folderId.toString();
+            return false;
         }
     }
 
+    // Indexes agree with the vectors (catches direct edits that skipped the helpers).
+    if (m_folderIndex.size() != folders.size() || m_cardIndex.size() != cards.size()
+        || m_dueSlot.size() != cards.size() || m_textRefs.size() != cards.size()) {
+        if (error) *error = "Database indexes are out of sync.";
+        return false;
+    }
+
     return true;
 }
 
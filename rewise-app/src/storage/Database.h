@@ -3,20 +3,60 @@
 
 #include "../domain/Card.h"
 #include "../domain/Folder.h"
+#include "ChangeEvents.h"
+#include "PersistentHash.h"
+#include "PersistentVector.h"
 #include "StorageJson.h"
+#include "TextArena.h"
 
+#include <QHash>
+#include <QSet>
 #include <QVector>
 #include <QString>
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 namespace rewise::storage {
 
+class CardBodyStore;
+
+// What changed since the last successful save. Backends pick the granularity
+// they persist at: Repository rewrites whole folder shards, SqliteRepository
+// upserts/deletes single rows.
+struct PendingChanges final {
+    bool everything = false;                      // full rewrite (new store, migration)
+    bool manifest = false;                        // folder list, order or names
+    QSet<rewise::domain::Id> folders;             // folders whose cards changed
+    QSet<rewise::domain::Id> removedFolders;
+    QSet<rewise::domain::Id> cards;               // added or modified cards
+    QSet<rewise::domain::Id> removedCards;
+
+    bool isEmpty() const {
+        return !everything && !manifest && folders.isEmpty() && removedFolders.isEmpty()
+               && cards.isEmpty() && removedCards.isEmpty();
+    }
+};
+
 struct Database final {
     int version = json_keys::kSchemaVersion;
 
+    // Read freely; structural changes (add/remove, id/folderId/review edits, renames)
+    // must go through the mutation helpers below, or be followed by rebuildIndexes().
+    // Card order is not meaningful: removeCard() swap-removes.
+    //
+    // Cards and the card indexes are persistent (structurally shared) containers:
+    // copying a Database is O(folders), and a mutation of one copy costs
+    // O(log n) instead of detaching everything. See DatabaseSnapshot.
+    //
+    // Card text is not kept in `cards`: question/answer live once, as UTF-8, in
+    // the database's text arena (shared by snapshots and CardStore). Cards read
+    // from `cards` have empty text; use question()/answer() or fullCard().
     QVector<rewise::domain::Folder> folders;
-    QVector<rewise::domain::Card> cards;
+    PersistentVector<rewise::domain::Card> cards;
 
-    // --- Lookup helpers ---
+    // --- Lookup helpers (O(1), hash indexes keyed on the binary UUID) ---
     int folderIndexById(const rewise::domain::Id& id) const;
     int cardIndexById(const rewise::domain::Id& id) const;
 
@@ -26,10 +66,111 @@ struct Database final {
     const rewise::domain::Card* cardById(const rewise::domain::Id& id) const;
     rewise::domain::Card* cardById(const rewise::domain::Id& id);
 
+    // Indices into `cards` for one folder (unordered). Empty for unknown folders. O(folder size).
+    QVector<int> cardIndicesInFolder(const rewise::domain::Id& folderId) const;
+    int cardCountInFolder(const rewise::domain::Id& folderId) const;
+
+    // Text held in memory for cards[idx] (the preview for a lazy card). Decodes.
+    QString question(int idx) const { return m_text.text(m_textRefs[idx].question); }
+    QString answer(int idx) const { return m_text.text(m_textRefs[idx].answer); }
+    // Slices of textArena() for cards[idx], for readers that decode on demand.
+    TextArena::Ref questionRef(int idx) const { return m_textRefs[idx].question; }
+    TextArena::Ref answerRef(int idx) const { return m_textRefs[idx].answer; }
+    const TextArena& textArena() const { return m_text; }
+
+    // --- Lazy bodies (optional) ---
+    // Set by a backend that loads lazy cards (preview text only, see Card::textIsPreview).
+    // Cards added or edited afterwards keep their text resident. Copies share the store.
+    void setBodyStore(std::shared_ptr<CardBodyStore> store) { m_bodies = std::move(store); }
+    bool hasLazyBodies() const { return m_bodies != nullptr; }
+    std::shared_ptr<CardBodyStore> bodyStore() const { return m_bodies; }
+
+    // Card with its full question/answer (from the arena, or paged in through
+    // the store's LRU for a lazy card).
+    // Use this instead of `cards[idx]` wherever the full text matters:
+    // editing, review, serialization. Fails only if the body can't be read.
+    bool fullCard(int idx, rewise::domain::Card* out, QString* error = nullptr) const;
+    // UI convenience: falls back to the preview on read failure. Invalid Card for a bad index.
+    rewise::domain::Card fullCard(int idx) const;
+
+    // Case-insensitive name lookup (trimmed). Invalid Id if no such folder.
+    rewise::domain::Id folderIdByName(const QString& name) const;
+
+    // --- Mutations (keep indexes in sync) ---
+    void addFolder(const rewise::domain::Folder& f);
+    bool renameFolder(const rewise::domain::Id& id, const QString& newName);
+    // How answers in the folder are scored. O(1).
+    bool setFolderScoring(const rewise::domain::Id& id, const rewise::domain::ReviewSettings& scoring);
+    // O(folders). Cards of the folder must be moved away first; returns false otherwise.
+    bool removeFolder(const rewise::domain::Id& id);
+
+    // Cards passed in carry their text; it is moved into the arena.
+    void addCard(const rewise::domain::Card& c);
+    // O(1): swaps the last card into the freed slot.
+    bool removeCard(const rewise::domain::Id& id);
+    // Re-files a card and bumps its updatedAtMsUtc (a copy left in the old
+    // folder's shard by an interrupted save then loses to this one).
+    bool moveCard(const rewise::domain::Id& cardId, const rewise::domain::Id& folderId);
+    // Replaces the card with the same id (moving it if folderId differs, which
+    // bumps updatedAtMsUtc like moveCard). A card without text (as read from
+    // `cards`) keeps the text it has.
+    bool updateCard(const rewise::domain::Card& c);
+    // Records a new schedule for the card (after a check). O(log n).
+    bool setReviewState(const rewise::domain::Id& cardId, const rewise::domain::ReviewState& state);
+    // Takes the schedule of every card that differs from `other` and exists in both
+    // (e.g. keep review progress across undo). Cost proportional to the difference.
+    void adoptReviewStates(const Database& other);
+
+    // --- Review schedule (maintained by the mutation helpers) ---
+    // Each folder keeps its cards in a min-heap on ReviewState::dueKey(), so the
+    // next due card is at the top and reschedules cost O(log n). The heaps are
+    // filled by rebuildIndexes() in the pass loading makes anyway (heapify, O(n)).
+    // Per-folder counts of cards due at or before the horizon are kept alongside.
+    qint64 dueHorizon() const { return m_dueHorizon; }
+    // Usually the end of today. Recounts in O(cards due by then + folders).
+    void setDueHorizon(qint64 msUtc);
+    int dueCountInFolder(const rewise::domain::Id& folderId) const { return m_dueCount.value(folderId, 0); } // O(1)
+    int dueCount() const { return m_dueTotal; }                                                             // O(1)
+    // Cards of the folder due at or before `msUtc`, earliest first, one at a time
+    // (see DueCursor). O(1) to create, O(k log k) for k cards.
+    class DueCursor;
+    DueCursor dueCursor(const rewise::domain::Id& folderId, qint64 msUtc) const;
+
+    // --- Change tracking (maintained by the mutation helpers) ---
+    const PendingChanges& pendingChanges() const { return m_pending; }
+    void clearPendingChanges() { m_pending = {}; }
+    // Everything is dirty (e.g. first save in a new layout).
+    void markAllPending();
+
+    // --- Change events (logged by the mutation helpers, drained by the publisher) ---
+    const ChangeEvents& changeEvents() const { return m_events; }
+    ChangeEvents takeChangeEvents();
+
+    // Recomputes all indexes from `folders`/`cards` (after bulk edits or parsing).
+    // Every card must carry its text, as parsed: it is moved into a new arena.
+    void rebuildIndexes();
+
+    // Replaces the pending changes with what a save needs after switching from
+    // `current` to this version (undo/redo): everything `current` had not saved
+    // yet plus every record that differs between the two. Cost is proportional
+    // to the difference, thanks to structural sharing.
+    void inheritPendingChanges(const Database& current);
+
     // Ensures there is at least one folder. Returns the default folder id.
     rewise::domain::Id ensureDefaultFolder(const QString& defaultName = "Default");
 
-    // Validation: checks basic invariants.
+    // --- Incremental checks (only the touched record, against the indexes) ---
+    // Run these before a mutation; the rest of the DB is assumed valid.
+    // - folder valid, name not taken by another folder
+    bool checkFolder(const rewise::domain::Folder& f, QString* error = nullptr) const;
+    // - card valid, folderId exists
+    bool checkCard(const rewise::domain::Card& c, QString* error = nullptr) const;
+
+    // Returns `base` (trimmed) or the first free "base (2)", "base (3)", ... variant.
+    // A folder may keep its own name: pass its id as `self`.
+    QString uniqueFolderName(const QString& base, const rewise::domain::Id& self = {}) const;
+
+    // Full validation ("fsck"): checks every record. Used on load and on explicit request.
     // - schema version supported
     // - folder ids unique & names non-empty
     // - card ids unique
@@ -37,10 +178,93 @@ struct Database final {
     bool validate(QString* error = nullptr) const;
 
     // Convenience: make folder names unique (case-insensitive) by appending " (2)", " (3)", etc.
-    // Returns true if any changes were made.
+    // Full pass, meant for loading. Returns true if any changes were made.
     bool ensureUniqueFolderNames();
+
+private:
+    void indexCardInFolder(int cardIdx);
+    void unindexCardInFolder(int cardIdx);
+    void indexDue(int cardIdx);
+    void unindexDue(int cardIdx);
+    qint64 dueKey(int cardIdx) const;
+    void recountDue();
+    void rebuildNameIndex();
+    void logEvent(ChangeEvent::Kind kind, const rewise::domain::Id& id = {});
+
+    struct TextRefs final {
+        TextArena::Ref question;
+        TextArena::Ref answer;
+    };
+    // Appends c's text to the arena and strips it from c.
+    TextRefs internText(rewise::domain::Card* c);
+
+    using CardIndex = PersistentHash<rewise::domain::Id, int, rewise::domain::IdHash>;
+
+    // Folder-sized indexes are plain Qt containers; card-sized ones are persistent.
+    QHash<rewise::domain::Id, int> m_folderIndex;                       // folder id -> index in folders
+    QHash<QString, rewise::domain::Id> m_folderByName;                  // normalized name -> folder id
+    CardIndex m_cardIndex;                                              // card id   -> index in cards
+    QHash<rewise::domain::Id, PersistentVector<int>> m_cardsByFolder;   // folder id -> card indices
+    PersistentVector<int> m_folderSlot;                                 // card index -> position in its folder bucket
+    PersistentVector<TextRefs> m_textRefs;                              // card index -> its text in m_text
+    TextArena m_text;
+
+    // Heap entries carry their key, so sifting never looks up a card.
+    struct DueEntry final {
+        qint64 key = 0;
+        int card = -1;
+    };
+    using DueHeap = PersistentVector<DueEntry>;
+    void siftDueUp(DueHeap& heap, int pos);
+    void siftDueDown(DueHeap& heap, int pos);
+    void placeDue(DueHeap& heap, int pos, const DueEntry& e);
+
+    QHash<rewise::domain::Id, DueHeap> m_dueHeaps;                      // folder id -> min-heap on due key
+    PersistentVector<int> m_dueSlot;                                    // card index -> position in its folder heap
+    QHash<rewise::domain::Id, int> m_dueCount;                          // folder id -> cards with key <= horizon
+    int m_dueTotal = 0;
+    qint64 m_dueHorizon = 0;
+
+    PendingChanges m_pending;
+    ChangeEvents m_events;
+    std::shared_ptr<CardBodyStore> m_bodies;                   // null unless lazy bodies are on
 };
 
+// Lazy earliest-first walk over one folder's due heap: a heap node enters the
+// frontier once its parent has been output, so taking k cards costs O(k log k)
+// however large the folder is. The cursor shares the heap (structurally), so it
+// stays valid after the database changes and reads the version it was made from.
+class Database::DueCursor final {
+public:
+    DueCursor() = default;
+
+    bool atEnd() const { return m_frontier.empty() || m_frontier.front().first > m_limit; }
+    // Current card; only valid while !atEnd().
+    qint64 key() const { return m_frontier.front().first; }
+    int card() const { return m_heap[m_frontier.front().second].card; }
+    void advance();
+
+private:
+    friend class Database;
+    using Item = std::pair<qint64, int>; // key, heap position
+
+    void push(int pos);
+
+    DueHeap m_heap;
+    qint64 m_limit = 0;
+    std::vector<Item> m_frontier;        // min-heap (std::greater)
+};
+
+// Immutable, reference-counted version of the database shared by every reader
+// (library page, card table). Publishing one is O(folders): card storage is
+// structurally shared with the live Database, which keeps mutating its own copy.
+// Old snapshots stay valid, so undo/redo history is nearly free.
+using DatabaseSnapshot = std::shared_ptr<const Database>;
+
+inline DatabaseSnapshot makeSnapshot(const Database& db) {
+    return std::make_shared<const Database>(db);
+}
+
 } // namespace rewise::storage
 
 #endif // REWISE_STORAGE_DATABASE_H
@@ -0,0 +1,150 @@
+#include "FuzzySearch.h"
+
+#include "TextIndex.h"
+#include "../review/Levenshtein.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace rewise::storage {
+
+namespace {
+
+QVector<QString> uniqueWords(const QString& text) {
+    QVector<QString> words = TextIndex::tokenize(TextIndex::fold(text));
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+    return words;
+}
+
+void unionInto(QVector<int>* rows, const QVector<int>& more) {
+    QVector<int> merged;
+    merged.reserve(rows->size() + more.size());
+    std::set_union(rows->begin(), rows->end(), more.begin(), more.end(), std::back_inserter(merged));
+    rows->swap(merged);
+}
+
+} // namespace
+
+FuzzySearch::FuzzySearch(const QString& query)
+    : m_tokens(uniqueWords(query))
+{}
+
+int FuzzySearch::maxEdits(int wordLength) {
+    if (wordLength < 3) return 0;
+    return (wordLength < 6) ? 1 : 2;
+}
+
+int FuzzySearch::wordCost(int token, const QString& word) const {
+    const QString& t = m_tokens[token];
+    if (word == t) return 0;
+    if (word.startsWith(t)) return 1;
+
+    const int k = maxEdits(t.size());
+    if (k == 0) return -1;
+    const int d = rewise::review::Levenshtein::boundedDistance(t, word, k);
+    return (d <= k) ? 1 + 2 * d : -1;
+}
+
+QVector<int> FuzzySearch::prepare(const TextIndex& index) {
+    m_costs = QVector<QHash<QString, int>>(m_tokens.size());
+    m_vocabSize = index.vocabularySize();
+
+    QVector<QVector<int>> tokenRows;
+    tokenRows.reserve(m_tokens.size());
+
+    for (int t = 0; t < m_tokens.size(); ++t) {
+        const QString& token = m_tokens[t];
+        QHash<QString, int>& costs = m_costs[t];
+        QVector<int> rows;
+
+        auto take = [&](int wordId, int cost) {
+            const QString& w = index.word(wordId);
+            const auto it = costs.constFind(w);
+            if (it != costs.constEnd()) {
+                if (cost < *it) costs.insert(w, cost);
+                return;
+            }
+            costs.insert(w, cost);
+            unionInto(&rows, index.wordRows(wordId));
+        };
+
+        // Exact and prefix matches first: a word found both ways keeps the lower cost.
+        for (int id : index.wordsWithPrefix(token)) take(id, index.word(id).size() == token.size() ? 0 : 1);
+
+        const int k = maxEdits(token.size());
+        if (k > 0) {
+            for (int id : index.wordsNear(token, k)) {
+                const int d = rewise::review::Levenshtein::boundedDistance(token, index.word(id), k);
+                if (d <= k) take(id, 1 + 2 * d);
+            }
+        }
+
+        if (rows.isEmpty()) return {}; // this word matches nothing: neither does the query
+        tokenRows.push_back(std::move(rows));
+    }
+
+    if (tokenRows.isEmpty()) return {};
+
+    // Rarest first keeps the intermediate results small.
+    std::sort(tokenRows.begin(), tokenRows.end(),
+              [](const QVector<int>& a, const QVector<int>& b) { return a.size() < b.size(); });
+    QVector<int> out = tokenRows.first();
+    for (int i = 1; i < tokenRows.size() && !out.isEmpty(); ++i) {
+        QVector<int> next;
+        std::set_intersection(out.begin(), out.end(), tokenRows[i].begin(), tokenRows[i].end(),
+                              std::back_inserter(next));
+        out.swap(next);
+    }
+    return out;
+}
+
+int FuzzySearch::lookupCost(const TextIndex& index, int token, const QString& word) const {
+    if (token < m_costs.size()) {
+        const auto it = m_costs[token].constFind(word);
+        if (it != m_costs[token].constEnd()) return *it;
+
+        // Known to the index when prepared and not among the matches: no match.
+        const int id = index.wordId(word);
+        if (id >= 0 && id < m_vocabSize) return -1;
+    }
+    return wordCost(token, word);
+}
+
+int FuzzySearch::fieldCost(const TextIndex& index, int token, const QVector<QString>& words) const {
+    int best = -1;
+    for (const QString& w : words) {
+        const int c = lookupCost(index, token, w);
+        if (c >= 0 && (best < 0 || c < best)) best = c;
+        if (best == 0) break;
+    }
+    return best;
+}
+
+int FuzzySearch::score(const TextIndex& index, const QString& question, const QString& answer) const {
+    if (m_tokens.isEmpty()) return -1;
+
+    const QVector<QString> qWords = uniqueWords(question);
+    QVector<QString> aWords; // split only if some query word is missing from the question
+    bool aSplit = false;
+
+    int answerOnly = 0;
+    int cost = 0;
+    for (int t = 0; t < m_tokens.size(); ++t) {
+        int c = fieldCost(index, t, qWords);
+        if (c < 0) {
+            if (!aSplit) {
+                aWords = uniqueWords(answer);
+                aSplit = true;
+            }
+            c = fieldCost(index, t, aWords);
+            if (c < 0) return -1;
+            ++answerOnly;
+        }
+        cost += c;
+    }
+    // Lexicographic (answer-only words, cost) as one int.
+    return answerOnly * kAnswerRank + qMin(cost, kAnswerRank - 1);
+}
+
+} // namespace rewise::storage
@@ -0,0 +1,56 @@
+#ifndef REWISE_STORAGE_FUZZYSEARCH_H
+#define REWISE_STORAGE_FUZZYSEARCH_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+namespace rewise::storage {
+
+class TextIndex;
+
+// Typo-tolerant word search over a TextIndex.
+//
+// The query is split into words; a card matches when every query word matches
+// some word of the card exactly, as a prefix, or within a few edits (1 for
+// 3-5 characters, 2 from 6 on). Candidates come from the index (vocabulary
+// trigrams), and only those words are checked with a bounded edit distance.
+//
+// score() ranks a match: lower is better. Matches are ordered by how many
+// query words were found only in the answer, then by edit cost (per query
+// word: exact 0 < prefix 1 < one edit 3 < two edits 5). A card with every
+// word in its question outranks one with any word only in the answer,
+// however many typos it takes.
+class FuzzySearch final {
+public:
+    // Weight of one answer-only word in score(): above any edit cost total.
+    static constexpr int kAnswerRank = 1 << 16;
+
+    explicit FuzzySearch(const QString& query = QString());
+
+    bool isEmpty() const { return m_tokens.isEmpty(); }
+
+    static int maxEdits(int wordLength);
+
+    // Looks the query words up in `index` and returns the ascending rows that
+    // match all of them (rows still need score() for ranking). Keeps the
+    // per-word matches, so score() on those rows costs hash lookups only.
+    QVector<int> prepare(const TextIndex& index);
+
+    // -1 if the card doesn't match. Words the index didn't know at prepare()
+    // time (cards added since) are checked directly.
+    int score(const TextIndex& index, const QString& question, const QString& answer) const;
+
+private:
+    int wordCost(int token, const QString& word) const;  // direct check, -1 = no match
+    int lookupCost(const TextIndex& index, int token, const QString& word) const;
+    int fieldCost(const TextIndex& index, int token, const QVector<QString>& words) const;
+
+    QVector<QString> m_tokens;             // folded, unique
+    QVector<QHash<QString, int>> m_costs;  // per token: matching vocabulary word -> cost
+    int m_vocabSize = 0;                   // index vocabulary covered by m_costs
+};
+
+} // namespace rewise::storage
+
+#endif // REWISE_STORAGE_FUZZYSEARCH_H
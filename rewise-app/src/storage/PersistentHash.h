@@ -0,0 +1,189 @@
+#ifndef REWISE_STORAGE_PERSISTENTHASH_H
+#define REWISE_STORAGE_PERSISTENTHASH_H
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace rewise::storage {
+
+// Hash map with structural sharing (hash array mapped trie, 32-way).
+//
+// Same sharing rules as PersistentVector: O(1) copies, O(log32 n) path-copying
+// writes, in-place writes for nodes this map owns alone. `Hasher` returns a
+// 32-bit hash (e.g. a qHash wrapper); full collisions fall back to a list.
+template <typename K, typename V, typename Hasher>
+class PersistentHash final {
+    static constexpr int kBits = 5;
+    static constexpr std::uint32_t kMask = (1u << kBits) - 1;
+    static constexpr int kMaxShift = 30; // 7 levels cover 32 hash bits
+
+    struct Node final {
+        std::uint32_t dataMap = 0;                // bit -> entry in `entries`
+        std::uint32_t nodeMap = 0;                // bit -> child in `children`
+        std::vector<std::pair<K, V>> entries;     // collision nodes: all entries, maps unused
+        std::vector<std::shared_ptr<Node>> children;
+    };
+    using NodePtr = std::shared_ptr<Node>;
+
+public:
+    PersistentHash() = default;
+
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    const V* find(const K& key) const {
+        const Node* node = m_root.get();
+        const std::uint32_t h = hashOf(key);
+        for (int shift = 0; node; shift += kBits) {
+            if (shift > kMaxShift) {
+                for (const auto& e : node->entries) {
+                    if (e.first == key) return &e.second;
+                }
+                return nullptr;
+            }
+            const std::uint32_t bit = bitFor(h, shift);
+            if (node->dataMap & bit) {
+                const auto& e = node->entries[slot(node->dataMap, bit)];
+                return (e.first == key) ? &e.second : nullptr;
+            }
+            if (!(node->nodeMap & bit)) return nullptr;
+            node = node->children[slot(node->nodeMap, bit)].get();
+        }
+        return nullptr;
+    }
+
+    V value(const K& key, const V& defaultValue = V()) const {
+        const V* v = find(key);
+        return v ? *v : defaultValue;
+    }
+    bool contains(const K& key) const { return find(key) != nullptr; }
+
+    void insert(const K& key, V value) {
+        if (!m_root) m_root = std::make_shared<Node>();
+        if (insertAt(m_root, key, std::move(value), hashOf(key), 0)) ++m_size;
+    }
+
+    bool remove(const K& key) {
+        // Look first, so a miss copies nothing.
+        if (!contains(key)) return false;
+        removeAt(m_root, key, hashOf(key), 0);
+        --m_size;
+        if (m_size == 0) m_root.reset();
+        return true;
+    }
+
+    void clear() {
+        m_root.reset();
+        m_size = 0;
+    }
+
+    // No-op; kept for QHash-compatible call sites.
+    void reserve(int) {}
+
+private:
+    static std::uint32_t hashOf(const K& key) { return static_cast<std::uint32_t>(Hasher{}(key)); }
+    static std::uint32_t bitFor(std::uint32_t h, int shift) { return 1u << ((h >> shift) & kMask); }
+    static int slot(std::uint32_t map, std::uint32_t bit) { return popcount(map & (bit - 1)); }
+
+    static int popcount(std::uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcount(x);
+#else
+        x = x - ((x >> 1) & 0x55555555u);
+        x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+        return static_cast<int>((((x + (x >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+#endif
+    }
+
+    static Node* unshare(NodePtr& p) {
+        if (p.use_count() > 1) p = std::make_shared<Node>(*p);
+        return p.get();
+    }
+
+    // Returns true if a new key was added (false: value replaced).
+    static bool insertAt(NodePtr& p, const K& key, V&& value, std::uint32_t h, int shift) {
+        Node* node = unshare(p);
+
+        if (shift > kMaxShift) {
+            for (auto& e : node->entries) {
+                if (e.first == key) {
+                    e.second = std::move(value);
+                    return false;
+                }
+            }
+            node->entries.emplace_back(key, std::move(value));
+            return true;
+        }
+
+        const std::uint32_t bit = bitFor(h, shift);
+        if (node->nodeMap & bit) {
+            return insertAt(node->children[slot(node->nodeMap, bit)], key, std::move(value), h, shift + kBits);
+        }
+
+        if (!(node->dataMap & bit)) {
+            node->entries.insert(node->entries.begin() + slot(node->dataMap, bit), {key, std::move(value)});
+            node->dataMap |= bit;
+            return true;
+        }
+
+        const int di = slot(node->dataMap, bit);
+        if (node->entries[di].first == key) {
+            node->entries[di].second = std::move(value);
+            return false;
+        }
+
+        // Two keys in one slot: push both one level down.
+        auto child = std::make_shared<Node>();
+        std::pair<K, V> existing = std::move(node->entries[di]);
+        node->entries.erase(node->entries.begin() + di);
+        node->dataMap &= ~bit;
+
+        const std::uint32_t eh = hashOf(existing.first);
+        insertAt(child, existing.first, std::move(existing.second), eh, shift + kBits);
+        insertAt(child, key, std::move(value), h, shift + kBits);
+
+        node->children.insert(node->children.begin() + slot(node->nodeMap, bit), std::move(child));
+        node->nodeMap |= bit;
+        return true;
+    }
+
+    // `key` is known to be present.
+    static void removeAt(NodePtr& p, const K& key, std::uint32_t h, int shift) {
+        Node* node = unshare(p);
+
+        if (shift > kMaxShift) {
+            for (auto it = node->entries.begin(); it != node->entries.end(); ++it) {
+                if (it->first == key) {
+                    node->entries.erase(it);
+                    return;
+                }
+            }
+            return;
+        }
+
+        const std::uint32_t bit = bitFor(h, shift);
+        if (node->dataMap & bit) {
+            node->entries.erase(node->entries.begin() + slot(node->dataMap, bit));
+            node->dataMap &= ~bit;
+            return;
+        }
+
+        const int ci = slot(node->nodeMap, bit);
+        removeAt(node->children[ci], key, h, shift + kBits);
+
+        const Node* child = node->children[ci].get();
+        if (child->entries.empty() && child->children.empty()) {
+            node->children.erase(node->children.begin() + ci);
+            node->nodeMap &= ~bit;
+        }
+    }
+
+    NodePtr m_root;
+    int m_size = 0;
+};
+
+} // namespace rewise::storage
+
+#endif // REWISE_STORAGE_PERSISTENTHASH_H
@@ -0,0 +1,215 @@
+#ifndef REWISE_STORAGE_PERSISTENTVECTOR_H
+#define REWISE_STORAGE_PERSISTENTVECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace rewise::storage {
+
+// Vector with structural sharing: a 32-way trie of reference-counted nodes.
+//
+// Copies are O(1) and share every node. A write touches one root-to-leaf path
+// (O(log32 n)): nodes still shared with another copy are cloned first, nodes
+// owned by this vector alone are written in place. So bulk building is cheap,
+// and a mutation after a copy costs a few small allocations instead of O(n).
+//
+// Never mutates a node that another copy can see; copies may be read from other
+// threads while this one is being modified.
+template <typename T>
+class PersistentVector final {
+    static constexpr int kBits = 5;
+    static constexpr int kWidth = 1 << kBits;
+    static constexpr int kMask = kWidth - 1;
+
+    struct Node final {
+        std::vector<std::shared_ptr<Node>> children; // inner nodes: kWidth slots
+        std::vector<T> values;                       // leaves: up to kWidth values
+    };
+    using NodePtr = std::shared_ptr<Node>;
+
+    static NodePtr makeNode(bool inner) {
+        auto n = std::make_shared<Node>();
+        if (inner) n->children.resize(kWidth);
+        else n->values.reserve(kWidth);
+        return n;
+    }
+
+public:
+    class const_iterator final {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator() = default;
+
+        reference operator*() const { return m_leaf[m_index & kMask]; }
+        pointer operator->() const { return &**this; }
+
+        const_iterator& operator++() {
+            ++m_index;
+            if ((m_index & kMask) == 0 && m_index < m_vec->size()) m_leaf = m_vec->leafFor(m_index);
+            return *this;
+        }
+        const_iterator operator++(int) { const_iterator tmp = *this; ++*this; return tmp; }
+
+        bool operator==(const const_iterator& o) const { return m_index == o.m_index; }
+        bool operator!=(const const_iterator& o) const { return m_index != o.m_index; }
+
+    private:
+        friend class PersistentVector;
+        const_iterator(const PersistentVector* v, int index)
+            : m_vec(v), m_index(index), m_leaf(index < v->size() ? v->leafFor(index) : nullptr) {}
+
+        const PersistentVector* m_vec = nullptr;
+        int m_index = 0;
+        const T* m_leaf = nullptr;
+    };
+
+    PersistentVector() = default;
+
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    const T& at(int i) const { return leafFor(i)[i & kMask]; }
+    const T& operator[](int i) const { return at(i); }
+    const T& last() const { return at(m_size - 1); }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_size); }
+
+    // Mutable access to one element; unshares its path first.
+    T& mutableAt(int i) { return writableLeaf(i)->values[i & kMask]; }
+    void set(int i, T value) { mutableAt(i) = std::move(value); }
+
+    void push_back(T value) {
+        if (!m_root) {
+            m_root = makeNode(false);
+            m_shift = 0;
+        } else if (m_size == (kWidth << m_shift)) {
+            // Full: grow one level.
+            NodePtr root = makeNode(true);
+            root->children[0] = std::move(m_root);
+            m_root = std::move(root);
+            m_shift += kBits;
+        }
+
+        Node* node = unshare(m_root);
+        for (int level = m_shift; level > 0; level -= kBits) {
+            NodePtr& child = node->children[(m_size >> level) & kMask];
+            if (!child) child = makeNode(level > kBits);
+            node = unshare(child);
+        }
+        node->values.push_back(std::move(value));
+        ++m_size;
+    }
+
+    void removeLast() {
+        if (m_size == 0) return;
+        const int i = m_size - 1;
+
+        // Unshare the path, remembering it to prune empty nodes afterwards.
+        Node* path[8] = {};
+        int depth = 0;
+        Node* node = unshare(m_root);
+        path[depth++] = node;
+        for (int level = m_shift; level > 0; level -= kBits) {
+            node = unshare(node->children[(i >> level) & kMask]);
+            path[depth++] = node;
+        }
+        node->values.pop_back();
+        --m_size;
+
+        // Drop emptied leaves/inner nodes bottom-up.
+        int level = kBits;
+        for (int d = depth - 1; d > 0; --d, level += kBits) {
+            const Node* child = path[d];
+            const bool empty = child->values.empty() && (child->children.empty() || !child->children[0]);
+            if (!empty) break;
+            path[d - 1]->children[(i >> level) & kMask].reset();
+        }
+
+        if (m_size == 0) {
+            clear();
+            return;
+        }
+        // Collapse a root with a single child.
+        while (m_shift > 0 && !m_root->children[1]) {
+            NodePtr child = m_root->children[0];
+            m_root = std::move(child);
+            m_shift -= kBits;
+        }
+    }
+
+    void clear() {
+        m_root.reset();
+        m_size = 0;
+        m_shift = 0;
+    }
+
+    // Capacity is managed per leaf; kept for QVector-compatible call sites.
+    void reserve(int) {}
+
+    std::vector<T> toStdVector() const { return std::vector<T>(begin(), end()); }
+
+    // Calls f(i) for every index whose element may differ from `other`
+    // (a superset: whole unshared leaves are reported). Shared subtrees are
+    // skipped, so the cost is proportional to the changes, not to size().
+    template <typename F>
+    void forEachDifference(const PersistentVector& other, F&& f) const {
+        const int n = std::max(m_size, other.m_size);
+        if (m_shift != other.m_shift || !m_root || !other.m_root) {
+            for (int i = 0; i < n; ++i) f(i);
+            return;
+        }
+        diffNode(m_root.get(), other.m_root.get(), m_shift, 0, n, f);
+    }
+
+private:
+    // Clones `p` if anyone else holds it; returns the (now exclusive) node.
+    static Node* unshare(NodePtr& p) {
+        if (p.use_count() > 1) p = std::make_shared<Node>(*p);
+        return p.get();
+    }
+
+    const T* leafFor(int i) const {
+        const Node* node = m_root.get();
+        for (int level = m_shift; level > 0; level -= kBits) node = node->children[(i >> level) & kMask].get();
+        return node->values.data();
+    }
+
+    Node* writableLeaf(int i) {
+        Node* node = unshare(m_root);
+        for (int level = m_shift; level > 0; level -= kBits) node = unshare(node->children[(i >> level) & kMask]);
+        return node;
+    }
+
+    template <typename F>
+    static void diffNode(const Node* a, const Node* b, int shift, int base, int n, F& f) {
+        if (a == b) return;
+        const int span = kWidth << shift;
+        if (shift == 0 || !a || !b) {
+            const int end = std::min(base + span, n);
+            for (int i = base; i < end; ++i) f(i);
+            return;
+        }
+        const int childSpan = 1 << shift;
+        for (int k = 0; k < kWidth && base + k * childSpan < n; ++k) {
+            diffNode(a->children[k].get(), b->children[k].get(), shift - kBits, base + k * childSpan, n, f);
+        }
+    }
+
+    NodePtr m_root;
+    int m_size = 0;
+    int m_shift = 0; // kBits * (height - 1)
+};
+
+} // namespace rewise::storage
+
+#endif // REWISE_STORAGE_PERSISTENTVECTOR_H
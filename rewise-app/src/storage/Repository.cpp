@@ -2,7 +2,6 @@
 #include "StorageJson.h"
 
 #include <QCoreApplication>
-#include <QStandardPaths>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
@@ -11,6 +10,11 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QJsonParseError>
+#include <QHash>
+#include <QSet>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <utility>
 
 namespace rewise::storage {
 
@@ -18,34 +22,22 @@ using rewise::domain::Folder;
 using rewise::domain::Card;
 using rewise::domain::Id;
 
-Repository::Repository(QString fileName)
-    : m_fileName(std::move(fileName)) {}
-
-QString Repository::databaseDirPath() const {
-    // AppDataLocation is an application-specific persistent data directory.
-    // It depends on QCoreApplication (app/organization name), but Qt guarantees non-empty.
-    const QString base = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
-
-    // Some apps forget to set appName; still return something stable.
-    // Usually base already includes app name, so we don’t append more folders here.
-    return base;
-}
+Repository::Repository(QString fileName, Layout layout)
+    : m_fileName(std::move(fileName))
+    , m_layout(layout) {}
 
 QString Repository::databaseFilePath() const {
     QDir dir(databaseDirPath());
     return dir.filePath(m_fileName);
 }
 
-bool Repository::ensureDatabaseDir(QString* error) const {
-    const QString dirPath = databaseDirPath();
-    QDir dir(dirPath);
-    if (dir.exists()) return true;
+QString Repository::shardsDirPath() const {
+    QDir dir(databaseDirPath());
+    return dir.filePath(json_keys::kShardsDirName);
+}
 
-    if (!dir.mkpath(".")) {
-        if (error) *error = "Failed to create database directory: " + dirPath;
-        return false;
-    }
-    return true;
+QString Repository::storagePath() const {
+    return (m_layout == Layout::Sharded) ? shardsDirPath() : databaseFilePath();
 }
 
 bool Repository::writeJsonAtomically(const QString& path, const QByteArray& utf8, QString* error) const {
@@ -79,7 +71,7 @@ bool Repository::writeJsonAtomically(const QString& path, const QByteArray& utf8
     return true;
 }
 
-QByteArray Repository::serializeDatabaseJson(const Database& db) const {
+bool Repository::serializeDatabaseJson(const Database& db, QByteArray* out, QString* error) const {
     QJsonObject root;
     root.insert(json_keys::kVersion, db.version);
 
@@ -93,14 +85,48 @@ QByteArray Repository::serializeDatabaseJson(const Database& db) const {
 
     QJsonArray cardsArr;
     cardsArr = QJsonArray{};
-    for (const Card& c : db.cards) {
+    for (int i = 0; i < db.cards.size(); ++i) {
+        Card c;
+        if (!db.fullCard(i, &c, error)) return false;
         cardsArr.append(c.toJson());
     }
     root.insert(json_keys::kCards, cardsArr);
 
 
     QJsonDocument doc(root);
-    return doc.toJson(QJsonDocument::Indented);
+    *out = doc.toJson(QJsonDocument::Indented);
+    return true;
+}
+
+QByteArray Repository::serializeManifestJson(const Database& db) const {
+    QJsonObject root;
+    root.insert(json_keys::kVersion, db.version);
+
+    QJsonArray foldersArr;
+    for (const Folder& f : db.folders) {
+        foldersArr.append(f.toJson());
+    }
+    root.insert(json_keys::kFolders, foldersArr);
+
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+bool Repository::serializeShardJson(const Database& db, const Id& folderId,
+                                    QByteArray* out, QString* error) const {
+    QJsonObject root;
+    root.insert(json_keys::kVersion, db.version);
+    root.insert(json_keys::kFolderId, folderId.toString());
+
+    QJsonArray cardsArr;
+    for (int idx : db.cardIndicesInFolder(folderId)) {
+        Card c;
+        if (!db.fullCard(idx, &c, error)) return false;
+        cardsArr.append(c.toJson());
+    }
+    root.insert(json_keys::kCards, cardsArr);
+
+    *out = QJsonDocument(root).toJson(QJsonDocument::Indented);
+    return true;
 }
 
 bool Repository::parseDatabaseJson(const QByteArray& utf8, Database* outDb, QString* error) const {
@@ -181,53 +207,191 @@ bool Repository::parseDatabaseJson(const QByteArray& utf8, Database* outDb, QStr
         }
     }
 
+    db.rebuildIndexes();
+
     *outDb = db;
     return true;
 }
 
-void Repository::ensureDefaults(Database* db) const {
-    if (!db) return;
+bool Repository::hasSingleFile() const {
+    return QFileInfo::exists(databaseFilePath());
+}
 
-    // Ensure at least one folder exists.
-    const Id defaultId = db->ensureDefaultFolder("Default");
-    (void)defaultId;
+bool Repository::hasShards() const {
+    return QFileInfo::exists(QDir(shardsDirPath()).filePath(json_keys::kManifestFileName));
+}
 
-    // Optional: ensure folder names are unique (nice to have).
-    db->ensureUniqueFolderNames();
+QString Repository::shardFilePath(const Id& folderId) const {
+    return QDir(shardsDirPath()).filePath(folderId.toString() + json_keys::kShardSuffix);
 }
 
-void Repository::repairOrphans(Database* db) const {
-    if (!db) return;
+bool Repository::loadSingleFile(Database* outDb, QString* error) const {
+    const QString path = databaseFilePath();
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = "Failed to open DB file: " + path + " (" + file.errorString() + ")";
+        return false;
+    }
 
-    // Ensure we have at least one folder.
-    ensureDefaults(db);
+    const QByteArray bytes = file.readAll();
+    file.close();
+
+    return parseDatabaseJson(bytes, outDb, error);
+}
+
+namespace {
 
-    // Build set of existing folder IDs.
-    QSet<QString> folderIds;
-    folderIds.reserve(db->folders.size());
-    for (const Folder& f : db->folders) folderIds.insert(f.id.toString());
+struct ShardLoad final {
+    QVector<Card> cards;
+    QString error;
+};
 
-    // Find orphan cards.
-    QVector<int> orphanIdx;
-    orphanIdx.reserve(db->cards.size());
-    for (int i = 0; i < db->cards.size(); ++i) {
-        if (!folderIds.contains(db->cards[i].folderId.toString())) {
-            orphanIdx.push_back(i);
+// Runs on a QtConcurrent worker: pure file read + parse, no shared state.
+ShardLoad readShard(const QString& path, const Id& folderId) {
+    ShardLoad r;
+
+    QFile file(path);
+    if (!file.exists()) return r; // folder created but never saved: empty
+    if (!file.open(QIODevice::ReadOnly)) {
+        r.error = "Failed to open shard: " + path + " (" + file.errorString() + ")";
+        return r;
+    }
+
+    QJsonParseError pe;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &pe);
+    if (pe.error != QJsonParseError::NoError || !doc.isObject()) {
+        r.error = QString("Shard %1: JSON parse error at offset %2: %3")
+                      .arg(path).arg(pe.offset).arg(pe.errorString());
+        return r;
+    }
+
+    const QJsonArray arr = doc.object().value(json_keys::kCards).toArray();
+    r.cards.reserve(arr.size());
+    for (int i = 0; i < arr.size(); ++i) {
+        Card c;
+        QString why;
+        if (!Card::fromJson(arr.at(i).toObject(), &c, &why)) {
+            r.error = QString("Shard %1: cards[%2] invalid: %3").arg(path).arg(i).arg(why);
+            return r;
         }
+        // The shard a card lives in is authoritative for its folder.
+        c.folderId = folderId;
+        r.cards.push_back(std::move(c));
+    }
+    return r;
+}
+
+} // namespace
+
+bool Repository::loadSharded(Database* outDb, QString* error) const {
+    const QString manifestPath = QDir(shardsDirPath()).filePath(json_keys::kManifestFileName);
+    QFile file(manifestPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = "Failed to open manifest: " + manifestPath + " (" + file.errorString() + ")";
+        return false;
     }
-    if (orphanIdx.isEmpty()) return;
-
-    // Create "Orphaned" folder once.
-    Folder orphanFolder;
-    orphanFolder.id = Id::create();
-    orphanFolder.name = "Orphaned";
-    db->folders.push_back(orphanFolder);
-
-    const Id orphanId = orphanFolder.id;
-    for (int idx : orphanIdx) {
-        db->cards[idx].folderId = orphanId;
-        db->cards[idx].touchUpdatedNow();
+
+    QJsonParseError pe;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &pe);
+    file.close();
+    if (pe.error != QJsonParseError::NoError || !doc.isObject()) {
+        if (error) *error = QString("Manifest JSON parse error at offset %1: %2").arg(pe.offset).arg(pe.errorString());
+        return false;
     }
+
+    const QJsonObject root = doc.object();
+
+    Database db;
+    db.version = root.value(json_keys::kVersion).toInt(json_keys::kSchemaVersion);
+
+    const QJsonArray foldersArr = root.value(json_keys::kFolders).toArray();
+    db.folders.reserve(foldersArr.size());
+    for (int i = 0; i < foldersArr.size(); ++i) {
+        Folder f;
+        QString why;
+        if (!Folder::fromJson(foldersArr.at(i).toObject(), &f, &why)) {
+            if (error) *error = QString("manifest folders[%1] invalid: %2").arg(i).arg(why);
+            return false;
+        }
+        db.folders.push_back(f);
+    }
+
+    // Shards are independent files: read and parse them in parallel.
+    QVector<Id> folderIds;
+    folderIds.reserve(db.folders.size());
+    for (const Folder& f : db.folders) folderIds.push_back(f.id);
+
+    const QString dir = shardsDirPath();
+    const QVector<ShardLoad> shards = QtConcurrent::blockingMapped<QVector<ShardLoad>>(
+        folderIds, [dir](const Id& folderId) {
+            return readShard(QDir(dir).filePath(folderId.toString() + json_keys::kShardSuffix), folderId);
+        });
+
+    // Merge. A card can appear in two shards if a move was interrupted between
+    // shard writes; keep the most recently updated copy (moves bump updatedAtMsUtc).
+    QHash<Id, int> seen;
+    for (const ShardLoad& shard : shards) {
+        if (!shard.error.isEmpty()) {
+            if (error) *error = shard.error;
+            return false;
+        }
+        for (const Card& c : shard.cards) {
+            const auto it = seen.constFind(c.id);
+            if (it == seen.constEnd()) {
+                seen.insert(c.id, db.cards.size());
+                db.cards.push_back(c);
+            } else if (c.updatedAtMsUtc > db.cards[*it].updatedAtMsUtc) {
+                db.cards.set(*it, c);
+            }
+        }
+    }
+
+    db.rebuildIndexes();
+
+    *outDb = db;
+    return true;
+}
+
+bool Repository::migrate(const Database& db, QString* error) const {
+    Database all = db;
+    all.markAllPending();
+    if (!save(all, error)) return false;
+
+    // Keep the source as a backup rather than deleting it; a Repository with the
+    // other layout finds no live copy and migrates back from ours.
+    if (m_layout == Layout::Sharded) {
+        const QString backup = databaseFilePath() + ".bak";
+        QFile::remove(backup);
+        if (!QFile::rename(databaseFilePath(), backup)) {
+            if (error) *error = "Failed to move aside migrated DB file: " + databaseFilePath();
+            return false;
+        }
+    } else {
+        const QString backup = shardsDirPath() + ".bak";
+        QDir(backup).removeRecursively();
+        if (!QDir().rename(shardsDirPath(), backup)) {
+            if (error) *error = "Failed to move aside migrated shards: " + shardsDirPath();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Repository::exists() const {
+    return hasShards() || hasSingleFile();
+}
+
+bool Repository::readExisting(Database* outDb, QString* error) const {
+    if (!outDb) {
+        if (error) *error = "Repository::readExisting: outDb is null.";
+        return false;
+    }
+
+    if (hasShards()) return loadSharded(outDb, error);
+    if (hasSingleFile()) return loadSingleFile(outDb, error);
+
+    if (error) *error = "No JSON database found in " + databaseDirPath();
+    return false;
 }
 
 bool Repository::load(Database* outDb, QString* error) const {
@@ -238,66 +402,101 @@ bool Repository::load(Database* outDb, QString* error) const {
 
     if (!ensureDatabaseDir(error)) return false;
 
-    const QString path = databaseFilePath();
-    QFile file(path);
+    const bool sharded = (m_layout == Layout::Sharded);
+    const bool haveOwn = sharded ? hasShards() : hasSingleFile();
+    const bool haveOther = sharded ? hasSingleFile() : hasShards();
 
-    if (!file.exists()) {
+    if (!haveOwn && !haveOther) {
         // First run: create a fresh DB.
         Database db;
         ensureDefaults(&db);
 
-        const QByteArray bytes = serializeDatabaseJson(db);
-        if (!writeJsonAtomically(path, bytes, error)) return false;
+        if (!save(db, error)) return false;
 
+        db.clearPendingChanges();
         *outDb = db;
         return true;
     }
 
-    if (!file.open(QIODevice::ReadOnly)) {
-        if (error) *error = "Failed to open DB file: " + path + " (" + file.errorString() + ")";
-        return false;
-    }
-
-    const QByteArray bytes = file.readAll();
-    file.close();
+    const bool fromShards = haveOwn ? sharded : !sharded;
 
     Database db;
-    if (!parseDatabaseJson(bytes, &db, error)) {
-        return false;
-    }
+    const bool ok = fromShards ? loadSharded(&db, error) : loadSingleFile(&db, error);
+    if (!ok) return false;
+    if (!finishLoad(&db, error)) return false;
 
-    // Handle versioning (currently only v1).
-    if (db.version != json_keys::kSchemaVersion) {
-        if (error) *error = QString("Unsupported DB schema version: %1").arg(db.version);
-        return false;
+    if (!haveOwn) {
+        if (!migrate(db, error)) return false;
+        db.clearPendingChanges();
     }
 
-    // Self-heal minimal invariants.
-    ensureDefaults(&db);
-    repairOrphans(&db);
+    // Any self-heal changes stay pending, so the next save persists them.
+    *outDb = db;
+    return true;
+}
+
+bool Repository::saveSingleFile(const Database& db, QString* error) const {
+    QByteArray bytes;
+    if (!serializeDatabaseJson(db, &bytes, error)) return false;
+    return writeJsonAtomically(databaseFilePath(), bytes, error);
+}
 
-    // Final validation.
-    QString why;
-    if (!db.validate(&why)) {
-        if (error) *error = "Database validation failed: " + why;
-        return false;
+bool Repository::saveSharded(const Database& db, const PendingChanges& changes, QString* error) const {
+    // Order matters for crash safety: shards first (a card is never only in a
+    // shard the manifest doesn't know about yet), then the manifest, then deletions.
+    auto writeShard = [&](const Id& folderId) {
+        QByteArray bytes;
+        if (!serializeShardJson(db, folderId, &bytes, error)) return false;
+        return writeJsonAtomically(shardFilePath(folderId), bytes, error);
+    };
+
+    if (changes.everything) {
+        for (const Folder& f : db.folders) {
+            if (!writeShard(f.id)) return false;
+        }
+    } else {
+        // Shards that received a card before the rest: a crash in between leaves
+        // a moved card in both its shards rather than in none, and the load keeps
+        // the copy with the later updatedAtMsUtc (moves bump it).
+        QVector<Id> order;
+        QSet<Id> queued;
+        order.reserve(changes.folders.size());
+        for (const Id& cardId : changes.cards) {
+            const Card* c = db.cardById(cardId);
+            if (!c || !changes.folders.contains(c->folderId) || queued.contains(c->folderId)) continue;
+            queued.insert(c->folderId);
+            order.push_back(c->folderId);
+        }
+        for (const Id& folderId : changes.folders) {
+            if (!queued.contains(folderId)) order.push_back(folderId);
+        }
+        for (const Id& folderId : order) {
+            if (db.folderIndexById(folderId) < 0) continue;
+            if (!writeShard(folderId)) return false;
+        }
     }
 
-    *outDb = db;
+    if (changes.manifest) {
+        const QString manifestPath = QDir(shardsDirPath()).filePath(json_keys::kManifestFileName);
+        if (!writeJsonAtomically(manifestPath, serializeManifestJson(db), error)) return false;
+    }
+
+    for (const Id& folderId : changes.removedFolders) {
+        QFile::remove(shardFilePath(folderId));
+    }
     return true;
 }
 
 bool Repository::save(const Database& db, QString* error) const {
     if (!ensureDatabaseDir(error)) return false;
 
-    QString why;
-    if (!db.validate(&why)) {
-        if (error) *error = "Refusing to save invalid DB: " + why;
-        return false;
-    }
+    const PendingChanges& changes = db.pendingChanges();
+    if (changes.isEmpty()) return true;
 
-    const QByteArray bytes = serializeDatabaseJson(db);
-    return writeJsonAtomically(databaseFilePath(), bytes, error);
+    // No full validate() here: mutations are checked incrementally before they
+    // reach the DB, and load() runs the full validator.
+    if (m_layout == Layout::Sharded) return saveSharded(db, changes, error);
+    return saveSingleFile(db, error);
 }
 
 } // namespace rewise::storage
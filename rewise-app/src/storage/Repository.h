@@ -1,45 +1,82 @@
 #ifndef REWISE_STORAGE_REPOSITORY_H
 #define REWISE_STORAGE_REPOSITORY_H
 
-#include "Database.h"
+#include "StorageBackend.h"
 
 #include <QString>
 
 namespace rewise::storage {
 
-class Repository final {
+// JSON-file backend.
+class Repository final : public StorageBackend {
 public:
-    explicit Repository(QString fileName = "db.json");
+    enum class Layout {
+        SingleFile, // AppDataLocation/<fileName>
+        Sharded     // AppDataLocation/shards/manifest.json + one <folderId>.json per folder
+    };
+
+    explicit Repository(QString fileName = "db.json", Layout layout = Layout::Sharded);
 
     // Load database from disk. If missing, it will create a fresh DB with a default folder.
-    bool load(Database* outDb, QString* error = nullptr) const;
+    // If only the other layout exists on disk, it is migrated to this one; the source is
+    // renamed to a backup, so constructing with the other layout migrates back.
+    bool load(Database* outDb, QString* error = nullptr) const override;
+
+    // True if any JSON layout (single file or shards) exists on disk.
+    bool exists() const;
+
+    // Reads whichever layout exists on disk, without migrating or writing anything.
+    // Returns false (with error) if there is no JSON database at all.
+    bool readExisting(Database* outDb, QString* error = nullptr) const;
 
-    // Save database atomically.
-    bool save(const Database& db, QString* error = nullptr) const;
+    // Save database atomically (QSaveFile per written file).
+    // SingleFile rewrites the whole file; Sharded writes only what db.pendingChanges() lists.
+    // Nothing is written if there are no pending changes.
+    // The caller clears pending changes after a successful save.
+    bool save(const Database& db, QString* error = nullptr) const override;
 
-    // Absolute full path to the DB file (AppDataLocation/<fileName>).
+    Layout layout() const { return m_layout; }
+
+    // Absolute full path to the single-file DB (AppDataLocation/<fileName>).
     QString databaseFilePath() const;
 
-    // Absolute directory that contains the DB.
-    QString databaseDirPath() const;
+    // Absolute directory of the sharded layout (AppDataLocation/shards).
+    QString shardsDirPath() const;
+
+    // Where the active layout lives (file or shards directory).
+    QString storagePath() const override;
 
 private:
     QString m_fileName;
+    Layout m_layout = Layout::Sharded;
 
-    bool ensureDatabaseDir(QString* error = nullptr) const;
     bool writeJsonAtomically(const QString& path, const QByteArray& utf8, QString* error) const;
 
+    bool hasSingleFile() const;
+    bool hasShards() const;
+    QString shardFilePath(const rewise::domain::Id& folderId) const;
+
+    // Raw loads (no self-heal).
+    bool loadSingleFile(Database* outDb, QString* error) const;
+    bool loadSharded(Database* outDb, QString* error) const;
+
+    bool saveSingleFile(const Database& db, QString* error) const;
+    bool saveSharded(const Database& db, const PendingChanges& changes, QString* error) const;
+
+    // Writes `db` in the active layout and moves the other layout's files aside.
+    bool migrate(const Database& db, QString* error) const;
+
     // Parses JSON -> Database (no disk I/O).
     bool parseDatabaseJson(const QByteArray& utf8, Database* outDb, QString* error) const;
 
-    // Serializes Database -> JSON bytes.
-    QByteArray serializeDatabaseJson(const Database& db) const;
-
-    // If there are orphaned cards (folderId missing), move them into a generated "Orphaned" folder.
-    void repairOrphans(Database* db) const;
+    // Serializes Database -> JSON bytes. Card serialization can fail in lazy-body
+    // mode (body unreadable); nothing must be written then.
+    bool serializeDatabaseJson(const Database& db, QByteArray* out, QString* error) const;
 
-    // If folders empty, create "Default".
-    void ensureDefaults(Database* db) const;
+    // Sharded layout: manifest holds folders (in order), each shard holds one folder's cards.
+    QByteArray serializeManifestJson(const Database& db) const;
+    bool serializeShardJson(const Database& db, const rewise::domain::Id& folderId,
+                            QByteArray* out, QString* error) const;
 };
 
 } // namespace rewise::storage
@@ -0,0 +1,411 @@
+#include "ReviewLog.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QPair>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace rewise::storage {
+
+using rewise::domain::Id;
+
+namespace {
+
+constexpr char kFileMagic[4] = {'R', 'W', 'H', 'L'};
+constexpr char kIndexMagic[4] = {'R', 'W', 'I', 'X'};
+constexpr quint32 kFormatVersion = 1;
+
+constexpr qint64 kHeaderBytes = 8;          // magic + u32 version
+constexpr qint64 kIndexHeaderBytes = 20;
+constexpr int kDayRunBytes = 8;
+constexpr int kCardEntryBytes = 20;
+constexpr int kIdBytes = 16;
+constexpr qint64 kSegmentBytes = qint64(ReviewLog::kSegmentRecords) * ReviewLog::kRecordBytes;
+
+// 8 bits per record and 4 probes: about 2% false positives per segment.
+constexpr int kBloomBytes = ReviewLog::kSegmentRecords;
+constexpr int kBloomProbes = 4;
+
+// Bit positions by double hashing over the (random) uuid bytes.
+template <typename F>
+void forEachBloomBit(const QByteArray& id, F&& f) {
+    const quint64 h1 = qFromLittleEndian<quint64>(id.constData());
+    const quint64 h2 = qFromLittleEndian<quint64>(id.constData() + 8) | 1;
+    for (int i = 0; i < kBloomProbes; ++i) f(static_cast<quint32>((h1 + i * h2) % (kBloomBytes * 8)));
+}
+
+void appendU32(QByteArray* out, quint32 v) {
+    char buf[4];
+    qToLittleEndian<quint32>(v, buf);
+    out->append(buf, 4);
+}
+
+} // namespace
+
+ReviewLog::ReviewLog(QString filePath)
+    : m_filePath(std::move(filePath))
+    , m_writer(m_filePath)
+    , m_reader(m_filePath)
+{}
+
+qint32 ReviewLog::localDayOf(qint64 msUtc) {
+    return static_cast<qint32>(QDateTime::fromMSecsSinceEpoch(msUtc).date().toJulianDay());
+}
+
+void ReviewLog::encode(const ReviewRecord& r, char* out) {
+    const QByteArray id = r.cardId.value.toRfc4122();
+    std::memcpy(out, id.constData(), kIdBytes);
+    qToLittleEndian<qint64>(r.atMsUtc, out + 16);
+    qToLittleEndian<qint32>(r.day, out + 24);
+    qToLittleEndian<quint32>(r.answerMs, out + 28);
+    qToLittleEndian<quint32>(r.optionsHash, out + 32);
+    qToLittleEndian<quint16>(r.distance, out + 36);
+    out[38] = static_cast<char>(r.percent);
+    out[39] = 0; // reserved
+}
+
+ReviewRecord ReviewLog::decode(const char* in) {
+    ReviewRecord r;
+    r.cardId = Id{QUuid::fromRfc4122(QByteArray::fromRawData(in, kIdBytes))};
+    r.atMsUtc = qFromLittleEndian<qint64>(in + 16);
+    r.day = qFromLittleEndian<qint32>(in + 24);
+    r.answerMs = qFromLittleEndian<quint32>(in + 28);
+    r.optionsHash = qFromLittleEndian<quint32>(in + 32);
+    r.distance = qFromLittleEndian<quint16>(in + 36);
+    r.percent = static_cast<quint8>(in[38]);
+    return r;
+}
+
+QByteArray ReviewLog::indexBlock(const QVector<ReviewRecord>& segment, Segment* info) {
+    info->days.clear();
+    for (int i = 0; i < segment.size(); ++i) {
+        if (i == 0 || segment[i].day != segment[i - 1].day) {
+            info->days.push_back(DayRun{segment[i].day, static_cast<quint32>(i)});
+        }
+    }
+
+    info->bloom = QByteArray(kBloomBytes, '\0');
+    char* bits = info->bloom.data();
+    QVector<QPair<QByteArray, quint32>> cards;
+    cards.reserve(segment.size());
+    for (int i = 0; i < segment.size(); ++i) {
+        const QByteArray id = segment[i].cardId.value.toRfc4122();
+        forEachBloomBit(id, [bits](quint32 bit) { bits[bit >> 3] |= static_cast<char>(1 << (bit & 7)); });
+        cards.push_back({id, static_cast<quint32>(i)});
+    }
+    // Byte order of the RFC 4122 form = Id order; ties keep log order.
+    std::sort(cards.begin(), cards.end());
+
+    const qint64 blockBytes = kIndexHeaderBytes + qint64(info->days.size()) * kDayRunBytes + kBloomBytes
+                              + qint64(cards.size()) * kCardEntryBytes;
+    QByteArray block;
+    block.reserve(static_cast<int>(blockBytes));
+    block.append(kIndexMagic, 4);
+    appendU32(&block, static_cast<quint32>(blockBytes));
+    appendU32(&block, static_cast<quint32>(segment.size()));
+    appendU32(&block, static_cast<quint32>(info->days.size()));
+    appendU32(&block, kBloomBytes);
+    for (const DayRun& run : info->days) {
+        char buf[4];
+        qToLittleEndian<qint32>(run.day, buf);
+        block.append(buf, 4);
+        appendU32(&block, run.first);
+    }
+    block.append(info->bloom);
+    for (const auto& entry : cards) {
+        block.append(entry.first);
+        appendU32(&block, entry.second);
+    }
+    return block;
+}
+
+bool ReviewLog::bloomMayContain(const QByteArray& bloom, const QByteArray& id) {
+    bool all = true;
+    forEachBloomBit(id, [&](quint32 bit) {
+        if (!(static_cast<quint8>(bloom.at(static_cast<int>(bit >> 3))) & (1u << (bit & 7)))) all = false;
+    });
+    return all;
+}
+
+bool ReviewLog::open(QString* error) {
+    QMutexLocker writeLock(&m_writeMutex);
+    QMutexLocker readLock(&m_readMutex);
+    if (m_writer.isOpen()) m_writer.close();
+    if (m_reader.isOpen()) m_reader.close();
+
+    QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+    if (!m_writer.open(QIODevice::ReadWrite)) {
+        if (error) *error = "Failed to open review history: " + m_filePath + " (" + m_writer.errorString() + ")";
+        return false;
+    }
+
+    auto fail = [&](const QString& why) {
+        if (error) *error = why + ": " + m_filePath;
+        m_writer.close();
+        return false;
+    };
+
+    if (m_writer.size() < kHeaderBytes) {
+        QByteArray header(kFileMagic, 4);
+        appendU32(&header, kFormatVersion);
+        if (!m_writer.resize(0) || !m_writer.seek(0) || m_writer.write(header) != header.size() || !m_writer.flush()) {
+            return fail("Failed to initialize review history");
+        }
+    } else {
+        m_writer.seek(0);
+        const QByteArray header = m_writer.read(kHeaderBytes);
+        if (header.size() != kHeaderBytes || std::memcmp(header.constData(), kFileMagic, 4) != 0
+            || qFromLittleEndian<quint32>(header.constData() + 4) != kFormatVersion) {
+            return fail("Not a review history file (or an unsupported version)");
+        }
+    }
+
+    // Sealed segments: only index headers, day runs and filters are read.
+    const qint64 fileSize = m_writer.size();
+    QVector<Segment> segments;
+    qint64 pos = kHeaderBytes;
+    while (pos + kSegmentBytes + kIndexHeaderBytes <= fileSize) {
+        const qint64 indexAt = pos + kSegmentBytes;
+        if (!m_writer.seek(indexAt)) break;
+        const QByteArray h = m_writer.read(kIndexHeaderBytes);
+        if (h.size() != kIndexHeaderBytes || std::memcmp(h.constData(), kIndexMagic, 4) != 0) break;
+
+        const quint32 blockBytes = qFromLittleEndian<quint32>(h.constData() + 4);
+        const quint32 records = qFromLittleEndian<quint32>(h.constData() + 8);
+        const quint32 runs = qFromLittleEndian<quint32>(h.constData() + 12);
+        const quint32 bloomBytes = qFromLittleEndian<quint32>(h.constData() + 16);
+        const qint64 headBytes = qint64(runs) * kDayRunBytes + bloomBytes;
+        const qint64 expected = kIndexHeaderBytes + headBytes + qint64(records) * kCardEntryBytes;
+        if (records != kSegmentRecords || runs > records || bloomBytes != kBloomBytes
+            || blockBytes != expected || indexAt + blockBytes > fileSize) {
+            break;
+        }
+
+        const QByteArray head = m_writer.read(headBytes);
+        if (head.size() != headBytes) break;
+
+        Segment s;
+        s.offset = pos;
+        s.cardListOffset = indexAt + kIndexHeaderBytes + headBytes;
+        s.days.reserve(static_cast<int>(runs));
+        for (quint32 i = 0; i < runs; ++i) {
+            const char* p = head.constData() + i * kDayRunBytes;
+            s.days.push_back(DayRun{qFromLittleEndian<qint32>(p), qFromLittleEndian<quint32>(p + 4)});
+        }
+        s.bloom = head.mid(static_cast<int>(runs) * kDayRunBytes);
+        segments.push_back(std::move(s));
+        pos = indexAt + blockBytes;
+    }
+
+    // Unsealed tail: whole records only. A full segment whose index block was torn
+    // is sealed again by the next flush().
+    const qint64 tailRecords = std::min<qint64>((fileSize - pos) / kRecordBytes, kSegmentRecords);
+    QVector<ReviewRecord> tail;
+    if (tailRecords > 0) {
+        m_writer.seek(pos);
+        const QByteArray raw = m_writer.read(tailRecords * kRecordBytes);
+        if (raw.size() != tailRecords * kRecordBytes) return fail("Failed to read review history");
+        tail.reserve(static_cast<int>(tailRecords));
+        for (qint64 i = 0; i < tailRecords; ++i) tail.push_back(decode(raw.constData() + i * kRecordBytes));
+    }
+    const qint64 end = pos + tailRecords * kRecordBytes;
+    if (end < fileSize && !m_writer.resize(end)) return fail("Failed to cut a torn review history tail");
+
+    // Reads are positioned and never overlap bytes still being written.
+    if (!m_reader.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) return fail("Failed to open review history for reading");
+
+    QMutexLocker locker(&m_mutex);
+    m_segments = std::move(segments);
+    m_tail = std::move(tail);
+    m_end = end;
+    return true;
+}
+
+void ReviewLog::append(const ReviewRecord& r) {
+    QMutexLocker locker(&m_mutex);
+    m_pending.push_back(r);
+}
+
+bool ReviewLog::hasPending() const {
+    QMutexLocker locker(&m_mutex);
+    return !m_pending.isEmpty();
+}
+
+qint64 ReviewLog::recordCount() const {
+    QMutexLocker locker(&m_mutex);
+    return qint64(m_segments.size()) * kSegmentRecords + m_tail.size() + m_pending.size();
+}
+
+bool ReviewLog::flush(QString* error) {
+    QMutexLocker writeLock(&m_writeMutex);
+
+    // Queued records stay visible to readers until they are in the tail/segments.
+    QVector<ReviewRecord> batch;
+    QVector<ReviewRecord> tail;
+    qint64 end = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_pending.isEmpty() && m_tail.size() < kSegmentRecords) return true;
+        batch = m_pending;
+        tail = m_tail;
+        end = m_end;
+    }
+    if (!m_writer.isOpen()) {
+        if (error) *error = "Review history is not open: " + m_filePath;
+        return false;
+    }
+
+    QByteArray out;
+    out.reserve(batch.size() * kRecordBytes);
+    QVector<Segment> sealed;
+    qint64 segmentStart = end - qint64(tail.size()) * kRecordBytes;
+
+    auto sealIfFull = [&] {
+        if (tail.size() < kSegmentRecords) return;
+        Segment s;
+        s.offset = segmentStart;
+        const QByteArray block = indexBlock(tail, &s);
+        const qint64 indexAt = segmentStart + kSegmentBytes;
+        s.cardListOffset = indexAt + kIndexHeaderBytes + qint64(s.days.size()) * kDayRunBytes + s.bloom.size();
+        out.append(block);
+        sealed.push_back(std::move(s));
+        segmentStart = indexAt + block.size();
+        tail.clear();
+    };
+
+    sealIfFull();
+    char buf[kRecordBytes];
+    for (const ReviewRecord& r : batch) {
+        encode(r, buf);
+        out.append(buf, kRecordBytes);
+        tail.push_back(r);
+        sealIfFull();
+    }
+
+    if (!m_writer.seek(end) || m_writer.write(out) != out.size() || !m_writer.flush()) {
+        if (error) *error = "Failed to write review history: " + m_writer.errorString();
+        m_writer.resize(end); // drop a partial write; the batch stays queued
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_pending.remove(0, batch.size());
+    m_segments += sealed;
+    m_tail = std::move(tail);
+    m_end = end + out.size();
+    return true;
+}
+
+bool ReviewLog::readAt(qint64 offset, qint64 bytes, QByteArray* out, QString* error) const {
+    QMutexLocker locker(&m_readMutex);
+    if (!m_reader.isOpen() || !m_reader.seek(offset)) {
+        if (error) *error = "Review history is not readable: " + m_filePath;
+        return false;
+    }
+    *out = m_reader.read(bytes);
+    if (out->size() != bytes) {
+        if (error) *error = "Failed to read review history: " + m_reader.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool ReviewLog::readRecords(const Segment& s, quint32 first, quint32 count, QVector<ReviewRecord>* out,
+                            QString* error) const {
+    QByteArray raw;
+    if (!readAt(s.offset + qint64(first) * kRecordBytes, qint64(count) * kRecordBytes, &raw, error)) return false;
+    for (quint32 i = 0; i < count; ++i) out->push_back(decode(raw.constData() + i * kRecordBytes));
+    return true;
+}
+
+bool ReviewLog::cardRecordsInSegment(const Segment& s, const QByteArray& id, QVector<ReviewRecord>* out,
+                                     QString* error) const {
+    // Lower bound of the id in the sorted card list.
+    QByteArray entry;
+    quint32 lo = 0;
+    quint32 hi = kSegmentRecords;
+    while (lo < hi) {
+        const quint32 mid = lo + (hi - lo) / 2;
+        if (!readAt(s.cardListOffset + qint64(mid) * kCardEntryBytes, kCardEntryBytes, &entry, error)) return false;
+        if (std::memcmp(entry.constData(), id.constData(), kIdBytes) < 0) lo = mid + 1;
+        else hi = mid;
+    }
+
+    // The card's entries are contiguous from there, record numbers ascending.
+    constexpr quint32 kChunk = 64;
+    constexpr quint32 kEntries = kSegmentRecords;
+    for (quint32 i = lo; i < kEntries; i += kChunk) {
+        const quint32 n = std::min(kChunk, kEntries - i);
+        QByteArray chunk;
+        if (!readAt(s.cardListOffset + qint64(i) * kCardEntryBytes, qint64(n) * kCardEntryBytes, &chunk, error)) return false;
+        for (quint32 k = 0; k < n; ++k) {
+            const char* e = chunk.constData() + k * kCardEntryBytes;
+            if (std::memcmp(e, id.constData(), kIdBytes) != 0) return true;
+            if (!readRecords(s, qFromLittleEndian<quint32>(e + kIdBytes), 1, out, error)) return false;
+        }
+    }
+    return true;
+}
+
+bool ReviewLog::historyOfCard(const Id& cardId, QVector<ReviewRecord>* out, QString* error) const {
+    QVector<Segment> segments;
+    QVector<ReviewRecord> tail;
+    QVector<ReviewRecord> pending;
+    {
+        QMutexLocker locker(&m_mutex);
+        segments = m_segments;
+        tail = m_tail;
+        pending = m_pending;
+    }
+
+    out->clear();
+    const QByteArray id = cardId.value.toRfc4122();
+    for (const Segment& s : segments) {
+        if (!bloomMayContain(s.bloom, id)) continue;
+        if (!cardRecordsInSegment(s, id, out, error)) return false;
+    }
+    for (const ReviewRecord& r : tail) {
+        if (r.cardId == cardId) out->push_back(r);
+    }
+    for (const ReviewRecord& r : pending) {
+        if (r.cardId == cardId) out->push_back(r);
+    }
+    return true;
+}
+
+bool ReviewLog::recordsOnDays(qint32 firstDay, qint32 lastDay, QVector<ReviewRecord>* out, QString* error) const {
+    QVector<Segment> segments;
+    QVector<ReviewRecord> tail;
+    QVector<ReviewRecord> pending;
+    {
+        QMutexLocker locker(&m_mutex);
+        segments = m_segments;
+        tail = m_tail;
+        pending = m_pending;
+    }
+
+    out->clear();
+    for (const Segment& s : segments) {
+        for (int i = 0; i < s.days.size(); ++i) {
+            const DayRun& run = s.days[i];
+            if (run.day < firstDay || run.day > lastDay) continue;
+            const quint32 runEnd = (i + 1 < s.days.size()) ? s.days[i + 1].first : quint32(kSegmentRecords);
+            if (!readRecords(s, run.first, runEnd - run.first, out, error)) return false;
+        }
+    }
+    for (const ReviewRecord& r : tail) {
+        if (r.day >= firstDay && r.day <= lastDay) out->push_back(r);
+    }
+    for (const ReviewRecord& r : pending) {
+        if (r.day >= firstDay && r.day <= lastDay) out->push_back(r);
+    }
+    return true;
+}
+
+} // namespace rewise::storage
@@ -0,0 +1,109 @@
+#ifndef REWISE_STORAGE_REVIEWLOG_H
+#define REWISE_STORAGE_REVIEWLOG_H
+
+#include "../domain/Id.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+namespace rewise::storage {
+
+// One check of one card, as recorded in the history.
+struct ReviewRecord final {
+    rewise::domain::Id cardId;
+    qint64 atMsUtc = 0;
+    qint32 day = 0;            // local Julian day of atMsUtc (see ReviewLog::localDayOf)
+    quint32 answerMs = 0;      // from showing the card to the check
+    quint32 optionsHash = 0;   // review::ReviewEngine::scoringHash() the answer was scored with
+    quint16 distance = 0;      // edit distance, saturated
+    quint8 percent = 0;
+};
+
+// Append-only history of checks (a file next to the database).
+//
+// After a small header, the file is a run of segments: kSegmentRecords
+// fixed-size records (kRecordBytes each), then an index block sealing them:
+//   [magic "RWIX"][u32 block bytes][u32 records][u32 day runs][u32 bloom bytes]
+//   day runs  x [i32 day][u32 first record of the run]
+//   bloom     (card ids of the segment)
+//   card list x [16-byte card id][u32 record], sorted by id
+// The last segment stays unsealed until it fills up.
+//
+// open() reads the index headers, day runs and Bloom filters (about 4 KiB per
+// segment) plus the unsealed tail; records stay on disk. Reading one card's
+// history probes every filter and binary-searches the card list of the few
+// segments that match. A torn tail (crash mid-write) is cut off on open.
+//
+// append() only queues; flush() writes the queue and seals full segments and
+// is meant for a worker thread. Thread-safe.
+class ReviewLog final {
+public:
+    static constexpr int kRecordBytes = 40;
+    static constexpr int kSegmentRecords = 4096;
+
+    explicit ReviewLog(QString filePath);
+
+    // Creates the file if needed.
+    bool open(QString* error = nullptr);
+
+    void append(const ReviewRecord& r);
+    bool hasPending() const;
+    // Writes everything queued so far. On failure the records stay queued.
+    bool flush(QString* error = nullptr);
+
+    // Records written or queued.
+    qint64 recordCount() const;
+
+    // Checks of one card, oldest first (queued ones included).
+    bool historyOfCard(const rewise::domain::Id& cardId, QVector<ReviewRecord>* out, QString* error = nullptr) const;
+    // Checks on local days [firstDay, lastDay], in log order (queued ones included).
+    bool recordsOnDays(qint32 firstDay, qint32 lastDay, QVector<ReviewRecord>* out, QString* error = nullptr) const;
+
+    static qint32 localDayOf(qint64 msUtc);
+
+    QString filePath() const { return m_filePath; }
+
+private:
+    struct DayRun final {
+        qint32 day = 0;
+        quint32 first = 0;      // record index within the segment
+    };
+
+    // In-memory directory entry of a sealed segment.
+    struct Segment final {
+        qint64 offset = 0;           // first record
+        qint64 cardListOffset = 0;
+        QVector<DayRun> days;
+        QByteArray bloom;
+    };
+
+    static void encode(const ReviewRecord& r, char* out);
+    static ReviewRecord decode(const char* in);
+    static QByteArray indexBlock(const QVector<ReviewRecord>& segment, Segment* info);
+    static bool bloomMayContain(const QByteArray& bloom, const QByteArray& id);
+
+    bool readAt(qint64 offset, qint64 bytes, QByteArray* out, QString* error) const;
+    bool readRecords(const Segment& s, quint32 first, quint32 count, QVector<ReviewRecord>* out, QString* error) const;
+    bool cardRecordsInSegment(const Segment& s, const QByteArray& id, QVector<ReviewRecord>* out, QString* error) const;
+
+    QString m_filePath;
+
+    mutable QMutex m_mutex;            // guards the directory, tail and queue below
+    QVector<Segment> m_segments;
+    QVector<ReviewRecord> m_tail;      // written, not sealed yet
+    QVector<ReviewRecord> m_pending;   // queued, not written yet
+    qint64 m_end = 0;                  // end of the written data
+
+    QMutex m_writeMutex;               // one flush at a time
+    QFile m_writer;
+
+    mutable QMutex m_readMutex;
+    mutable QFile m_reader;
+};
+
+} // namespace rewise::storage
+
+#endif // REWISE_STORAGE_REVIEWLOG_H
@@ -0,0 +1,193 @@
+#include "ReviewRollups.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include <cstring>
+#include <utility>
+
+namespace rewise::storage {
+
+using rewise::domain::Id;
+
+namespace {
+
+constexpr char kMagic[4] = {'R', 'W', 'S', 'T'};
+constexpr quint32 kFormatVersion = 1;
+constexpr qint64 kHeaderBytes = 8;
+constexpr int kCellBytes = 44; // i32 day, 16-byte folder id, u32 checks, u32 passed, u64 percent sum, u64 answer ms sum
+
+QByteArray header() {
+    QByteArray out(kMagic, 4);
+    char buf[4];
+    qToLittleEndian<quint32>(kFormatVersion, buf);
+    out.append(buf, 4);
+    return out;
+}
+
+void appendCell(QByteArray* out, qint32 day, const Id& folderId, const ReviewRollups::Totals& t) {
+    char buf[kCellBytes];
+    qToLittleEndian<qint32>(day, buf);
+    std::memcpy(buf + 4, folderId.value.toRfc4122().constData(), 16);
+    qToLittleEndian<quint32>(t.checks, buf + 20);
+    qToLittleEndian<quint32>(t.passed, buf + 24);
+    qToLittleEndian<quint64>(t.percentSum, buf + 28);
+    qToLittleEndian<quint64>(t.answerMsSum, buf + 36);
+    out->append(buf, kCellBytes);
+}
+
+} // namespace
+
+ReviewRollups::ReviewRollups(QString filePath)
+    : m_filePath(std::move(filePath))
+{}
+
+bool ReviewRollups::load(QString* error) {
+    m_cells.clear();
+    m_dirty.clear();
+    m_byDay.clear();
+    m_byFolder.clear();
+    m_total = {};
+    m_fileRecords = 0;
+
+    QFile file(m_filePath);
+    if (!file.exists()) return true;
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = "Failed to open statistics: " + m_filePath + " (" + file.errorString() + ")";
+        return false;
+    }
+
+    const QByteArray data = file.readAll();
+    if (data.size() < kHeaderBytes || std::memcmp(data.constData(), kMagic, 4) != 0
+        || qFromLittleEndian<quint32>(data.constData() + 4) != kFormatVersion) {
+        if (error) *error = "Not a statistics file (or an unsupported version): " + m_filePath;
+        return false;
+    }
+
+    // Later records of a cell replace earlier ones; a torn last record is ignored.
+    const int records = static_cast<int>((data.size() - kHeaderBytes) / kCellBytes);
+    for (int i = 0; i < records; ++i) {
+        const char* p = data.constData() + kHeaderBytes + qint64(i) * kCellBytes;
+        const qint32 day = qFromLittleEndian<qint32>(p);
+        const Id folderId{QUuid::fromRfc4122(QByteArray::fromRawData(p + 4, 16))};
+        Totals t;
+        t.checks = qFromLittleEndian<quint32>(p + 20);
+        t.passed = qFromLittleEndian<quint32>(p + 24);
+        t.percentSum = qFromLittleEndian<quint64>(p + 28);
+        t.answerMsSum = qFromLittleEndian<quint64>(p + 36);
+        m_cells.insert(CellKey(day, folderId), t);
+    }
+    m_fileRecords = records;
+
+    for (auto it = m_cells.cbegin(); it != m_cells.cend(); ++it) {
+        m_byDay[it.key().first].add(*it);
+        m_byFolder[it.key().second].add(*it);
+        m_total.add(*it);
+    }
+    return true;
+}
+
+void ReviewRollups::apply(const CellKey& key, const Totals& delta) {
+    m_cells[key].add(delta);
+    m_byDay[key.first].add(delta);
+    m_byFolder[key.second].add(delta);
+    m_total.add(delta);
+    m_dirty.insert(key);
+}
+
+void ReviewRollups::add(const ReviewRecord& r, const Id& folderId, bool passed) {
+    Totals delta;
+    delta.checks = 1;
+    delta.passed = passed ? 1 : 0;
+    delta.percentSum = r.percent;
+    delta.answerMsSum = r.answerMs;
+    apply(CellKey(r.day, folderId), delta);
+}
+
+bool ReviewRollups::save(QString* error) {
+    if (m_dirty.isEmpty()) return true;
+
+    if (m_fileRecords + m_dirty.size() > 2 * m_cells.size() + 1024) return rewrite(error);
+
+    QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+    QFile file(m_filePath);
+    const bool fresh = !file.exists();
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        if (error) *error = "Failed to open statistics: " + m_filePath + " (" + file.errorString() + ")";
+        return false;
+    }
+
+    // Whole records only: a torn tail from an earlier crash would shift everything after it.
+    const qint64 size = file.size();
+    if (!fresh && size >= kHeaderBytes && (size - kHeaderBytes) % kCellBytes != 0) {
+        file.close();
+        return rewrite(error);
+    }
+
+    QByteArray out;
+    if (fresh || size < kHeaderBytes) {
+        if (size > 0 && !file.resize(0)) {
+            if (error) *error = "Failed to reset statistics: " + file.errorString();
+            return false;
+        }
+        out = header();
+    }
+    out.reserve(out.size() + m_dirty.size() * kCellBytes);
+    for (const CellKey& key : m_dirty) appendCell(&out, key.first, key.second, m_cells.value(key));
+
+    if (file.write(out) != out.size() || !file.flush()) {
+        if (error) *error = "Failed to write statistics: " + file.errorString();
+        return false;
+    }
+    m_fileRecords += m_dirty.size();
+    m_dirty.clear();
+    return true;
+}
+
+bool ReviewRollups::rewrite(QString* error) {
+    QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+    QSaveFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error) *error = "Failed to write statistics: " + m_filePath + " (" + file.errorString() + ")";
+        return false;
+    }
+
+    QByteArray out = header();
+    out.reserve(static_cast<int>(kHeaderBytes + qint64(m_cells.size()) * kCellBytes));
+    for (auto it = m_cells.cbegin(); it != m_cells.cend(); ++it) appendCell(&out, it.key().first, it.key().second, *it);
+
+    if (file.write(out) != out.size() || !file.commit()) {
+        if (error) *error = "Failed to write statistics: " + file.errorString();
+        return false;
+    }
+    m_fileRecords = m_cells.size();
+    m_dirty.clear();
+    return true;
+}
+
+int ReviewRollups::currentStreak(qint32 today) const {
+    qint32 day = m_byDay.contains(today) ? today : today - 1;
+    int streak = 0;
+    while (m_byDay.contains(day)) {
+        ++streak;
+        --day;
+    }
+    return streak;
+}
+
+int ReviewRollups::longestStreak() const {
+    int best = 0;
+    int run = 0;
+    qint32 prev = 0;
+    for (auto it = m_byDay.cbegin(); it != m_byDay.cend(); ++it) {
+        run = (run > 0 && it.key() == prev + 1) ? run + 1 : 1;
+        best = qMax(best, run);
+        prev = it.key();
+    }
+    return best;
+}
+
+} // namespace rewise::storage
@@ -0,0 +1,81 @@
+#ifndef REWISE_STORAGE_REVIEWROLLUPS_H
+#define REWISE_STORAGE_REVIEWROLLUPS_H
+
+#include "ReviewLog.h"
+#include "../domain/Id.h"
+
+#include <QHash>
+#include <QMap>
+#include <QPair>
+#include <QSet>
+#include <QString>
+
+namespace rewise::storage {
+
+// Pre-aggregated review statistics: counters per local day x folder.
+//
+// A check updates one cell plus the per-day and per-folder totals, so readers
+// (the stats page) look at O(days + folders) numbers no matter how many checks
+// have been logged. Cells are persisted in a small append-only file: save()
+// appends the current value of every cell touched since the last save
+// (44 bytes each) and load() lets later records replace earlier ones. Once
+// stale records outnumber live cells the file is rewritten compactly.
+class ReviewRollups final {
+public:
+    struct Totals final {
+        quint32 checks = 0;
+        quint32 passed = 0;
+        quint64 percentSum = 0;
+        quint64 answerMsSum = 0;
+
+        void add(const Totals& o) {
+            checks += o.checks;
+            passed += o.passed;
+            percentSum += o.percentSum;
+            answerMsSum += o.answerMsSum;
+        }
+        double averagePercent() const { return checks ? double(percentSum) / checks : 0.0; }
+        double passRate() const { return checks ? double(passed) / checks : 0.0; }
+    };
+
+    explicit ReviewRollups(QString filePath);
+
+    // Missing file = no statistics yet.
+    bool load(QString* error = nullptr);
+    // Appends the cells changed since the last save (or compacts the file).
+    bool save(QString* error = nullptr);
+
+    // O(log days).
+    void add(const ReviewRecord& r, const rewise::domain::Id& folderId, bool passed);
+
+    const QMap<qint32, Totals>& byDay() const { return m_byDay; }               // local Julian day -> totals
+    const QHash<rewise::domain::Id, Totals>& byFolder() const { return m_byFolder; }
+    const Totals& total() const { return m_total; }
+
+    // Consecutive days with checks up to `today` (a streak is still alive on a
+    // day without checks yet). O(streak log days).
+    int currentStreak(qint32 today) const;
+    // O(days).
+    int longestStreak() const;
+
+    QString filePath() const { return m_filePath; }
+
+private:
+    using CellKey = QPair<qint32, rewise::domain::Id>; // day, folder
+
+    void apply(const CellKey& key, const Totals& delta);
+    bool rewrite(QString* error);
+
+    QString m_filePath;
+    QHash<CellKey, Totals> m_cells;
+    QSet<CellKey> m_dirty;
+    int m_fileRecords = 0;        // cell records in the file, stale ones included
+
+    QMap<qint32, Totals> m_byDay;
+    QHash<rewise::domain::Id, Totals> m_byFolder;
+    Totals m_total;
+};
+
+} // namespace rewise::storage
+
+#endif // REWISE_STORAGE_REVIEWROLLUPS_H
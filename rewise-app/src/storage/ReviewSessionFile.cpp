@@ -0,0 +1,188 @@
+#include "ReviewSessionFile.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include <cstring>
+#include <utility>
+
+namespace rewise::storage {
+
+namespace {
+
+constexpr char kMagic[4] = {'R', 'W', 'S', 'N'};
+constexpr quint32 kFormatVersion = 2;   // 1: no seed and card list
+constexpr int kMaxTitleBytes = 0xffff;
+
+void putU16(QByteArray* out, quint16 v) { char b[2]; qToLittleEndian<quint16>(v, b); out->append(b, 2); }
+void putU32(QByteArray* out, quint32 v) { char b[4]; qToLittleEndian<quint32>(v, b); out->append(b, 4); }
+void putI64(QByteArray* out, qint64 v)  { char b[8]; qToLittleEndian<qint64>(v, b);  out->append(b, 8); }
+
+// Bounds-checked reader over the loaded file.
+struct Reader final {
+    const QByteArray& data;
+    qint64 pos = 0;
+
+    bool has(qint64 n) const { return pos + n <= data.size(); }
+    const char* take(qint64 n) { const char* p = data.constData() + pos; pos += n; return p; }
+};
+
+} // namespace
+
+ReviewSessionFile::ReviewSessionFile(QString filePath)
+    : m_filePath(std::move(filePath))
+{}
+
+bool ReviewSessionFile::begin(const SessionHeader& header, QString* error) {
+    QByteArray out(kMagic, 4);
+    putU32(&out, kFormatVersion);
+    out.append(static_cast<char>(header.order));
+    putI64(&out, header.horizonMsUtc);
+    putI64(&out, header.startedAtMsUtc);
+    const QByteArray title = header.title.toUtf8().left(kMaxTitleBytes);
+    putU16(&out, static_cast<quint16>(title.size()));
+    out.append(title);
+    const int folders = qMin(header.folderIds.size(), 0xffff);
+    putU16(&out, static_cast<quint16>(folders));
+    for (int i = 0; i < folders; ++i) out.append(header.folderIds[i].value.toRfc4122());
+    putU32(&out, header.seed);
+    putU32(&out, static_cast<quint32>(header.cardIds.size()));
+    out.reserve(out.size() + header.cardIds.size() * 16);
+    for (const auto& id : header.cardIds) out.append(id.value.toRfc4122());
+
+    QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+    QSaveFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(out) != out.size() || !file.commit()) {
+        m_headerBytes = -1;
+        if (error) *error = "Failed to write review session: " + m_filePath + " (" + file.errorString() + ")";
+        return false;
+    }
+    m_headerBytes = out.size();
+    return true;
+}
+
+bool ReviewSessionFile::appendCheck(const SessionCheck& check, QString* error) {
+    char rec[kCheckBytes];
+    std::memcpy(rec, check.cardId.value.toRfc4122().constData(), 16);
+    qToLittleEndian<quint32>(check.answerMs, rec + 16);
+    qToLittleEndian<quint16>(check.round, rec + 20);
+    rec[22] = static_cast<char>(check.percent);
+    rec[23] = static_cast<char>(check.passed ? 1 : 0);
+
+    // Where the checks start, read once per session (a resumed one wasn't begun here).
+    if (m_headerBytes < 0 && !read(nullptr, nullptr, error)) {
+        if (error && error->isEmpty()) *error = "No review session to continue: " + m_filePath;
+        return false;
+    }
+
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        if (error) *error = "Failed to open review session: " + m_filePath + " (" + file.errorString() + ")";
+        return false;
+    }
+
+    // Whole records only: a torn tail from an earlier crash would shift every check after it.
+    const qint64 size = file.size();
+    if (size < m_headerBytes) {
+        m_headerBytes = -1;
+        if (error) *error = "Review session file is truncated: " + m_filePath;
+        return false;
+    }
+    const qint64 end = size - (size - m_headerBytes) % kCheckBytes;
+    if (end != size && !file.resize(end)) {
+        if (error) *error = "Failed to repair review session: " + file.errorString();
+        return false;
+    }
+
+    if (file.write(rec, kCheckBytes) != kCheckBytes || !file.flush()) {
+        if (error) *error = "Failed to write review session: " + file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool ReviewSessionFile::exists() const {
+    return QFileInfo::exists(m_filePath);
+}
+
+void ReviewSessionFile::remove() {
+    QFile::remove(m_filePath);
+    m_headerBytes = -1;
+}
+
+bool ReviewSessionFile::load(SessionHeader* header, QVector<SessionCheck>* checks, QString* error) const {
+    return read(header, checks, error);
+}
+
+bool ReviewSessionFile::loadHeader(SessionHeader* header, QString* error) const {
+    return read(header, nullptr, error);
+}
+
+bool ReviewSessionFile::read(SessionHeader* header, QVector<SessionCheck>* checks, QString* error) const {
+    if (error) error->clear();
+    QFile file(m_filePath);
+    if (!file.exists()) return false;
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = "Failed to open review session: " + m_filePath + " (" + file.errorString() + ")";
+        return false;
+    }
+    const QByteArray data = file.readAll();
+
+    auto bad = [&] {
+        if (error) *error = "Not a review session file (or an unsupported version): " + m_filePath;
+        return false;
+    };
+
+    Reader r{data};
+    if (!r.has(8 + 1 + 8 + 8 + 2)) return bad();
+    if (std::memcmp(r.take(4), kMagic, 4) != 0) return bad();
+    const quint32 version = qFromLittleEndian<quint32>(r.take(4));
+    if (version < 1 || version > kFormatVersion) return bad();
+
+    SessionHeader h;
+    h.order = static_cast<quint8>(*r.take(1));
+    h.horizonMsUtc = qFromLittleEndian<qint64>(r.take(8));
+    h.startedAtMsUtc = qFromLittleEndian<qint64>(r.take(8));
+    const int titleBytes = qFromLittleEndian<quint16>(r.take(2));
+    if (!r.has(titleBytes + 2)) return bad();
+    h.title = QString::fromUtf8(r.take(titleBytes), titleBytes);
+    const int folders = qFromLittleEndian<quint16>(r.take(2));
+    if (!r.has(qint64(folders) * 16)) return bad();
+    h.folderIds.reserve(folders);
+    for (int i = 0; i < folders; ++i)
+        h.folderIds.push_back(rewise::domain::Id{QUuid::fromRfc4122(QByteArray::fromRawData(r.take(16), 16))});
+    if (version >= 2) {
+        if (!r.has(4 + 4)) return bad();
+        h.seed = qFromLittleEndian<quint32>(r.take(4));
+        const qint64 cards = qFromLittleEndian<quint32>(r.take(4));
+        if (!r.has(cards * 16)) return bad();
+        h.cardIds.reserve(static_cast<int>(cards));
+        for (qint64 i = 0; i < cards; ++i)
+            h.cardIds.push_back(rewise::domain::Id{QUuid::fromRfc4122(QByteArray::fromRawData(r.take(16), 16))});
+    }
+
+    m_headerBytes = r.pos;
+
+    if (checks) {
+        checks->clear();
+        const qint64 count = (data.size() - r.pos) / kCheckBytes; // a torn last record is dropped
+        checks->reserve(static_cast<int>(count));
+        for (qint64 i = 0; i < count; ++i) {
+            const char* p = r.take(kCheckBytes);
+            SessionCheck c;
+            c.cardId = rewise::domain::Id{QUuid::fromRfc4122(QByteArray::fromRawData(p, 16))};
+            c.answerMs = qFromLittleEndian<quint32>(p + 16);
+            c.round = qFromLittleEndian<quint16>(p + 20);
+            c.percent = static_cast<quint8>(p[22]);
+            c.passed = (p[23] & 1) != 0;
+            checks->push_back(c);
+        }
+    }
+    if (header) *header = std::move(h);
+    return true;
+}
+
+} // namespace rewise::storage
@@ -0,0 +1,76 @@
+#ifndef REWISE_STORAGE_REVIEWSESSIONFILE_H
+#define REWISE_STORAGE_REVIEWSESSIONFILE_H
+
+#include "../domain/Id.h"
+
+#include <QString>
+#include <QVector>
+
+namespace rewise::storage {
+
+// What is needed to set up a review session again.
+struct SessionHeader final {
+    quint8 order = 0;                          // review::SessionOrder
+    qint64 horizonMsUtc = 0;                   // due sessions: cards due up to here
+    qint64 startedAtMsUtc = 0;
+    QString title;
+    QVector<rewise::domain::Id> folderIds;     // empty = all folders
+
+    // Shuffled and weighted sessions: their cards, in the order the deck was
+    // made from, and the deck's seed. Empty for due sessions (and files
+    // written before they were stored).
+    QVector<rewise::domain::Id> cardIds;
+    quint32 seed = 0;
+};
+
+// One check made in the session.
+struct SessionCheck final {
+    rewise::domain::Id cardId;
+    quint32 answerMs = 0;
+    quint16 round = 0;                         // pass of a shuffled deck, 0 otherwise
+    quint8 percent = 0;
+    bool passed = false;
+};
+
+// The running review session, kept in a small file next to the database so it
+// can be resumed after leaving the page, a restart or a crash:
+//   [magic "RWSN"][u32 version][u8 order][i64 horizon][i64 started]
+//   [u16 title bytes][title utf8][u16 folders][folders x 16-byte id]
+//   [u32 seed][u32 cards][cards x 16-byte id]                      (version 2)
+//   checks x kCheckBytes: [16-byte card id][u32 answer ms][u16 round][u8 percent][u8 flags]
+// begin() writes the header, every check appends one record (no rewrite).
+// A torn last record is ignored on load and cut off before the next append.
+// Due sessions set their order up again from the due index and the checks;
+// shuffled and weighted ones from the card list and seed in the header, so a
+// shuffled deck deals the same passes after a restart. Version 1 files (no
+// card list) are still read.
+class ReviewSessionFile final {
+public:
+    static constexpr int kCheckBytes = 24;
+
+    explicit ReviewSessionFile(QString filePath);
+
+    // Starts a new session (replaces the previous one).
+    bool begin(const SessionHeader& header, QString* error = nullptr);
+    bool appendCheck(const SessionCheck& check, QString* error = nullptr);
+
+    bool exists() const;
+    // Fails with an empty *error if there is no session.
+    bool load(SessionHeader* header, QVector<SessionCheck>* checks, QString* error = nullptr) const;
+    // Just the header (for "resume <title>" offers).
+    bool loadHeader(SessionHeader* header, QString* error = nullptr) const;
+    // The session is over.
+    void remove();
+
+    QString filePath() const { return m_filePath; }
+
+private:
+    bool read(SessionHeader* header, QVector<SessionCheck>* checks, QString* error) const;
+
+    QString m_filePath;
+    mutable qint64 m_headerBytes = -1;   // where the checks start; -1 = not read yet
+};
+
+} // namespace rewise::storage
+
+#endif // REWISE_STORAGE_REVIEWSESSIONFILE_H
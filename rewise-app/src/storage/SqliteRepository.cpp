@@ -0,0 +1,678 @@
+#include "SqliteRepository.h"
+#include "CardBodyStore.h"
+#include "Repository.h"
+
+#include <QAtomicInt>
+#include <QDir>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThreadStorage>
+#include <QVariant>
+
+#include <utility>
+
+namespace rewise::storage {
+
+using rewise::domain::Folder;
+using rewise::domain::Card;
+using rewise::domain::Id;
+
+namespace {
+
+const char* const kSchema[] = {
+    "CREATE TABLE IF NOT EXISTS meta ("
+    "  key   TEXT PRIMARY KEY,"
+    "  value TEXT NOT NULL)",
+
+    "CREATE TABLE IF NOT EXISTS folders ("
+    "  id       BLOB PRIMARY KEY,"
+    "  name     TEXT NOT NULL,"
+    "  position INTEGER NOT NULL)",
+
+    "CREATE TABLE IF NOT EXISTS cards ("
+    "  id         BLOB PRIMARY KEY,"
+    "  folder_id  BLOB NOT NULL,"
+    "  question   TEXT NOT NULL,"
+    "  answer     TEXT NOT NULL,"
+    "  created_at INTEGER NOT NULL,"
+    "  updated_at INTEGER NOT NULL)",
+
+    "CREATE INDEX IF NOT EXISTS cards_by_folder ON cards(folder_id, updated_at)",
+
+    // Schedules live beside the cards: new cards have no row, and stores
+    // written before scheduling existed need no migration.
+    "CREATE TABLE IF NOT EXISTS card_reviews ("
+    "  card_id        BLOB PRIMARY KEY,"
+    "  due_at         INTEGER NOT NULL,"
+    "  last_review_at INTEGER NOT NULL,"
+    "  interval_days  INTEGER NOT NULL,"
+    "  repetitions    INTEGER NOT NULL,"
+    "  lapses         INTEGER NOT NULL,"
+    "  ease           REAL NOT NULL)",
+
+    // Scoring settings of folders that don't use the defaults (same reasoning).
+    "CREATE TABLE IF NOT EXISTS folder_settings ("
+    "  folder_id          BLOB PRIMARY KEY,"
+    "  ignore_case        INTEGER NOT NULL,"
+    "  simplify_spaces    INTEGER NOT NULL,"
+    "  ignore_punctuation INTEGER NOT NULL,"
+    "  metric             INTEGER NOT NULL,"
+    "  pass_percent       INTEGER NOT NULL)",
+};
+
+const char* const kUpsertFolder =
+    "INSERT INTO folders(id, name, position) VALUES(?, ?, ?) "
+    "ON CONFLICT(id) DO UPDATE SET name = excluded.name, position = excluded.position";
+
+const char* const kUpsertFolderSettings =
+    "INSERT OR REPLACE INTO folder_settings(folder_id, ignore_case, simplify_spaces, ignore_punctuation, metric, pass_percent) "
+    "VALUES(?, ?, ?, ?, ?, ?)";
+
+const char* const kUpsertCard =
+    "INSERT INTO cards(id, folder_id, question, answer, created_at, updated_at) VALUES(?, ?, ?, ?, ?, ?) "
+    "ON CONFLICT(id) DO UPDATE SET folder_id = excluded.folder_id, question = excluded.question, "
+    "answer = excluded.answer, created_at = excluded.created_at, updated_at = excluded.updated_at";
+
+const char* const kUpsertReview =
+    "INSERT OR REPLACE INTO card_reviews(card_id, due_at, last_review_at, interval_days, repetitions, lapses, ease) "
+    "VALUES(?, ?, ?, ?, ?, ?, ?)";
+
+const char* const kCardColumns =
+    "c.id, c.folder_id, c.question, c.answer, c.created_at, c.updated_at, "
+    "r.due_at, r.last_review_at, r.interval_days, r.repetitions, r.lapses, r.ease";
+const char* const kCardSource = "cards c LEFT JOIN card_reviews r ON r.card_id = c.id";
+
+// Lazy-body load: same columns, text cut to the preview length (%1), plus whether it was cut.
+const char* const kLazyCardColumns =
+    "c.id, c.folder_id, substr(c.question, 1, %1), substr(c.answer, 1, %1), c.created_at, c.updated_at, "
+    "r.due_at, r.last_review_at, r.interval_days, r.repetitions, r.lapses, r.ease, "
+    "length(c.question) > %1 OR length(c.answer) > %1";
+
+const char* const kUpdateCardMetadata =
+    "UPDATE cards SET folder_id = ?, created_at = ?, updated_at = ? WHERE id = ?";
+
+// The text of a row that may back a lazy card (some field longer than the preview).
+const char* const kSelectLongBody =
+    "SELECT question, answer FROM cards WHERE id = ? AND (length(question) > ? OR length(answer) > ?)";
+
+QByteArray idBlob(const Id& id) {
+    return id.value.toRfc4122();
+}
+
+Id idFromBlob(const QVariant& v) {
+    return Id{QUuid::fromRfc4122(v.toByteArray())};
+}
+
+bool fail(const QSqlError& e, const QString& what, QString* error) {
+    if (error) *error = what + ": " + e.text();
+    return false;
+}
+
+bool execSql(QSqlDatabase& db, const QString& sql, QString* error) {
+    QSqlQuery q(db);
+    if (!q.exec(sql)) return fail(q.lastError(), "SQL failed (" + sql + ")", error);
+    return true;
+}
+
+Card cardFromRow(const QSqlQuery& q) {
+    Card c;
+    c.id = idFromBlob(q.value(0));
+    c.folderId = idFromBlob(q.value(1));
+    c.question = q.value(2).toString();
+    c.answer = q.value(3).toString();
+    c.createdAtMsUtc = q.value(4).toLongLong();
+    c.updatedAtMsUtc = q.value(5).toLongLong();
+    if (!q.value(6).isNull()) {
+        c.review.dueAtMsUtc = q.value(6).toLongLong();
+        c.review.lastReviewAtMsUtc = q.value(7).toLongLong();
+        c.review.intervalDays = q.value(8).toInt();
+        c.review.repetitions = q.value(9).toInt();
+        c.review.lapses = q.value(10).toInt();
+        c.review.ease = q.value(11).toDouble();
+    }
+    return c;
+}
+
+bool execDeleteById(QSqlQuery& q, const Id& id, QString* error) {
+    q.bindValue(0, idBlob(id));
+    if (!q.exec()) return fail(q.lastError(), "Failed to delete row", error);
+    return true;
+}
+
+// Prepared statements for writing a card together with its schedule row.
+struct CardWriter final {
+    QSqlQuery upsert;
+    QSqlQuery updateMetadata;
+    QSqlQuery upsertReview;
+    QSqlQuery deleteReview;
+    QSqlQuery selectLongBody;
+
+    explicit CardWriter(const QSqlDatabase& conn)
+        : upsert(conn), updateMetadata(conn), upsertReview(conn), deleteReview(conn), selectLongBody(conn) {}
+
+    bool prepare(QString* error) {
+        if (!upsert.prepare(kUpsertCard)) return fail(upsert.lastError(), "Failed to prepare card upsert", error);
+        if (!updateMetadata.prepare(kUpdateCardMetadata)) {
+            return fail(updateMetadata.lastError(), "Failed to prepare card update", error);
+        }
+        if (!upsertReview.prepare(kUpsertReview)) return fail(upsertReview.lastError(), "Failed to prepare review upsert", error);
+        if (!deleteReview.prepare("DELETE FROM card_reviews WHERE card_id = ?")) {
+            return fail(deleteReview.lastError(), "Failed to prepare review delete", error);
+        }
+        if (!selectLongBody.prepare(kSelectLongBody)) {
+            return fail(selectLongBody.lastError(), "Failed to prepare body select", error);
+        }
+        return true;
+    }
+
+    bool write(const Card& c, QString* error) {
+        upsert.bindValue(0, idBlob(c.id));
+        upsert.bindValue(1, idBlob(c.folderId));
+        upsert.bindValue(2, c.question);
+        upsert.bindValue(3, c.answer);
+        upsert.bindValue(4, c.createdAtMsUtc);
+        upsert.bindValue(5, c.updatedAtMsUtc);
+        if (!upsert.exec()) return fail(upsert.lastError(), "Failed to upsert card", error);
+        return writeReview(c, error);
+    }
+
+    // Lazy card whose row still holds its text: everything but the text.
+    bool writeMetadata(const Card& c, QString* error) {
+        updateMetadata.bindValue(0, idBlob(c.folderId));
+        updateMetadata.bindValue(1, c.createdAtMsUtc);
+        updateMetadata.bindValue(2, c.updatedAtMsUtc);
+        updateMetadata.bindValue(3, idBlob(c.id));
+        if (!updateMetadata.exec()) return fail(updateMetadata.lastError(), "Failed to update card", error);
+        if (updateMetadata.numRowsAffected() != 1) {
+            if (error) *error = "Card row is missing: " + c.id.toString();
+            return false;
+        }
+        return writeReview(c, error);
+    }
+
+    bool writeReview(const Card& c, QString* error) {
+        if (c.review.isNew()) return execDeleteById(deleteReview, c.id, error);
+
+        upsertReview.bindValue(0, idBlob(c.id));
+        upsertReview.bindValue(1, c.review.dueAtMsUtc);
+        upsertReview.bindValue(2, c.review.lastReviewAtMsUtc);
+        upsertReview.bindValue(3, c.review.intervalDays);
+        upsertReview.bindValue(4, c.review.repetitions);
+        upsertReview.bindValue(5, c.review.lapses);
+        upsertReview.bindValue(6, c.review.ease);
+        if (!upsertReview.exec()) return fail(upsertReview.lastError(), "Failed to upsert review state", error);
+        return true;
+    }
+};
+
+} // namespace
+
+namespace {
+
+// A body store's read-only connection for one thread. QThreadStorage deletes it
+// on that thread when the thread exits, which is where Qt SQL wants it closed.
+struct ThreadConnection final {
+    QString name;
+
+    ~ThreadConnection() {
+        {
+            QSqlDatabase db = QSqlDatabase::database(name, false);
+            db.close();
+        }
+        QSqlDatabase::removeDatabase(name);
+    }
+};
+
+QAtomicInt nextThreadConnection;
+
+} // namespace
+
+// Lazy bodies read back from the `cards` rows. Qt SQL connections belong to the
+// thread that made them, and bodies are also read on QtConcurrent workers (review
+// prefetch, exam grading, search), so every reading thread gets its own read-only
+// connection. WAL lets them read while the GUI thread's connection writes.
+class SqliteBodyStore final : public CardBodyStore {
+public:
+    SqliteBodyStore(QString filePath, QString connectionPrefix)
+        : m_filePath(std::move(filePath)), m_connectionPrefix(std::move(connectionPrefix)) {}
+
+    // Only this thread's connection can be closed here; the others close when
+    // their (pool) threads exit.
+    ~SqliteBodyStore() override {
+        if (m_connections.hasLocalData()) m_connections.setLocalData(nullptr);
+    }
+
+    // Start of a save: preserve() stamps what it keeps with this generation.
+    void beginSave() {
+        QMutexLocker locker(&m_lock);
+        ++m_generation;
+    }
+
+    quint64 saveGeneration() const override {
+        QMutexLocker locker(&m_lock);
+        return m_generation;
+    }
+
+    void releaseBefore(quint64 generation) override {
+        QMutexLocker locker(&m_lock);
+        for (auto it = m_preserved.begin(); it != m_preserved.end();) {
+            if (it->generation < generation) it = m_preserved.erase(it);
+            else ++it;
+        }
+    }
+
+    // Call before a row is rewritten or deleted (inside the save transaction).
+    // Keeps the text the row had at load time if it may back a lazy card, so
+    // lazy cards of older versions (undo) keep resolving to their own text.
+    bool preserve(QSqlQuery& selectLongBody, const Id& id, QString* error) {
+        {
+            QMutexLocker locker(&m_lock);
+            const auto it = m_preserved.find(id);
+            if (it != m_preserved.end()) {
+                // Already holds the load-time text; versions up to now may read it.
+                it->generation = m_generation;
+                return true;
+            }
+        }
+        selectLongBody.bindValue(0, idBlob(id));
+        selectLongBody.bindValue(1, kPreviewChars);
+        selectLongBody.bindValue(2, kPreviewChars);
+        if (!selectLongBody.exec()) return fail(selectLongBody.lastError(), "Failed to read card body", error);
+        if (selectLongBody.next()) {
+            CardBody body{selectLongBody.value(0).toString(), selectLongBody.value(1).toString()};
+            QMutexLocker locker(&m_lock);
+            m_preserved.insert(id, Preserved{std::move(body), m_generation});
+        }
+        selectLongBody.finish();
+        return true;
+    }
+
+    bool scan(const std::function<void(const Id&, const CardBody&)>& visit, QString* error) const override {
+        // Preserved text wins over the row, as in readBody().
+        QHash<Id, Preserved> preserved;
+        {
+            QMutexLocker locker(&m_lock);
+            preserved = m_preserved;
+        }
+
+        QSqlDatabase conn;
+        if (!threadConnection(&conn, error)) return false;
+
+        QSqlQuery q(conn);
+        q.setForwardOnly(true);
+        q.prepare("SELECT id, question, answer FROM cards WHERE length(question) > ? OR length(answer) > ?");
+        q.addBindValue(kPreviewChars);
+        q.addBindValue(kPreviewChars);
+        if (!q.exec()) return fail(q.lastError(), "Failed to read card bodies", error);
+        while (q.next()) {
+            const Id id = idFromBlob(q.value(0));
+            if (preserved.contains(id)) continue;
+            visit(id, CardBody{q.value(1).toString(), q.value(2).toString()});
+        }
+        for (auto it = preserved.cbegin(); it != preserved.cend(); ++it) visit(it.key(), it->body);
+        return true;
+    }
+
+    // Text kept by preserve(): the row no longer holds what lazy cards refer to.
+    bool preserved(const Id& id, CardBody* out) const {
+        QMutexLocker locker(&m_lock);
+        const auto it = m_preserved.constFind(id);
+        if (it == m_preserved.constEnd()) return false;
+        *out = it->body;
+        return true;
+    }
+
+protected:
+    bool readBody(const Id& id, CardBody* out, QString* error) const override {
+        if (preserved(id, out)) return true;
+
+        QSqlDatabase conn;
+        if (!threadConnection(&conn, error)) return false;
+
+        QSqlQuery q(conn);
+        q.setForwardOnly(true);
+        q.prepare("SELECT question, answer FROM cards WHERE id = ?");
+        q.addBindValue(idBlob(id));
+        if (!q.exec()) return fail(q.lastError(), "Failed to read card body", error);
+        if (!q.next()) {
+            if (error) *error = "Card body not found: " + id.toString();
+            return false;
+        }
+        out->question = q.value(0).toString();
+        out->answer = q.value(1).toString();
+        return true;
+    }
+
+private:
+    struct Preserved final {
+        CardBody body;
+        quint64 generation = 0;            // last save that needed it kept
+    };
+
+    bool threadConnection(QSqlDatabase* out, QString* error) const {
+        if (!m_connections.hasLocalData()) {
+            auto* c = new ThreadConnection{m_connectionPrefix + QString::number(nextThreadConnection.fetchAndAddRelaxed(1))};
+            QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", c->name);
+            db.setDatabaseName(m_filePath);
+            db.setConnectOptions("QSQLITE_OPEN_READONLY");
+            m_connections.setLocalData(c);
+        }
+
+        *out = QSqlDatabase::database(m_connections.localData()->name, false);
+        if (!out->isOpen() && !out->open()) return fail(out->lastError(), "Failed to open " + m_filePath, error);
+        return true;
+    }
+
+    QString m_filePath;
+    QString m_connectionPrefix;
+    mutable QThreadStorage<ThreadConnection*> m_connections;
+    mutable QMutex m_lock;
+    quint64 m_generation = 0;              // guarded by m_lock
+    QHash<Id, Preserved> m_preserved;      // guarded by m_lock
+};
+
+SqliteRepository::SqliteRepository(QString fileName)
+    : m_fileName(std::move(fileName))
+    , m_connectionName(QString("rewise-sqlite-%1").arg(reinterpret_cast<quintptr>(this), 0, 16))
+{}
+
+SqliteRepository::~SqliteRepository() {
+    if (!QSqlDatabase::contains(m_connectionName)) return;
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName, false);
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(m_connectionName);
+}
+
+QString SqliteRepository::databaseFilePath() const {
+    QDir dir(databaseDirPath());
+    return dir.filePath(m_fileName);
+}
+
+QSqlDatabase SqliteRepository::connection() const {
+    return QSqlDatabase::database(m_connectionName, false);
+}
+
+bool SqliteRepository::open(QString* error) const {
+    if (QSqlDatabase::contains(m_connectionName) && connection().isOpen()) return true;
+    if (!ensureDatabaseDir(error)) return false;
+
+    QSqlDatabase db = QSqlDatabase::contains(m_connectionName)
+                          ? connection()
+                          : QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
+    db.setDatabaseName(databaseFilePath());
+    if (!db.open()) return fail(db.lastError(), "Failed to open " + databaseFilePath(), error);
+
+    // WAL: readers don't block the writer, and small commits are a cheap append.
+    if (!execSql(db, "PRAGMA journal_mode=WAL", error)) return false;
+    if (!execSql(db, "PRAGMA synchronous=NORMAL", error)) return false;
+
+    return ensureSchema(error);
+}
+
+bool SqliteRepository::ensureSchema(QString* error) const {
+    QSqlDatabase db = connection();
+    for (const char* sql : kSchema) {
+        if (!execSql(db, sql, error)) return false;
+    }
+
+    QSqlQuery q(db);
+    q.prepare("INSERT OR IGNORE INTO meta(key, value) VALUES('schema_version', ?)");
+    q.addBindValue(json_keys::kSchemaVersion);
+    if (!q.exec()) return fail(q.lastError(), "Failed to write schema version", error);
+    return true;
+}
+
+bool SqliteRepository::readAll(Database* outDb, QString* error) const {
+    QSqlDatabase conn = connection();
+    Database db;
+
+    {
+        QSqlQuery q(conn);
+        q.prepare("SELECT value FROM meta WHERE key = 'schema_version'");
+        if (!q.exec()) return fail(q.lastError(), "Failed to read schema version", error);
+        if (q.next()) db.version = q.value(0).toInt();
+    }
+
+    {
+        QSqlQuery q(conn);
+        q.setForwardOnly(true);
+        if (!q.exec("SELECT f.id, f.name, s.ignore_case, s.simplify_spaces, s.ignore_punctuation, s.metric, s.pass_percent "
+                    "FROM folders f LEFT JOIN folder_settings s ON s.folder_id = f.id ORDER BY f.position")) {
+            return fail(q.lastError(), "Failed to read folders", error);
+        }
+        while (q.next()) {
+            Folder f;
+            f.id = idFromBlob(q.value(0));
+            f.name = q.value(1).toString();
+            if (!q.isNull(2)) {
+                f.scoring.ignoreCase = q.value(2).toBool();
+                f.scoring.simplifySpaces = q.value(3).toBool();
+                f.scoring.ignorePunctuation = q.value(4).toBool();
+                f.scoring.metric = (q.value(5).toInt() == static_cast<int>(rewise::domain::ScoreMetric::Words))
+                                       ? rewise::domain::ScoreMetric::Words
+                                       : rewise::domain::ScoreMetric::Characters;
+                f.scoring.passPercent = qBound(1, q.value(6).toInt(), 100);
+            }
+            db.folders.push_back(f);
+        }
+    }
+
+    {
+        QSqlQuery q(conn);
+        q.setForwardOnly(true);
+        const QString columns = m_lazyBodies ? QString(kLazyCardColumns).arg(CardBodyStore::kPreviewChars)
+                                             : QString(kCardColumns);
+        if (!q.exec(QString("SELECT %1 FROM %2").arg(columns, QLatin1String(kCardSource)))) {
+            return fail(q.lastError(), "Failed to read cards", error);
+        }
+        while (q.next()) {
+            Card c = cardFromRow(q);
+            if (m_lazyBodies && q.value(12).toBool()) {
+                // substr() counts code points; the preview is in UTF-16 units.
+                c.question = CardBodyStore::preview(c.question);
+                c.answer = CardBodyStore::preview(c.answer);
+                c.textIsPreview = true;
+            }
+            db.cards.push_back(c);
+        }
+    }
+
+    if (m_lazyBodies) {
+        m_bodies = std::make_shared<SqliteBodyStore>(databaseFilePath(), m_connectionName + "-body-");
+        db.setBodyStore(m_bodies);
+    }
+
+    db.rebuildIndexes();
+    *outDb = db;
+    return true;
+}
+
+bool SqliteRepository::importFromJson(Database* outDb, QString* error) const {
+    Database db;
+
+    const Repository json("db.json");
+    if (json.exists()) {
+        if (!json.readExisting(&db, error)) return false;
+    }
+    if (!finishLoad(&db, error)) return false;
+
+    // One bulk transaction for the whole import. The JSON files are left untouched.
+    db.markAllPending();
+    if (!save(db, error)) return false;
+    db.clearPendingChanges();
+
+    QSqlQuery q(connection());
+    q.prepare("INSERT OR REPLACE INTO meta(key, value) VALUES('imported_from', ?)");
+    q.addBindValue(json.exists() ? QStringLiteral("json") : QStringLiteral("none"));
+    if (!q.exec()) return fail(q.lastError(), "Failed to record import", error);
+
+    *outDb = db;
+    return true;
+}
+
+bool SqliteRepository::load(Database* outDb, QString* error) const {
+    if (!outDb) {
+        if (error) *error = "SqliteRepository::load: outDb is null.";
+        return false;
+    }
+
+    if (!open(error)) return false;
+
+    Database db;
+    if (!readAll(&db, error)) return false;
+
+    // A store without folders has never been written: first run or first switch
+    // from JSON. Import once; afterwards the store always has a default folder.
+    if (db.folders.isEmpty() && db.cards.isEmpty()) {
+        return importFromJson(outDb, error);
+    }
+
+    if (!finishLoad(&db, error)) return false;
+
+    // Any self-heal changes stay pending, so the next save persists them.
+    *outDb = db;
+    return true;
+}
+
+bool SqliteRepository::save(const Database& db, QString* error) const {
+    const PendingChanges& changes = db.pendingChanges();
+    if (changes.isEmpty()) return true;
+
+    if (!open(error)) return false;
+
+    QSqlDatabase conn = connection();
+    if (!conn.transaction()) return fail(conn.lastError(), "Failed to begin transaction", error);
+
+    if (!writeChanges(db, changes, error)) {
+        conn.rollback();
+        return false;
+    }
+
+    if (!conn.commit()) {
+        const QSqlError e = conn.lastError();
+        conn.rollback();
+        return fail(e, "Failed to commit", error);
+    }
+    return true;
+}
+
+bool SqliteRepository::writeChanges(const Database& db, const PendingChanges& changes, QString* error) const {
+    QSqlDatabase conn = connection();
+
+    if (changes.everything) {
+        if (!execSql(conn, "DELETE FROM card_reviews", error)) return false;
+        if (!execSql(conn, "DELETE FROM cards", error)) return false;
+        if (!execSql(conn, "DELETE FROM folder_settings", error)) return false;
+        if (!execSql(conn, "DELETE FROM folders", error)) return false;
+    }
+
+    // Folders: few rows; positions encode order, so rewrite all of them when the list changed.
+    if (changes.everything || changes.manifest) {
+        QSqlQuery upsert(conn);
+        if (!upsert.prepare(kUpsertFolder)) return fail(upsert.lastError(), "Failed to prepare folder upsert", error);
+        QSqlQuery upsertSettings(conn);
+        if (!upsertSettings.prepare(kUpsertFolderSettings)) {
+            return fail(upsertSettings.lastError(), "Failed to prepare folder settings upsert", error);
+        }
+        QSqlQuery deleteSettings(conn);
+        if (!deleteSettings.prepare("DELETE FROM folder_settings WHERE folder_id = ?")) {
+            return fail(deleteSettings.lastError(), "Failed to prepare folder settings delete", error);
+        }
+
+        for (int i = 0; i < db.folders.size(); ++i) {
+            const Folder& f = db.folders[i];
+            upsert.bindValue(0, idBlob(f.id));
+            upsert.bindValue(1, f.name);
+            upsert.bindValue(2, i);
+            if (!upsert.exec()) return fail(upsert.lastError(), "Failed to upsert folder", error);
+
+            if (f.scoring.isDefault()) {
+                if (!execDeleteById(deleteSettings, f.id, error)) return false;
+                continue;
+            }
+            upsertSettings.bindValue(0, idBlob(f.id));
+            upsertSettings.bindValue(1, f.scoring.ignoreCase ? 1 : 0);
+            upsertSettings.bindValue(2, f.scoring.simplifySpaces ? 1 : 0);
+            upsertSettings.bindValue(3, f.scoring.ignorePunctuation ? 1 : 0);
+            upsertSettings.bindValue(4, static_cast<int>(f.scoring.metric));
+            upsertSettings.bindValue(5, f.scoring.passPercent);
+            if (!upsertSettings.exec()) return fail(upsertSettings.lastError(), "Failed to upsert folder settings", error);
+        }
+    }
+
+    if (!changes.removedFolders.isEmpty()) {
+        QSqlQuery del(conn);
+        if (!del.prepare("DELETE FROM folders WHERE id = ?")) return fail(del.lastError(), "Failed to prepare folder delete", error);
+        QSqlQuery delSettings(conn);
+        if (!delSettings.prepare("DELETE FROM folder_settings WHERE folder_id = ?")) {
+            return fail(delSettings.lastError(), "Failed to prepare folder settings delete", error);
+        }
+        for (const Id& id : changes.removedFolders) {
+            if (!execDeleteById(del, id, error)) return false;
+            if (!execDeleteById(delSettings, id, error)) return false;
+        }
+    }
+
+    // Cards: one row per changed card.
+    CardWriter writer(conn);
+    if (!writer.prepare(error)) return false;
+
+    // Lazy bodies only concern the database this repository loaded them into.
+    SqliteBodyStore* bodies = (m_bodies && db.bodyStore() == m_bodies) ? m_bodies.get() : nullptr;
+    if (bodies) bodies->beginSave();
+
+    if (changes.everything) {
+        if (bodies) {
+            if (error) *error = "A store with lazy card bodies can't be rewritten as a whole.";
+            return false;
+        }
+        Card full;
+        for (int i = 0; i < db.cards.size(); ++i) {
+            if (!db.fullCard(i, &full, error)) return false;
+            if (!writer.write(full, error)) return false;
+        }
+    } else {
+        for (const Id& id : changes.cards) {
+            const int idx = db.cardIndexById(id);
+            if (idx < 0) continue;
+            const Card& c = db.cards[idx];
+            if (c.hasFullText()) {
+                if (bodies && !bodies->preserve(writer.selectLongBody, id, error)) return false;
+                Card full;
+                if (!db.fullCard(idx, &full, error) || !writer.write(full, error)) return false;
+                continue;
+            }
+
+            // Lazy: the row still holds the card's text, unless it was rewritten since
+            // the load and this version came back (undo); then write the text back too.
+            CardBody body;
+            if (bodies && bodies->preserved(id, &body)) {
+                Card full = c;
+                full.setText(body.question, body.answer);
+                if (!writer.write(full, error)) return false;
+            } else if (!writer.writeMetadata(c, error)) {
+                return false;
+            }
+        }
+    }
+
+    if (!changes.removedCards.isEmpty()) {
+        QSqlQuery del(conn);
+        if (!del.prepare("DELETE FROM cards WHERE id = ?")) return fail(del.lastError(), "Failed to prepare card delete", error);
+        for (const Id& id : changes.removedCards) {
+            if (bodies && !bodies->preserve(writer.selectLongBody, id, error)) return false;
+            if (!execDeleteById(del, id, error)) return false;
+            if (!execDeleteById(writer.deleteReview, id, error)) return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace rewise::storage
@@ -0,0 +1,64 @@
+#ifndef REWISE_STORAGE_SQLITEREPOSITORY_H
+#define REWISE_STORAGE_SQLITEREPOSITORY_H
+
+#include "StorageBackend.h"
+
+#include <QString>
+#include <QVector>
+
+#include <memory>
+
+class QSqlDatabase;
+
+namespace rewise::storage {
+
+class SqliteBodyStore;
+
+// Embedded SQLite backend (Qt SQL, QSQLITE driver; no server).
+// - folders/cards tables keyed by the 16-byte binary UUID, cards indexed by folder_id
+// - WAL journal, one transaction per save, prepared statements reused across rows
+// - save() turns pending changes into single-row UPSERTs/DELETEs
+// - optional lazy bodies: long card text stays in the `cards` rows (see CardBodyStore)
+// An empty store imports the JSON database (db.json or shards) once on first load.
+class SqliteRepository final : public StorageBackend {
+public:
+    explicit SqliteRepository(QString fileName = "rewise.sqlite");
+    ~SqliteRepository() override;
+
+    SqliteRepository(const SqliteRepository&) = delete;
+    SqliteRepository& operator=(const SqliteRepository&) = delete;
+
+    bool load(Database* outDb, QString* error = nullptr) const override;
+    bool save(const Database& db, QString* error = nullptr) const override;
+    QString storagePath() const override { return databaseFilePath(); }
+
+    // Absolute full path to the SQLite file (AppDataLocation/<fileName>).
+    QString databaseFilePath() const;
+
+    // Lazy bodies for the next load(): cards with a field longer than
+    // CardBodyStore::kPreviewChars keep only a preview in memory and read the
+    // full text back from their row on demand. Shorter cards stay resident.
+    void setLazyBodies(bool on) { m_lazyBodies = on; }
+
+private:
+    bool open(QString* error) const;
+    QSqlDatabase connection() const;
+    bool ensureSchema(QString* error) const;
+
+    // Reads the store as is (no self-heal).
+    bool readAll(Database* outDb, QString* error) const;
+
+    // One-shot import of the JSON database into the (empty) store.
+    bool importFromJson(Database* outDb, QString* error) const;
+
+    bool writeChanges(const Database& db, const PendingChanges& changes, QString* error) const;
+
+    QString m_fileName;
+    QString m_connectionName;
+    bool m_lazyBodies = false;
+    mutable std::shared_ptr<SqliteBodyStore> m_bodies; // of the last lazy load
+};
+
+} // namespace rewise::storage
+
+#endif // REWISE_STORAGE_SQLITEREPOSITORY_H
@@ -0,0 +1,92 @@
+#include "StorageBackend.h"
+#include "StorageJson.h"
+
+#include <QStandardPaths>
+#include <QDir>
+
+namespace rewise::storage {
+
+using rewise::domain::Folder;
+using rewise::domain::Card;
+using rewise::domain::Id;
+
+QString StorageBackend::databaseDirPath() {
+    // AppDataLocation is an application-specific persistent data directory.
+    // It depends on QCoreApplication (app/organization name), but Qt guarantees non-empty.
+    const QString base = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+
+    // Some apps forget to set appName; still return something stable.
+    // Usually base already includes app name, so we don’t append more folders here.
+    return base;
+}
+
+bool StorageBackend::ensureDatabaseDir(QString* error) {
+    const QString dirPath = databaseDirPath();
+    QDir dir(dirPath);
+    if (dir.exists()) return true;
+
+    if (!dir.mkpath(".")) {
+        if (error) *error = "Failed to create database directory: " + dirPath;
+        return false;
+    }
+    return true;
+}
+
+void StorageBackend::ensureDefaults(Database* db) {
+    if (!db) return;
+
+    // Ensure at least one folder exists.
+    const Id defaultId = db->ensureDefaultFolder("Default");
+    (void)defaultId;
+
+    // Optional: ensure folder names are unique (nice to have).
+    db->ensureUniqueFolderNames();
+}
+
+void StorageBackend::repairOrphans(Database* db) {
+    if (!db) return;
+
+    // Ensure we have at least one folder.
+    ensureDefaults(db);
+
+    // Find orphan cards.
+    QVector<Id> orphanIds;
+    for (const Card& c : db->cards) {
+        if (db->folderIndexById(c.folderId) < 0) orphanIds.push_back(c.id);
+    }
+    if (orphanIds.isEmpty()) return;
+
+    // Create "Orphaned" folder once.
+    Folder orphanFolder;
+    orphanFolder.id = Id::create();
+    orphanFolder.name = "Orphaned";
+    db->addFolder(orphanFolder);
+
+    const Id orphanId = orphanFolder.id;
+    for (const Id& cardId : orphanIds) {
+        db->moveCard(cardId, orphanId);
+        db->cardById(cardId)->touchUpdatedNow();
+    }
+}
+
+bool StorageBackend::finishLoad(Database* db, QString* error) {
+    // Handle versioning (currently only v1).
+    if (db->version != json_keys::kSchemaVersion) {
+        if (error) *error = QString("Unsupported DB schema version: %1").arg(db->version);
+        return false;
+    }
+
+    // Self-heal minimal invariants.
+    ensureDefaults(db);
+    repairOrphans(db);
+
+    // Final validation.
+    QString why;
+    if (!db->validate(&why)) {
+        if (error) *error = "Database validation failed: " + why;
+        return false;
+    }
+    return true;
+}
+
+} // namespace rewise::storage
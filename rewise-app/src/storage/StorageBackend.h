@@ -0,0 +1,48 @@
+#ifndef REWISE_STORAGE_STORAGEBACKEND_H
+#define REWISE_STORAGE_STORAGEBACKEND_H
+
+#include "Database.h"
+
+#include <QString>
+
+namespace rewise::storage {
+
+// Persistence for a Database. Implementations:
+// - Repository:       JSON files (single db.json or per-folder shards)
+// - SqliteRepository: embedded SQLite (QSQLITE)
+class StorageBackend {
+public:
+    virtual ~StorageBackend() = default;
+
+    // Load database. If there is nothing yet, creates a fresh DB with a default folder.
+    // Self-heals (default folder, orphans) and runs the full validator.
+    virtual bool load(Database* outDb, QString* error = nullptr) const = 0;
+
+    // Persist what db.pendingChanges() lists (implementations may write more).
+    // The caller clears pending changes after a successful save.
+    virtual bool save(const Database& db, QString* error = nullptr) const = 0;
+
+    // Human-readable location (file or directory) for diagnostics.
+    virtual QString storagePath() const = 0;
+
+    // Absolute directory that contains the DB (AppDataLocation).
+    static QString databaseDirPath();
+
+protected:
+    StorageBackend() = default;
+
+    static bool ensureDatabaseDir(QString* error = nullptr);
+
+    // Self-heal + full validation after a raw load.
+    static bool finishLoad(Database* db, QString* error);
+
+    // If folders empty, create "Default".
+    static void ensureDefaults(Database* db);
+
+    // If there are orphaned cards (folderId missing), move them into a generated "Orphaned" folder.
+    static void repairOrphans(Database* db);
+};
+
+} // namespace rewise::storage
+
+#endif // REWISE_STORAGE_STORAGEBACKEND_H
@@ -10,6 +10,14 @@ inline constexpr const char* kVersion = "version";
 inline constexpr const char* kFolders = "folders";
 inline constexpr const char* kCards = "cards";
 
+// Sharded layout: <dir>/shards/manifest.json + <dir>/shards/<folderId>.json
+inline constexpr const char* kShardsDirName    = "shards";
+inline constexpr const char* kManifestFileName = "manifest.json";
+inline constexpr const char* kShardSuffix      = ".json";
+
+// Shard keys (plus kVersion/kCards)
+inline constexpr const char* kFolderId = "folderId";
+
 } // namespace rewise::storage::json_keys
 
 #endif // REWISE_STORAGE_STORAGEJSON_H
@@ -0,0 +1,38 @@
+#include "TextArena.h"
+
+namespace rewise::storage {
+
+TextArena::Ref TextArena::append(const QString& text) {
+    Ref ref;
+    if (text.isEmpty()) return ref;
+
+    const QByteArray utf8 = text.toUtf8();
+    const int n = utf8.size();
+    if (m_chunks.isEmpty() || m_chunks.last().size() + n > kChunkBytes) {
+        // Longer texts get a chunk of their own.
+        QByteArray chunk;
+        chunk.reserve(qMax(n, int(kChunkBytes)));
+        m_chunks.push_back(chunk);
+    }
+
+    QByteArray& tail = m_chunks.last();
+    ref.chunk = static_cast<quint32>(m_chunks.size() - 1);
+    ref.offset = static_cast<quint32>(tail.size());
+    ref.length = static_cast<quint32>(n);
+    tail.append(utf8);
+    m_bytes += n;
+    return ref;
+}
+
+QString TextArena::text(const Ref& ref) const {
+    if (ref.length == 0) return QString();
+    const QByteArray& chunk = m_chunks.at(static_cast<int>(ref.chunk));
+    return QString::fromUtf8(chunk.constData() + ref.offset, static_cast<int>(ref.length));
+}
+
+void TextArena::clear() {
+    m_chunks.clear();
+    m_bytes = 0;
+}
+
+} // namespace rewise::storage
@@ -0,0 +1,41 @@
+#ifndef REWISE_STORAGE_TEXTARENA_H
+#define REWISE_STORAGE_TEXTARENA_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+namespace rewise::storage {
+
+// Append-only UTF-8 store for card text: a string is an offset/length slice of
+// a chunk, decoded only when read.
+//
+// Chunks are implicitly shared, so copying an arena (a Database snapshot, a
+// CardStore) is O(1) and an append after a copy only detaches the tail chunk
+// (at most kChunkBytes). Text is never rewritten: an edit appends, and slices
+// handed out earlier stay valid in every copy. Const access is thread-safe.
+class TextArena final {
+public:
+    struct Ref final {
+        quint32 chunk = 0;
+        quint32 offset = 0;
+        quint32 length = 0;     // bytes; 0 = empty string
+    };
+
+    static constexpr int kChunkBytes = 1 << 16;
+
+    Ref append(const QString& text);
+    QString text(const Ref& ref) const;
+
+    // UTF-8 bytes held, including text no longer referenced.
+    qint64 bytes() const { return m_bytes; }
+    void clear();
+
+private:
+    QVector<QByteArray> m_chunks;
+    qint64 m_bytes = 0;
+};
+
+} // namespace rewise::storage
+
+#endif // REWISE_STORAGE_TEXTARENA_H
@@ -0,0 +1,220 @@
+#include "TextIndex.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace rewise::storage {
+
+namespace {
+
+bool isWordChar(QChar c) {
+    return c.isLetterOrNumber();
+}
+
+// Word boundary marker for vocabulary trigrams (never a word character).
+const QChar kPad(0x0001);
+
+template <typename T>
+void sortUnique(QVector<T>* v) {
+    std::sort(v->begin(), v->end());
+    v->erase(std::unique(v->begin(), v->end()), v->end());
+}
+
+} // namespace
+
+void TextIndex::clear() {
+    m_wordIds.clear();
+    m_vocab.clear();
+    m_wordRows.clear();
+    m_wordGrams.clear();
+    m_trigrams.clear();
+    m_shortGrams.clear();
+    m_rows = 0;
+}
+
+QVector<QString> TextIndex::tokenize(const QString& folded) {
+    QVector<QString> out;
+    const int n = folded.size();
+    int i = 0;
+    while (i < n) {
+        while (i < n && !isWordChar(folded[i])) ++i;
+        const int start = i;
+        while (i < n && isWordChar(folded[i])) ++i;
+        if (i > start) out.push_back(folded.mid(start, i - start));
+    }
+    return out;
+}
+
+QVector<quint64> TextIndex::paddedTrigrams(const QString& word) {
+    // "\1\1word\1\1": word.size() + 2 grams; the first word.size() ones see only
+    // the start of the word, so prefixes share them.
+    const QString padded = QString(2, kPad) + word + QString(2, kPad);
+    QVector<quint64> grams;
+    grams.reserve(word.size() + 2);
+    const QChar* p = padded.constData();
+    for (int i = 0; i + 3 <= padded.size(); ++i) grams.push_back(trigramKey(p + i));
+    return grams;
+}
+
+int TextIndex::addWord(const QString& word) {
+    const auto it = m_wordIds.constFind(word);
+    if (it != m_wordIds.constEnd()) return *it;
+
+    const int id = m_vocab.size();
+    m_wordIds.insert(word, id);
+    m_vocab.push_back(word);
+    m_wordRows.push_back({});
+
+    QVector<quint64> grams = paddedTrigrams(word);
+    sortUnique(&grams);
+    for (quint64 g : grams) m_wordGrams[g].push_back(id); // ids ascending
+    return id;
+}
+
+void TextIndex::collect(const QString& folded, QVector<quint64>* grams, QVector<quint32>* shortGrams,
+                        QVector<QString>* words) {
+    const QChar* p = folded.constData();
+    const int n = folded.size();
+    for (int i = 0; i + 3 <= n; ++i) grams->push_back(trigramKey(p + i));
+    for (int i = 0; i < n; ++i) {
+        shortGrams->push_back(shortGramKey(p + i, 1));
+        if (i + 2 <= n) shortGrams->push_back(shortGramKey(p + i, 2));
+    }
+    *words += tokenize(folded);
+}
+
+void TextIndex::addRow(int row, const QString& question, const QString& answer) {
+    QVector<quint64> grams;
+    QVector<quint32> shortGrams;
+    QVector<QString> words;
+    collect(fold(question), &grams, &shortGrams, &words);
+    collect(fold(answer), &grams, &shortGrams, &words);
+
+    // One posting per (key, row); rows arrive in ascending order, so lists stay sorted.
+    sortUnique(&grams);
+    sortUnique(&shortGrams);
+    sortUnique(&words);
+    for (quint64 g : grams) m_trigrams[g].push_back(row);
+    for (quint32 g : shortGrams) m_shortGrams[g].push_back(row);
+    for (const QString& w : words) m_wordRows[addWord(w)].push_back(row);
+    ++m_rows;
+}
+
+void TextIndex::sortPostings() {
+    const auto sortList = [](QVector<int>& rows) {
+        if (!std::is_sorted(rows.cbegin(), rows.cend())) std::sort(rows.begin(), rows.end());
+    };
+    for (auto& rows : m_trigrams) sortList(rows);
+    for (auto& rows : m_shortGrams) sortList(rows);
+    for (auto& rows : m_wordRows) sortList(rows);
+}
+
+QVector<int> TextIndex::intersect(const QVector<int>& a, const QVector<int>& b) {
+    // Walk the shorter list and gallop through the longer one.
+    const QVector<int>& small = (a.size() <= b.size()) ? a : b;
+    const QVector<int>& large = (a.size() <= b.size()) ? b : a;
+
+    QVector<int> out;
+    out.reserve(small.size());
+    auto it = large.begin();
+    for (int row : small) {
+        it = std::lower_bound(it, large.end(), row);
+        if (it == large.end()) break;
+        if (*it == row) out.push_back(row);
+    }
+    return out;
+}
+
+bool TextIndex::candidates(const QString& query, QVector<int>* out) const {
+    out->clear();
+    const QString q = fold(query);
+    if (q.isEmpty()) return false;
+
+    if (q.size() >= 3) {
+        QVector<quint64> grams;
+        const QChar* p = q.constData();
+        for (int i = 0; i + 3 <= q.size(); ++i) grams.push_back(trigramKey(p + i));
+        sortUnique(&grams);
+
+        QVector<const QVector<int>*> lists;
+        lists.reserve(grams.size());
+        for (quint64 g : grams) {
+            const auto it = m_trigrams.constFind(g);
+            if (it == m_trigrams.constEnd()) return true; // some trigram occurs nowhere: no match
+            lists.push_back(&*it);
+        }
+
+        // Rarest first keeps every intermediate result small.
+        std::sort(lists.begin(), lists.end(),
+                  [](const QVector<int>* a, const QVector<int>* b) { return a->size() < b->size(); });
+        *out = *lists.first();
+        for (int i = 1; i < lists.size() && !out->isEmpty(); ++i) *out = intersect(*out, *lists[i]);
+        return true;
+    }
+
+    // 1-2 characters: their own posting list, exact.
+    const auto it = m_shortGrams.constFind(shortGramKey(q.constData(), q.size()));
+    if (it != m_shortGrams.constEnd()) *out = *it;
+    return true;
+}
+
+QVector<int> TextIndex::rowsWithWord(const QString& word) const {
+    const int id = wordId(fold(word));
+    return (id >= 0) ? m_wordRows[id] : QVector<int>{};
+}
+
+QVector<int> TextIndex::wordsWithPrefix(const QString& folded) const {
+    if (folded.isEmpty()) return {};
+
+    // Every word starting with `folded` has all of its start-anchored grams.
+    QVector<quint64> grams = paddedTrigrams(folded);
+    grams.resize(folded.size());
+    sortUnique(&grams);
+
+    QVector<int> ids;
+    for (int i = 0; i < grams.size(); ++i) {
+        const auto it = m_wordGrams.constFind(grams[i]);
+        if (it == m_wordGrams.constEnd()) return {};
+        ids = (i == 0) ? *it : intersect(ids, *it);
+        if (ids.isEmpty()) return {};
+    }
+
+    QVector<int> out;
+    for (int id : ids) {
+        if (m_vocab[id].startsWith(folded)) out.push_back(id);
+    }
+    return out;
+}
+
+QVector<int> TextIndex::wordsNear(const QString& folded, int maxEdits) const {
+    const int n = folded.size();
+    if (n == 0 || maxEdits < 0) return {};
+
+    auto lengthOk = [&](int id) { return std::abs(m_vocab[id].size() - n) <= maxEdits; };
+
+    QVector<quint64> grams = paddedTrigrams(folded);
+    sortUnique(&grams);
+    const int minShared = grams.size() - 3 * maxEdits;
+
+    QVector<int> out;
+    if (minShared <= 0) {
+        // Bound says nothing (short word, many edits): length filter only.
+        for (int id = 0; id < m_vocab.size(); ++id) {
+            if (lengthOk(id)) out.push_back(id);
+        }
+        return out;
+    }
+
+    QVector<int> shared(m_vocab.size(), 0);
+    for (quint64 g : grams) {
+        const auto it = m_wordGrams.constFind(g);
+        if (it == m_wordGrams.constEnd()) continue;
+        for (int id : *it) {
+            if (++shared[id] == minShared && lengthOk(id)) out.push_back(id);
+        }
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+} // namespace rewise::storage
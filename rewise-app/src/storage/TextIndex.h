@@ -0,0 +1,89 @@
+#ifndef REWISE_STORAGE_TEXTINDEX_H
+#define REWISE_STORAGE_TEXTINDEX_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+namespace rewise::storage {
+
+// Inverted index over card text for search-as-you-type.
+//
+// Posting maps, all keyed on case-folded text:
+// - word    -> rows containing that word (letters/digits runs)
+// - trigram -> rows containing those three consecutive characters
+// - 1-2 characters -> rows containing them, so the first keystrokes of a
+//   search are one lookup instead of a pass over the vocabulary
+// plus a trigram index over the vocabulary itself, for prefix and
+// typo-tolerant word lookup. Rows are CardStore rows. They only ever grow, so appending keeps every
+// posting list sorted without extra work; retired rows are left in place and
+// filtered out by the caller (the index is rebuilt together with the store).
+class TextIndex final {
+public:
+    void clear();
+    bool isEmpty() const { return m_rows == 0; }
+
+    // Indexes one row. Rows must be added in ascending order, or be followed by
+    // sortPostings() (bulk builds whose text arrives in another order).
+    void addRow(int row, const QString& question, const QString& answer);
+    // Sorts the posting lists that rows added out of order left unsorted.
+    void sortPostings();
+
+    // Ascending rows that may contain `query` as a case-insensitive substring
+    // (a superset for 3+ characters: callers verify). 1-2 characters cost a
+    // copy of one posting list. Returns false when the index can't narrow the
+    // query down; scan then.
+    bool candidates(const QString& query, QVector<int>* out) const;
+
+    // Rows containing `word` as a whole word.
+    QVector<int> rowsWithWord(const QString& word) const;
+
+    // --- Vocabulary (case-folded words, ids in first-seen order) ---
+    int vocabularySize() const { return m_vocab.size(); }
+    const QString& word(int wordId) const { return m_vocab[wordId]; }
+    const QVector<int>& wordRows(int wordId) const { return m_wordRows[wordId]; }
+    int wordId(const QString& folded) const { return m_wordIds.value(folded, -1); }
+
+    // Ids of words starting with `folded` (exact).
+    QVector<int> wordsWithPrefix(const QString& folded) const;
+
+    // Ids of words that may be within `maxEdits` edits of `folded`: a length
+    // filter plus the q-gram count bound (each edit destroys at most three
+    // padded trigrams). A superset: callers verify with an edit distance.
+    QVector<int> wordsNear(const QString& folded, int maxEdits) const;
+
+    // Letter/digit runs of already folded text, in order.
+    static QVector<QString> tokenize(const QString& folded);
+
+    static QString fold(const QString& s) { return s.toCaseFolded(); }
+
+private:
+    static quint64 trigramKey(const QChar* p) {
+        return (quint64(p[0].unicode()) << 32) | (quint64(p[1].unicode()) << 16) | quint64(p[2].unicode());
+    }
+    // 1 or 2 characters; the length bit keeps the two kinds apart.
+    static quint32 shortGramKey(const QChar* p, int n) {
+        return (n == 1) ? quint32(p[0].unicode())
+                        : (quint32(1) << 31) | (quint32(p[0].unicode()) << 16) | quint32(p[1].unicode());
+    }
+
+    static QVector<quint64> paddedTrigrams(const QString& word);
+    static QVector<int> intersect(const QVector<int>& a, const QVector<int>& b);
+
+    static void collect(const QString& folded, QVector<quint64>* grams, QVector<quint32>* shortGrams,
+                        QVector<QString>* words);
+
+    int addWord(const QString& word);
+
+    QHash<QString, int> m_wordIds;
+    QVector<QString> m_vocab;
+    QVector<QVector<int>> m_wordRows;         // word id -> rows
+    QHash<quint64, QVector<int>> m_wordGrams; // padded trigram -> word ids
+    QHash<quint64, QVector<int>> m_trigrams;
+    QHash<quint32, QVector<int>> m_shortGrams; // shortGramKey -> rows
+    int m_rows = 0;
+};
+
+} // namespace rewise::storage
+
+#endif // REWISE_STORAGE_TEXTINDEX_H
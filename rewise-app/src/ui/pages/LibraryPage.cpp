@@ -2,18 +2,22 @@
 #include "ui_LibraryPage.h"
 
 #include "ui/widgets/InlineMessageWidget.h"
+#include "ui/widgets/FolderListDelegate.h"
 #include "ui/widgets/FolderListModel.h"
 #include "ui/widgets/CardTableModel.h"
+#include "ui/widgets/CardTileDelegate.h"
+#include "ui/widgets/ReviewFoldersDialog.h"
+#include "ui/widgets/ExamSetupDialog.h"
+#include "ui/widgets/FolderScoringDialog.h"
 
 #include <QHeaderView>
 #include <QMessageBox>
 #include <QVBoxLayout>
 #include <QMenu>
+#include <QSettings>
 #include <QStyle>
 #include <QToolButton>
 
-#include <algorithm>
-
 namespace rewise::ui::pages {
 
 static QPoint menuAnchorBelow(QWidget* w) {
@@ -46,6 +50,8 @@ LibraryPage::LibraryPage(QWidget* parent)
     prepToolBtn(ui->btnFolderSave);
     prepToolBtn(ui->btnFolderCancel);
 
+    prepToolBtn(ui->btnFuzzySearch);
+    prepToolBtn(ui->btnTileView);
     prepToolBtn(ui->btnAddCard);
     prepToolBtn(ui->btnEditCard);
     prepToolBtn(ui->btnDeleteCard);
@@ -109,8 +115,11 @@ LibraryPage::LibraryPage(QWidget* parent)
     m_cardModel   = new rewise::ui::widgets::CardTableModel(this);
 
     ui->lvFolders->setModel(m_folderModel);
+    ui->lvFolders->setItemDelegate(new rewise::ui::widgets::FolderListDelegate(ui->lvFolders));
 
     ui->tvCards->setModel(m_cardModel);
+    ui->btnFuzzySearch->setChecked(QSettings().value("library/fuzzySearch", false).toBool());
+    m_cardModel->setFuzzySearch(ui->btnFuzzySearch->isChecked());
     ui->tvCards->setSelectionBehavior(QAbstractItemView::SelectRows);
     ui->tvCards->setSelectionMode(QAbstractItemView::SingleSelection);
     ui->tvCards->setSortingEnabled(true);
@@ -129,9 +138,29 @@ LibraryPage::LibraryPage(QWidget* parent)
     ui->tvCards->setColumnHidden(rewise::ui::widgets::CardTableModel::FolderCol, true);
     ui->tvCards->setColumnHidden(rewise::ui::widgets::CardTableModel::UpdatedCol, true);
 
+    // Tile grid: same model and selection as the table, painted by a delegate
+    // (no widget per card). Uniform sizes + batched layout keep huge folders instant.
+    ui->lvCardTiles->setModel(m_cardModel);
+    ui->lvCardTiles->setSelectionModel(ui->tvCards->selectionModel());
+    ui->lvCardTiles->setItemDelegate(new rewise::ui::widgets::CardTileDelegate(ui->lvCardTiles));
+    ui->lvCardTiles->setViewMode(QListView::IconMode);
+    ui->lvCardTiles->setMovement(QListView::Static);
+    ui->lvCardTiles->setResizeMode(QListView::Adjust);
+    ui->lvCardTiles->setWrapping(true);
+    ui->lvCardTiles->setUniformItemSizes(true);
+    ui->lvCardTiles->setLayoutMode(QListView::Batched);
+    ui->lvCardTiles->setBatchSize(512);
+    ui->lvCardTiles->setMouseTracking(true); // hover highlight
+    ui->lvCardTiles->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+
+    ui->btnTileView->setChecked(QSettings().value("library/tileView", false).toBool());
+    ui->cardViews->setCurrentWidget(ui->btnTileView->isChecked() ? static_cast<QWidget*>(ui->lvCardTiles)
+                                                                  : static_cast<QWidget*>(ui->tvCards));
+
     // Context menus (чтобы убрать лишние кнопки с экрана).
     ui->lvFolders->viewport()->setContextMenuPolicy(Qt::CustomContextMenu);
     ui->tvCards->viewport()->setContextMenuPolicy(Qt::CustomContextMenu);
+    ui->lvCardTiles->viewport()->setContextMenuPolicy(Qt::CustomContextMenu);
 
     wireUi();
     applyEditState();
@@ -155,6 +184,35 @@ void LibraryPage::wireUi() {
         refreshPreview();
     });
 
+    connect(ui->btnFuzzySearch, &QToolButton::toggled, this, [this](bool on) {
+        QSettings().setValue("library/fuzzySearch", on);
+        m_cardModel->setFuzzySearch(on);
+        refreshButtons();
+        refreshPreview();
+    });
+
+    // Filtered/sorted card list swapped in (computed off the GUI thread).
+    connect(m_cardModel, &rewise::ui::widgets::CardTableModel::viewReady, this, [this] {
+        if (m_restoreCardId.isValid()) {
+            const int cardRow = m_cardModel->rowForCardId(m_restoreCardId);
+            if (cardRow >= 0) {
+                ui->tvCards->selectRow(cardRow);
+                cardView()->scrollTo(m_cardModel->index(cardRow, 0));
+            }
+            m_restoreCardId = {};
+        }
+        refreshButtons();
+        refreshPreview();
+    });
+
+    connect(ui->btnTileView, &QToolButton::toggled, this, [this](bool on) {
+        QSettings().setValue("library/tileView", on);
+        ui->cardViews->setCurrentWidget(on ? static_cast<QWidget*>(ui->lvCardTiles)
+                                           : static_cast<QWidget*>(ui->tvCards));
+        const QModelIndex current = ui->tvCards->currentIndex();
+        if (current.isValid()) cardView()->scrollTo(current);
+    });
+
     // Folder selection => filter cards
     connect(ui->lvFolders->selectionModel(), &QItemSelectionModel::selectionChanged, this, [this] {
         if (isEditing()) return; // не меняем контекст, пока открыт inline-editor
@@ -210,17 +268,21 @@ void LibraryPage::wireUi() {
         requestDeleteCard(id);
     });
 
-    connect(ui->tvCards, &QTableView::doubleClicked, this, [this](const QModelIndex&) {
-        const auto id = selectedCardId();
-        if (!id.isValid()) return;
-        openCardEdit(id);
-    });
-
-    connect(ui->tvCards->viewport(), &QWidget::customContextMenuRequested, this, [this](const QPoint& pos) {
-        const QModelIndex idx = ui->tvCards->indexAt(pos);
-        if (idx.isValid()) ui->tvCards->setCurrentIndex(idx);
-        showCardMenu(ui->tvCards->viewport()->mapToGlobal(pos));
-    });
+    // Table and tiles share the selection model, so both act on selectedCardId().
+    for (QAbstractItemView* view : {static_cast<QAbstractItemView*>(ui->tvCards),
+                                    static_cast<QAbstractItemView*>(ui->lvCardTiles)}) {
+        connect(view, &QAbstractItemView::doubleClicked, this, [this](const QModelIndex&) {
+            const auto id = selectedCardId();
+            if (!id.isValid()) return;
+            openCardEdit(id);
+        });
+
+        connect(view->viewport(), &QWidget::customContextMenuRequested, this, [this, view](const QPoint& pos) {
+            const QModelIndex idx = view->indexAt(pos);
+            if (idx.isValid()) view->setCurrentIndex(idx);
+            showCardMenu(view->viewport()->mapToGlobal(pos));
+        });
+    }
 
     connect(ui->btnCardSave, &QToolButton::clicked, this, [this] { commitCardEditor(); });
     connect(ui->btnCardCancel, &QToolButton::clicked, this, [this] { closeCardEditor(); });
@@ -230,17 +292,19 @@ void LibraryPage::wireUi() {
 
     connect(ui->btnStartReview, &QPushButton::clicked, this, [this] {
         if (isEditing()) return;
-        emit startReviewRequested(selectedFolderId());
+        showReviewMenu(menuAnchorBelow(ui->btnStartReview));
     });
 }
 
-void LibraryPage::setDatabase(rewise::storage::Database db) {
+void LibraryPage::setDatabase(rewise::storage::DatabaseSnapshot db) {
+    if (!db) return;
     const auto prevFolder = selectedFolderId();
     const auto prevCard   = selectedCardId();
 
     m_db = std::move(db);
 
-    m_folderModel->setFolders(m_db.folders);
+    m_folderModel->setFolders(m_db->folders);
+    m_folderModel->refreshCounts(*m_db);
     m_cardModel->setDatabase(m_db);
     m_cardModel->setFolderFilter(prevFolder);
 
@@ -256,11 +320,32 @@ void LibraryPage::setDatabase(rewise::storage::Database db) {
         }
     }
 
-    // restore card selection
-    const int cardRow = m_cardModel->rowForCardId(prevCard);
-    if (cardRow >= 0) {
-        ui->tvCards->selectRow(cardRow);
-        ui->tvCards->scrollTo(m_cardModel->index(cardRow, 0));
+    // The card list is rebuilt asynchronously; restore the selection once it's shown.
+    m_restoreCardId = prevCard;
+
+    refreshButtons();
+    refreshPreview();
+}
+
+void LibraryPage::applyChanges(const rewise::storage::DatabaseSnapshot& db,
+                               const rewise::storage::ChangeEvents& events) {
+    if (!db) return;
+    for (const auto& e : events) {
+        if (e.kind == rewise::storage::ChangeEvent::Kind::Reset) {
+            setDatabase(db);
+            return;
+        }
+    }
+
+    m_db = db;
+
+    // Row-level updates keep selection and scroll position by themselves.
+    m_folderModel->applyChanges(m_db->folders, events);
+    m_folderModel->refreshCounts(*m_db);
+    m_cardModel->applyChanges(m_db, events);
+
+    if (!ui->lvFolders->currentIndex().isValid() && m_folderModel->rowCount() > 0) {
+        ui->lvFolders->setCurrentIndex(m_folderModel->index(0, 0));
     }
 
     refreshButtons();
@@ -279,12 +364,21 @@ void LibraryPage::clearMessage() {
     if (m_msg) m_msg->clearMessage();
 }
 
+void LibraryPage::setResumableSession(const QString& title) {
+    m_resumeTitle = title;
+}
+
 rewise::domain::Id LibraryPage::selectedFolderId() const {
     const QModelIndex idx = ui->lvFolders->currentIndex();
     if (!idx.isValid()) return rewise::domain::Id{}; // all
     return m_folderModel->idAtRow(idx.row());
 }
 
+QAbstractItemView* LibraryPage::cardView() const {
+    if (ui->cardViews->currentWidget() == ui->lvCardTiles) return ui->lvCardTiles;
+    return ui->tvCards;
+}
+
 rewise::domain::Id LibraryPage::selectedCardId() const {
     const QModelIndex idx = ui->tvCards->currentIndex();
     if (!idx.isValid()) return rewise::domain::Id{};
@@ -309,6 +403,8 @@ void LibraryPage::refreshButtons() {
     // Lock navigation while editing to reduce accidental context changes.
     ui->lvFolders->setEnabled(!editingAny);
     ui->tvCards->setEnabled(!editingAny);
+    ui->lvCardTiles->setEnabled(!editingAny);
+    ui->btnTileView->setEnabled(!editingAny);
     ui->leSearch->setEnabled(!editingAny);
     ui->btnStartReview->setEnabled(!editingAny && m_cardModel->rowCount() > 0);
 
@@ -337,13 +433,17 @@ void LibraryPage::refreshPreview() {
     if (m_cardEditMode != CardEditMode::None) return;
 
     const auto cardId = selectedCardId();
-    const auto* c = m_db.cardById(cardId);
+    const int idx = m_db->cardIndexById(cardId);
 
-    if (!c) {
+    if (idx < 0) {
         ui->tbPreview->setHtml("<div style='opacity:0.65'>Выберите карточку, чтобы увидеть детали.</div>");
         return;
     }
 
+    // Full text (paged in when bodies are lazy).
+    const rewise::domain::Card card = m_db->fullCard(idx);
+    const auto* c = &card;
+
     const QString html =
         "<div style='white-space: pre-wrap; line-height:1.35;'>"
           "<div style='font-weight:700; font-size:15px; margin-bottom:6px;'>" + c->question.toHtmlEscaped() + "</div>"
@@ -370,7 +470,7 @@ void LibraryPage::openFolderCreate() {
 
 void LibraryPage::openFolderRename(const rewise::domain::Id& folderId) {
     if (!folderId.isValid()) return;
-    const auto* f = m_db.folderById(folderId);
+    const auto* f = m_db->folderById(folderId);
     if (!f) return;
 
     clearMessage();
@@ -423,11 +523,16 @@ void LibraryPage::showFolderMenu(const QPoint& globalPos) {
     auto* aNew = menu.addAction("Новая папка…");
     auto* aRename = menu.addAction("Переименовать…");
     auto* aDelete = menu.addAction("Удалить…");
+    auto* aScoring = menu.addAction("Настройки проверки…");
+    menu.addSeparator();
+    auto* aStats = menu.addAction("Статистика");
+    auto* aCheck = menu.addAction("Проверить базу");
 
     const auto folderId = selectedFolderId();
     const bool hasFolder = folderId.isValid(); // invalid = "Все карточки"
     aRename->setEnabled(hasFolder);
     aDelete->setEnabled(hasFolder);
+    aScoring->setEnabled(hasFolder);
 
     QAction* act = menu.exec(globalPos);
     if (!act) return;
@@ -437,6 +542,16 @@ void LibraryPage::showFolderMenu(const QPoint& globalPos) {
         return;
     }
 
+    if (act == aStats) {
+        emit statsRequested();
+        return;
+    }
+
+    if (act == aCheck) {
+        emit checkDatabaseRequested();
+        return;
+    }
+
     if (!hasFolder) return;
 
     if (act == aRename) {
@@ -444,12 +559,20 @@ void LibraryPage::showFolderMenu(const QPoint& globalPos) {
         return;
     }
 
+    if (act == aScoring) {
+        const auto* f = m_db->folderById(folderId);
+        if (!f) return;
+        rewise::domain::ReviewSettings settings;
+        if (!rewise::ui::widgets::FolderScoringDialog::edit(this, f->name, f->scoring, &settings)) return;
+        if (settings != f->scoring) emit folderScoringRequested(folderId, settings);
+        return;
+    }
+
     if (act == aDelete) {
-        const auto* f = m_db.folderById(folderId);
+        const auto* f = m_db->folderById(folderId);
         if (!f) return;
 
-        const int cardCount = std::count_if(m_db.cards.begin(), m_db.cards.end(),
-                                            [&](const rewise::domain::Card& c) { return c.folderId == folderId; });
+        const int cardCount = m_db->cardCountInFolder(folderId);
 
         const auto ans = QMessageBox::question(this,
                                               "Удалить папку?",
@@ -482,8 +605,17 @@ void LibraryPage::openCardCreate() {
 
 void LibraryPage::openCardEdit(const rewise::domain::Id& cardId) {
     if (!cardId.isValid()) return;
-    const auto* c = m_db.cardById(cardId);
-    if (!c) return;
+    const int idx = m_db->cardIndexById(cardId);
+    if (idx < 0) return;
+
+    // Never edit a preview: saving it would truncate the card.
+    rewise::domain::Card card;
+    QString err;
+    if (!m_db->fullCard(idx, &card, &err)) {
+        showError("Не удалось прочитать карточку: " + err);
+        return;
+    }
+    const auto* c = &card;
 
     clearMessage();
     m_cardEditMode = CardEditMode::Edit;
@@ -586,4 +718,61 @@ void LibraryPage::showCardMenu(const QPoint& globalPos) {
     }
 }
 
+void LibraryPage::showReviewMenu(const QPoint& globalPos) {
+    using rewise::review::SessionOrder;
+
+    QMenu menu(this);
+
+    QAction* aResume = nullptr;
+    if (!m_resumeTitle.isEmpty()) {
+        aResume = menu.addAction(QString("Продолжить: %1").arg(m_resumeTitle));
+        menu.addSeparator();
+    }
+    menu.addAction("К повторению (по сроку)");
+    auto* aShuffled = menu.addAction("Все вперемешку");
+    auto* aWeighted = menu.addAction("Сначала трудные");
+    menu.addSeparator();
+    auto* aPick = menu.addAction("Несколько папок…");
+    auto* aExam = menu.addAction("Экзамен…");
+
+    QAction* act = menu.exec(globalPos);
+    if (!act) return;
+
+    if (act == aResume) {
+        emit resumeReviewRequested();
+        return;
+    }
+
+    const auto folderId = selectedFolderId();
+    QVector<rewise::domain::Id> folderIds;
+    if (folderId.isValid()) folderIds.push_back(folderId);
+
+    if (act == aExam) {
+        const auto* f = folderId.isValid() ? m_db->folderById(folderId) : nullptr;
+        const int available = f ? m_db->cardCountInFolder(folderId) : m_db->cards.size();
+        if (available == 0) {
+            showInfo(f ? "В выбранной папке нет карточек." : "Карточек пока нет.");
+            return;
+        }
+        int cardCount = 0;
+        int minutes = 0;
+        if (!rewise::ui::widgets::ExamSetupDialog::pick(this, f ? f->name : QString("Все карточки"), available,
+                                                        &cardCount, &minutes)) return;
+        emit startExamRequested(folderIds, cardCount, minutes);
+        return;
+    }
+
+    if (act == aPick) {
+        SessionOrder order = SessionOrder::Due;
+        if (!rewise::ui::widgets::ReviewFoldersDialog::pick(this, *m_db, folderIds, &folderIds, &order)) return;
+        emit startReviewRequested(folderIds, order);
+        return;
+    }
+
+    const SessionOrder order = (act == aShuffled) ? SessionOrder::Shuffled
+                             : (act == aWeighted) ? SessionOrder::Weighted
+                                                  : SessionOrder::Due;
+    emit startReviewRequested(folderIds, order);
+}
+
 } // namespace rewise::ui::pages
@@ -3,10 +3,12 @@
 
 #include "storage/Database.h"
 #include "domain/Id.h"
+#include "review/CardOrder.h"
 
 #include <QWidget>
 
 QT_BEGIN_NAMESPACE
+class QAbstractItemView;
 namespace Ui { class LibraryPage; }
 QT_END_NAMESPACE
 
@@ -24,7 +26,10 @@ public:
     explicit LibraryPage(QWidget* parent = nullptr);
     ~LibraryPage() override;
 
-    void setDatabase(rewise::storage::Database db);
+    // Shares the published version; nothing is copied.
+    void setDatabase(rewise::storage::DatabaseSnapshot db);
+    // Same, but updates the models row by row from `events` (ChangeBus::changed).
+    void applyChanges(const rewise::storage::DatabaseSnapshot& db, const rewise::storage::ChangeEvents& events);
 
     void showError(const QString& text);
     void showInfo(const QString& text);
@@ -32,11 +37,17 @@ public:
 
     rewise::domain::Id selectedFolderId() const; // invalid => all
     rewise::domain::Id selectedCardId() const;
+    QAbstractItemView* cardView() const; // table or tile grid, whichever is shown
+
+    // Title of an interrupted review session to offer resuming; empty = none.
+    void setResumableSession(const QString& title);
 
 signals:
     void folderCreateRequested(const QString& name);
     void folderRenameRequested(const rewise::domain::Id& folderId, const QString& newName);
     void folderDeleteRequested(const rewise::domain::Id& folderId);
+    void folderScoringRequested(const rewise::domain::Id& folderId,
+                                const rewise::domain::ReviewSettings& settings);
 
     void cardCreateRequested(const rewise::domain::Id& folderId,
                              const QString& question,
@@ -46,7 +57,15 @@ signals:
                              const QString& answer);
     void cardDeleteRequested(const rewise::domain::Id& cardId);
 
-    void startReviewRequested(const rewise::domain::Id& folderId); // invalid => all
+    void startReviewRequested(const QVector<rewise::domain::Id>& folderIds, // empty => all
+                              rewise::review::SessionOrder order);
+    void resumeReviewRequested();
+    // `cardCount` random cards of the folders; `timeLimitMinutes` 0 = no limit.
+    void startExamRequested(const QVector<rewise::domain::Id>& folderIds, // empty => all
+                            int cardCount, int timeLimitMinutes);
+
+    void statsRequested();
+    void checkDatabaseRequested();
 
 private:
     enum class FolderEditMode { None, Create, Rename };
@@ -71,13 +90,16 @@ private:
     void commitCardEditor();
     void requestDeleteCard(const rewise::domain::Id& cardId);
     void showCardMenu(const QPoint& globalPos);
+    void showReviewMenu(const QPoint& globalPos);
 
     bool isEditing() const;
 
 private:
     Ui::LibraryPage* ui = nullptr;
 
-    rewise::storage::Database m_db;
+    rewise::storage::DatabaseSnapshot m_db = std::make_shared<const rewise::storage::Database>();
+    rewise::domain::Id m_restoreCardId; // re-selected once the card view is ready
+    QString m_resumeTitle;
 
     rewise::ui::widgets::InlineMessageWidget* m_msg = nullptr;
     rewise::ui::widgets::FolderListModel* m_folderModel = nullptr;
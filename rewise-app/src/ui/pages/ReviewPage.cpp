@@ -2,17 +2,23 @@
 #include "ui_ReviewPage.h"
 
 #include "review/ReviewEngine.h"
+#include "review/Scheduler.h"
+#include "storage/CardBodyStore.h"
 #include "ui/widgets/DiffTextWidget.h"
 #include "ui/widgets/InlineMessageWidget.h"
 
-#include <QRandomGenerator>
 #include <QVBoxLayout>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <utility>
 
 namespace rewise::ui::pages {
 
 ReviewPage::ReviewPage(QWidget* parent)
     : QWidget(parent)
     , ui(new Ui::ReviewPage)
+    , m_references(std::make_shared<rewise::review::ReferenceCache>())
 {
     ui->setupUi(this);
     ui->btnCheck->setProperty("primary", true);
@@ -33,6 +39,11 @@ ReviewPage::ReviewPage(QWidget* parent)
     }
     ui->diffHost->layout()->addWidget(m_diff);
 
+    m_examResults = new rewise::ui::widgets::ExamResultsWidget(ui->examHost);
+    ui->examHost->layout()->addWidget(m_examResults);
+
+    m_examTick.setInterval(1000);
+
     wireUi();
     stopSession();
 }
@@ -43,17 +54,43 @@ ReviewPage::~ReviewPage() {
 
 void ReviewPage::wireUi() {
     connect(ui->btnBack, &QPushButton::clicked, this, [this] {
+        // A practice session can be continued (resumeLeftSession); an exam can't.
+        std::unique_ptr<rewise::review::CardOrder> order;
+        int card = -1;
+        QString title = m_titleText;
+        if (m_examStage == ExamStage::None && m_current >= 0) {
+            order = std::move(m_order);
+            card = m_checked ? -1 : m_current;
+        }
         stopSession();
+        m_leftOrder = std::move(order);
+        m_leftCard = card;
+        m_leftTitle = std::move(title);
         emit exitRequested();
     });
 
     connect(ui->btnCheck, &QPushButton::clicked, this, [this] {
-        if (m_current < 0 || m_current >= m_cards.size()) return;
-        const auto& card = m_cards[m_current];
+        if (m_current < 0) return;
+        const auto& card = m_card;
 
         const QString user = ui->pteAnswer->toPlainText();
-        const auto res = rewise::review::ReviewEngine::evaluate(card.answer, user);
-
+        const auto res = rewise::review::ReviewEngine::evaluate(m_reference, user, m_scoring.metric);
+
+        // Only the first attempt counts for the schedule; a failed card is asked again later.
+        if (!m_checked) {
+            const int grade = rewise::review::Scheduler::gradeFromPercent(res.similarity.percent, m_scoring.passPercent);
+            m_order->checked(m_current, res.similarity.percent, rewise::review::Scheduler::isPass(grade));
+
+            rewise::storage::ReviewRecord record;
+            record.cardId = card.id;
+            record.atMsUtc = rewise::domain::Card::nowUtcMs();
+            record.day = rewise::storage::ReviewLog::localDayOf(record.atMsUtc);
+            record.answerMs = static_cast<quint32>(qBound<qint64>(0, m_shownAt.elapsed(), 0xffffffffLL));
+            record.optionsHash = rewise::review::ReviewEngine::scoringHash(m_scoring);
+            record.distance = static_cast<quint16>(qBound(0, res.similarity.distance, 0xffff));
+            record.percent = static_cast<quint8>(qBound(0, res.similarity.percent, 100));
+            emit cardChecked(record);
+        }
         m_checked = true;
 
         ui->lblPercent->setText(QString("Совпадение: %1%").arg(res.similarity.percent));
@@ -69,25 +106,85 @@ void ReviewPage::wireUi() {
     });
 
     connect(ui->btnReveal, &QPushButton::clicked, this, [this] {
-        if (m_current < 0 || m_current >= m_cards.size()) return;
-        const auto& card = m_cards[m_current];
+        if (m_current < 0) return;
+        const auto& card = m_card;
         m_revealed = true;
         ui->tbReference->setHtml("<div style='white-space:pre-wrap;'>" + card.answer.toHtmlEscaped() + "</div>");
     });
 
     connect(ui->btnNext, &QPushButton::clicked, this, [this] {
+        if (m_examStage == ExamStage::Answering) recordExamAnswer();
         pickNextCard();
-        showCard();
+        if (m_current >= 0) showCard();
+        else if (m_examStage == ExamStage::Answering) submitExam();
+        else showFinished();
     });
+
+    connect(ui->btnSubmit, &QPushButton::clicked, this, [this] {
+        submitExam();
+    });
+
+    connect(&m_examTick, &QTimer::timeout, this, &ReviewPage::updateClock);
+
+    connect(&m_grading, &QFutureWatcher<GradedAnswer>::progressRangeChanged, ui->pbGrading, &QProgressBar::setRange);
+    connect(&m_grading, &QFutureWatcher<GradedAnswer>::progressValueChanged, ui->pbGrading, &QProgressBar::setValue);
+    connect(&m_grading, &QFutureWatcher<GradedAnswer>::finished, this, &ReviewPage::showExamResults);
+}
+
+void ReviewPage::startSession(rewise::storage::DatabaseSnapshot db,
+                              std::unique_ptr<rewise::review::CardOrder> order,
+                              const QString& title) {
+    dropLeftSession();
+    stopSession();
+    beginSession(std::move(db), std::move(order), title);
+}
+
+bool ReviewPage::resumeLeftSession(rewise::storage::DatabaseSnapshot db) {
+    if (!m_leftOrder) return false;
+    std::unique_ptr<rewise::review::CardOrder> order = std::move(m_leftOrder);
+    const QString title = std::move(m_leftTitle);
+    const int card = std::exchange(m_leftCard, -1);
+
+    stopSession();
+    m_resumeCard = card;
+    beginSession(std::move(db), std::move(order), title);
+    return true;
 }
 
-void ReviewPage::startSession(QVector<rewise::domain::Card> cards, const QString& title) {
-    m_cards = std::move(cards);
+void ReviewPage::dropLeftSession() {
+    m_leftOrder.reset();
+    m_leftCard = -1;
+    m_leftTitle.clear();
+}
+
+void ReviewPage::startExam(rewise::storage::DatabaseSnapshot db,
+                           std::unique_ptr<rewise::review::CardOrder> order,
+                           const QString& title,
+                           qint64 timeLimitMs) {
+    dropLeftSession();
+    stopSession();
+    m_examStage = ExamStage::Answering;
+    m_examLimitMs = qMax<qint64>(0, timeLimitMs);
+    refreshModeUi();
+
+    beginSession(std::move(db), std::move(order), title);
+    if (m_current < 0) return;
+
+    m_examClock.start();
+    m_examTick.start();
+    updateClock();
+}
+
+void ReviewPage::beginSession(rewise::storage::DatabaseSnapshot db,
+                              std::unique_ptr<rewise::review::CardOrder> order,
+                              const QString& title) {
+    m_db = std::move(db);
+    m_order = std::move(order);
     m_titleText = title;
 
     if (m_msg) m_msg->clearMessage();
 
-    if (m_cards.isEmpty()) {
+    if (!m_db || !m_order || m_order->cardCount() == 0) {
         ui->lblTitle->setText("Повторение — пусто");
         ui->tbQuestion->setHtml("<div style='opacity:0.7'>В выбранной папке нет карточек.</div>");
         ui->pteAnswer->setEnabled(false);
@@ -97,21 +194,36 @@ void ReviewPage::startSession(QVector<rewise::domain::Card> cards, const QString
         return;
     }
 
-    ui->lblTitle->setText(QString("Повторение: %1").arg(m_titleText));
     ui->pteAnswer->setEnabled(true);
     ui->btnCheck->setEnabled(true);
     ui->btnReveal->setEnabled(true);
 
-    m_last = -1;
     pickNextCard();
     showCard();
 }
 
 void ReviewPage::stopSession() {
-    m_cards.clear();
+    // Preparations still running finish on their own: each holds its own snapshot.
+    m_prefetched.clear();
+    if (m_grading.isRunning()) m_grading.cancel();   // remaining answers are not graded
+    m_examTick.stop();
+    m_examStage = ExamStage::None;
+    m_examAnswers.clear();
+    m_examLimitMs = 0;
+    m_examClock.invalidate();
+    m_examResults->clear();
+    ui->lblClock->clear();
+    refreshModeUi();
+
+    m_db.reset();
+    m_order.reset();
+    m_shown = 0;
+    m_card = {};
+    m_reference = {};
+    m_scoring = {};
     m_titleText.clear();
     m_current = -1;
-    m_last = -1;
+    m_resumeCard = -1;
 
     ui->lblTitle->setText("Повторение");
     ui->tbQuestion->setHtml("<div style='opacity:0.7'>Запустите повторение из библиотеки.</div>");
@@ -126,21 +238,25 @@ void ReviewPage::stopSession() {
 }
 
 void ReviewPage::pickNextCard() {
-    if (m_cards.isEmpty()) {
-        m_current = -1;
-        return;
-    }
-    if (m_cards.size() == 1) {
-        m_current = 0;
-        return;
-    }
+    if (m_resumeCard >= 0) m_current = std::exchange(m_resumeCard, -1);
+    else m_current = m_order ? m_order->next() : -1;
+    if (m_current >= 0) ++m_shown;
+}
 
-    int idx = m_last;
-    for (int guard = 0; guard < 20 && idx == m_last; ++guard) {
-        idx = static_cast<int>(QRandomGenerator::global()->bounded(m_cards.size()));
-    }
-    m_current = idx;
-    m_last = idx;
+void ReviewPage::showFinished() {
+    clearResultUi();
+    m_card = {};
+    m_reference = {};
+    ui->lblTitle->setText(QString("Повторение: %1").arg(m_titleText));
+    ui->tbQuestion->setHtml(QString("<div style='opacity:0.7'>Сессия завершена: карточек — %1, показов — %2.</div>")
+                                .arg(m_order ? m_order->cardCount() : 0)
+                                .arg(m_shown));
+    ui->pteAnswer->clear();
+    ui->pteAnswer->setEnabled(false);
+    ui->btnCheck->setEnabled(false);
+    ui->btnReveal->setEnabled(false);
+    ui->btnNext->setEnabled(false);
+    emit sessionFinished();
 }
 
 void ReviewPage::clearResultUi() {
@@ -151,16 +267,229 @@ void ReviewPage::clearResultUi() {
     if (m_diff) m_diff->clear();
 }
 
+ReviewPage::PreparedCard ReviewPage::prepareCard(const rewise::storage::DatabaseSnapshot& db,
+                                                 rewise::review::ReferenceCache* references, int index) {
+    PreparedCard out;
+    if (!db || index < 0 || index >= db->cards.size()) {
+        out.error = "карточка не найдена";
+        return out;
+    }
+
+    const auto& card = db->cards[index];
+    if (const auto* folder = db->folderById(card.folderId)) out.scoring = folder->scoring;
+    const auto options = rewise::review::ReviewEngine::normalizeOptions(out.scoring);
+    const rewise::review::ReferenceCache::Key key{card.id, card.updatedAtMsUtc,
+                                                  rewise::review::ReviewEngine::scoringHash(out.scoring)};
+
+    if (!db->fullCard(index, &out.card, &out.error)) return out;
+    out.reference = references ? references->get(key, out.card.answer, options)
+                               : rewise::review::ReviewEngine::prepare(out.card.answer, options);
+    return out;
+}
+
+void ReviewPage::prefetch() {
+    QHash<int, QFuture<PreparedCard>> window;
+    for (int idx : m_order->peek(kPrefetchCards)) {
+        if (idx == m_current || window.contains(idx)) continue;
+        if (m_prefetched.contains(idx)) {
+            window.insert(idx, m_prefetched.take(idx));
+        } else {
+            window.insert(idx, QtConcurrent::run([db = m_db, refs = m_references, idx] { return prepareCard(db, refs.get(), idx); }));
+        }
+    }
+    m_prefetched = std::move(window);
+}
+
 void ReviewPage::showCard() {
     clearResultUi();
-    if (m_current < 0 || m_current >= m_cards.size()) return;
+    if (m_current < 0) return;
+
+    const QString kind = (m_examStage == ExamStage::None) ? "Повторение" : "Экзамен";
+    const int remaining = m_order->remaining();
+    ui->lblTitle->setText(remaining >= 0 ? QString("%1: %2 — осталось %3").arg(kind, m_titleText).arg(remaining + 1)
+                                         : QString("%1: %2 — показано %3").arg(kind, m_titleText).arg(m_shown));
+
+    // Normally ready: it was started while the previous card was being answered.
+    PreparedCard prepared = m_prefetched.contains(m_current) ? m_prefetched.take(m_current).result()
+                                                             : prepareCard(m_db, m_references.get(), m_current);
+    prefetch();
+
+    if (!prepared.error.isEmpty()) {
+        // Grading against a preview would be wrong: skip checking this card.
+        m_card = {};
+        m_reference = {};
+        m_scoring = {};
+        if (m_msg) m_msg->showMessage(rewise::ui::widgets::InlineMessageWidget::Kind::Error,
+                                      "Не удалось прочитать карточку: " + prepared.error);
+        ui->btnCheck->setEnabled(false);
+        ui->btnReveal->setEnabled(false);
+        ui->btnNext->setEnabled(true);
+        return;
+    }
+    m_card = std::move(prepared.card);
+    m_reference = std::move(prepared.reference);
+    m_scoring = prepared.scoring;
+
+    if (m_msg) m_msg->clearMessage();
+    ui->btnCheck->setEnabled(true);
+    ui->btnReveal->setEnabled(true);
 
-    const auto& card = m_cards[m_current];
+    const auto& card = m_card;
     ui->tbQuestion->setHtml("<div style='white-space:pre-wrap;'>" + card.question.toHtmlEscaped() + "</div>");
     ui->pteAnswer->clear();
     ui->pteAnswer->setFocus();
+    m_shownAt.start();
 
     ui->btnNext->setEnabled(true);
 }
 
+void ReviewPage::refreshModeUi() {
+    const bool exam = m_examStage != ExamStage::None;
+    const bool asking = m_examStage == ExamStage::None || m_examStage == ExamStage::Answering;
+
+    // Practice only: checking a single answer and its result.
+    ui->btnCheck->setVisible(!exam);
+    ui->btnReveal->setVisible(!exam);
+    ui->lblPercent->setVisible(!exam);
+    ui->lblRefHeader->setVisible(!exam);
+    ui->tbReference->setVisible(!exam);
+    ui->diffHost->setVisible(!exam);
+
+    ui->lblQuestionHeader->setVisible(asking);
+    ui->tbQuestion->setVisible(asking);
+    ui->lblAnswerHeader->setVisible(asking);
+    ui->pteAnswer->setVisible(asking);
+    ui->btnNext->setVisible(asking);
+
+    ui->lblClock->setVisible(exam);
+    ui->btnSubmit->setVisible(m_examStage == ExamStage::Answering);
+    ui->pbGrading->setVisible(m_examStage == ExamStage::Grading);
+    ui->examHost->setVisible(m_examStage == ExamStage::Results);
+    // Leaving mid-grading would drop the answers.
+    ui->btnBack->setEnabled(m_examStage != ExamStage::Grading);
+}
+
+void ReviewPage::recordExamAnswer() {
+    if (m_current < 0) return;
+    ExamAnswer a;
+    a.card = m_current;
+    a.text = ui->pteAnswer->toPlainText();
+    a.atMsUtc = rewise::domain::Card::nowUtcMs();
+    a.answerMs = static_cast<quint32>(qBound<qint64>(0, m_shownAt.elapsed(), 0xffffffffLL));
+    a.answered = !a.text.trimmed().isEmpty();
+    m_examAnswers.push_back(std::move(a));
+    m_current = -1;
+}
+
+void ReviewPage::submitExam() {
+    if (m_examStage != ExamStage::Answering) return;
+    recordExamAnswer();
+    // Cards not reached count as unanswered.
+    for (int idx = m_order->next(); idx >= 0; idx = m_order->next()) {
+        ExamAnswer a;
+        a.card = idx;
+        m_examAnswers.push_back(std::move(a));
+    }
+
+    m_examTick.stop();
+    updateClock();
+    m_prefetched.clear();
+    m_card = {};
+    m_reference = {};
+    m_scoring = {};
+    ui->pteAnswer->clear();
+
+    m_examStage = ExamStage::Grading;
+    refreshModeUi();
+    ui->lblTitle->setText(QString("Экзамен: %1 — проверка").arg(m_titleText));
+    ui->pbGrading->setRange(0, m_examAnswers.size());
+    ui->pbGrading->setValue(0);
+
+    // One task per answer across the pool; the window stays responsive and
+    // shows progress. Answers prefetched while the exam ran hit the cache.
+    m_grading.setFuture(QtConcurrent::mapped(m_examAnswers, ExamGrader{m_db, m_references}));
+}
+
+ReviewPage::GradedAnswer ReviewPage::gradeAnswer(const rewise::storage::DatabaseSnapshot& db,
+                                                 rewise::review::ReferenceCache* references,
+                                                 const ExamAnswer& answer) {
+    GradedAnswer out;
+    auto& g = out.grade;
+    g.answer = answer.text;
+    g.answered = answer.answered;
+    g.answerMs = answer.answerMs;
+
+    PreparedCard prepared = prepareCard(db, references, answer.card);
+    if (!prepared.error.isEmpty()) {
+        g.error = prepared.error;
+        return out;
+    }
+    g.cardId = prepared.card.id;
+    g.question = prepared.card.question;
+    g.reference = std::move(prepared.reference);
+    g.metric = prepared.scoring.metric;
+    if (!answer.answered) return out;
+
+    const auto sim = rewise::review::ReviewEngine::score(g.reference, answer.text, g.metric);
+    g.percent = sim.percent;
+    g.distance = sim.distance;
+    g.passed = rewise::review::Scheduler::isPass(
+        rewise::review::Scheduler::gradeFromPercent(sim.percent, prepared.scoring.passPercent));
+
+    auto& r = out.record;
+    r.cardId = g.cardId;
+    r.atMsUtc = answer.atMsUtc;
+    r.day = rewise::storage::ReviewLog::localDayOf(r.atMsUtc);
+    r.answerMs = answer.answerMs;
+    r.optionsHash = rewise::review::ReviewEngine::scoringHash(prepared.scoring);
+    r.distance = static_cast<quint16>(qBound(0, sim.distance, 0xffff));
+    r.percent = static_cast<quint8>(qBound(0, sim.percent, 100));
+    return out;
+}
+
+void ReviewPage::showExamResults() {
+    if (m_examStage != ExamStage::Grading || m_grading.isCanceled()) return;
+
+    QVector<rewise::ui::widgets::ExamGrade> grades;
+    QVector<rewise::storage::ReviewRecord> records;
+    grades.reserve(m_examAnswers.size());
+    for (auto& graded : m_grading.future().results()) {   // in exam order
+        if (graded.grade.answered && graded.grade.error.isEmpty()) records.push_back(graded.record);
+        grades.push_back(std::move(graded.grade));
+    }
+    m_grading.setFuture(QFuture<GradedAnswer>());
+    m_examAnswers.clear();
+
+    m_examStage = ExamStage::Results;
+    refreshModeUi();
+    ui->lblTitle->setText(QString("Экзамен: %1 — результаты").arg(m_titleText));
+    m_examResults->setResults(std::move(grades));
+
+    if (!records.isEmpty()) emit examGraded(records);
+}
+
+void ReviewPage::updateClock() {
+    const qint64 elapsed = m_examClock.isValid() ? m_examClock.elapsed() : 0;
+    const auto mmss = [](qint64 ms) {
+        const qint64 s = qMax<qint64>(0, ms) / 1000;
+        return QString("%1:%2").arg(s / 60).arg(s % 60, 2, 10, QChar('0'));
+    };
+
+    if (m_examStage != ExamStage::Answering) {
+        ui->lblClock->setText(QString("Время: %1").arg(mmss(elapsed)));
+        return;
+    }
+    if (m_examLimitMs <= 0) {
+        ui->lblClock->setText(QString("Прошло %1").arg(mmss(elapsed)));
+        return;
+    }
+    const qint64 left = m_examLimitMs - elapsed;
+    ui->lblClock->setText(QString("Осталось %1").arg(mmss(left)));
+    if (left <= 0) {
+        if (m_msg) m_msg->showMessage(rewise::ui::widgets::InlineMessageWidget::Kind::Info,
+                                      "Время вышло: ответы отправлены на проверку.");
+        submitExam();
+    }
+}
+
 } // namespace rewise::ui::pages
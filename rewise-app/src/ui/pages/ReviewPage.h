@@ -2,10 +2,24 @@
 #define REWISE_UI_PAGES_REVIEWPAGE_H
 
 #include "domain/Card.h"
-
+#include "domain/ReviewSettings.h"
+#include "review/CardOrder.h"
+#include "review/ReferenceCache.h"
+#include "review/ReviewTypes.h"
+#include "storage/Database.h"
+#include "storage/ReviewLog.h"
+#include "ui/widgets/ExamResultsWidget.h"
+
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QTimer>
 #include <QWidget>
 #include <QVector>
 
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 namespace Ui { class ReviewPage; }
 QT_END_NAMESPACE
@@ -23,33 +37,141 @@ public:
     explicit ReviewPage(QWidget* parent = nullptr);
     ~ReviewPage() override;
 
-    void startSession(QVector<rewise::domain::Card> cards, const QString& title);
+    // `order` yields indices into db->cards (due order, shuffled deck, weighted...).
+    // The session keeps only the snapshot and the order: full text (lazy bodies)
+    // and prepared reference answers are loaded for the card being shown and,
+    // in the background, for the next kPrefetchCards the order will return.
+    void startSession(rewise::storage::DatabaseSnapshot db,
+                      std::unique_ptr<rewise::review::CardOrder> order,
+                      const QString& title);
     void stopSession();
 
+    // Exam: the cards of `order` are asked once each and nothing is checked
+    // until the exam is submitted (by the user, after the last card, or when
+    // `timeLimitMs` runs out; 0 = no limit). Then all answers are graded in
+    // parallel on the thread pool, with progress shown, and listed in a
+    // sortable results table.
+    void startExam(rewise::storage::DatabaseSnapshot db,
+                   std::unique_ptr<rewise::review::CardOrder> order,
+                   const QString& title,
+                   qint64 timeLimitMs);
+
+    // The practice session last left with "back", continued on `db` where it
+    // stopped: its order is kept as it was (a card shown but not checked is
+    // asked first), so nothing is set up again. `db` must have the session's
+    // card indices: no cards added or removed since (see dropLeftSession).
+    // False if there is none; starting another session or exam drops it.
+    bool resumeLeftSession(rewise::storage::DatabaseSnapshot db);
+    void dropLeftSession();
+
+    // Round of the card being asked (CardOrder::round).
+    int sessionRound() const { return m_order ? m_order->round() : 0; }
+
 signals:
     void exitRequested();
+    // Every card has been asked (orders that run out only); leaving early doesn't finish.
+    void sessionFinished();
+    // First check of a shown card; the receiver records it and reschedules the card.
+    void cardChecked(const rewise::storage::ReviewRecord& record);
+    // A graded exam: one record per answered card, in exam order.
+    void examGraded(const QVector<rewise::storage::ReviewRecord>& records);
 
 private:
+    static constexpr int kPrefetchCards = 2;
+
+    // A card ready to be asked.
+    struct PreparedCard final {
+        rewise::domain::Card card;                    // full text
+        rewise::review::PreparedReference reference;
+        rewise::domain::ReviewSettings scoring;       // of the card's folder
+        QString error;                                // non-empty: the body could not be read
+    };
+    static PreparedCard prepareCard(const rewise::storage::DatabaseSnapshot& db,
+                                    rewise::review::ReferenceCache* references, int index);
+
+    enum class ExamStage { None, Answering, Grading, Results };
+
+    // An exam answer as collected; graded on submit.
+    struct ExamAnswer final {
+        int card = -1;               // index into m_db->cards
+        QString text;
+        qint64 atMsUtc = 0;
+        quint32 answerMs = 0;
+        bool answered = false;       // false: never shown, or left empty
+    };
+    struct GradedAnswer final {
+        rewise::ui::widgets::ExamGrade grade;
+        rewise::storage::ReviewRecord record;
+    };
+    // Thread-safe: runs on the pool.
+    static GradedAnswer gradeAnswer(const rewise::storage::DatabaseSnapshot& db,
+                                    rewise::review::ReferenceCache* references,
+                                    const ExamAnswer& answer);
+    // gradeAnswer as a QtConcurrent map functor (result_type: Qt 5 can't deduce it from a lambda).
+    struct ExamGrader final {
+        using result_type = GradedAnswer;
+        rewise::storage::DatabaseSnapshot db;
+        std::shared_ptr<rewise::review::ReferenceCache> references;
+        GradedAnswer operator()(const ExamAnswer& a) const { return gradeAnswer(db, references.get(), a); }
+    };
+
     void wireUi();
+    // Shows the session that startSession/startExam set up.
+    void beginSession(rewise::storage::DatabaseSnapshot db,
+                      std::unique_ptr<rewise::review::CardOrder> order,
+                      const QString& title);
+    // Widgets for practice or for the current exam stage.
+    void refreshModeUi();
+    // Starts preparing the next cards of the queue; drops the ones that left the window.
+    void prefetch();
 
     void pickNextCard();
     void showCard();
+    void showFinished();
     void clearResultUi();
 
+    void recordExamAnswer();   // the current card's answer into m_examAnswers
+    void submitExam();
+    void showExamResults();
+    void updateClock();
+
 private:
     Ui::ReviewPage* ui = nullptr;
 
-    QVector<rewise::domain::Card> m_cards;
+    rewise::storage::DatabaseSnapshot m_db;
+    std::unique_ptr<rewise::review::CardOrder> m_order;
+    int m_shown = 0;         // cards shown so far, repeats included
     QString m_titleText;
 
-    int m_current = -1;
-    int m_last = -1;
+    int m_current = -1;      // index into m_db->cards
+    int m_resumeCard = -1;   // asked by the next pickNextCard() before the order's cards
+    rewise::domain::Card m_card;                     // the current card with full text
+    rewise::review::PreparedReference m_reference;   // its answer, ready to compare against
+    rewise::domain::ReviewSettings m_scoring;        // how to score it
+    // Shared with the preparations still running; outlives sessions.
+    std::shared_ptr<rewise::review::ReferenceCache> m_references;
+    QHash<int, QFuture<PreparedCard>> m_prefetched;  // card index -> preparation
+
+    // The practice session left with "back" (resumeLeftSession).
+    std::unique_ptr<rewise::review::CardOrder> m_leftOrder;
+    int m_leftCard = -1;     // shown but not checked when it was left
+    QString m_leftTitle;
+
+    QElapsedTimer m_shownAt;  // time to answer of the current card
 
     rewise::ui::widgets::InlineMessageWidget* m_msg = nullptr;
     rewise::ui::widgets::DiffTextWidget* m_diff = nullptr;
 
     bool m_revealed = false;
     bool m_checked = false;
+
+    ExamStage m_examStage = ExamStage::None;
+    QVector<ExamAnswer> m_examAnswers;
+    qint64 m_examLimitMs = 0;
+    QElapsedTimer m_examClock;
+    QTimer m_examTick;                           // refreshes the clock, enforces the limit
+    QFutureWatcher<GradedAnswer> m_grading;
+    rewise::ui::widgets::ExamResultsWidget* m_examResults = nullptr;
 };
 
 } // namespace rewise::ui::pages
@@ -0,0 +1,92 @@
+#include "StatsPage.h"
+#include "ui_StatsPage.h"
+
+#include "storage/ReviewRollups.h"
+#include "ui/widgets/DailyBarsWidget.h"
+#include "ui/widgets/NumberItem.h"
+
+#include <QDate>
+#include <QHeaderView>
+#include <QTableWidgetItem>
+
+#include <utility>
+
+namespace rewise::ui::pages {
+
+namespace {
+
+using rewise::ui::widgets::numberItem;
+
+QString percentText(double value) {
+    return QString::number(value, 'f', 1) + "%";
+}
+
+} // namespace
+
+StatsPage::StatsPage(QWidget* parent)
+    : QWidget(parent)
+    , ui(new Ui::StatsPage)
+{
+    ui->setupUi(this);
+
+    m_chart = new rewise::ui::widgets::DailyBarsWidget(ui->chartHost);
+    ui->chartHost->layout()->addWidget(m_chart);
+
+    ui->twFolders->verticalHeader()->setVisible(false);
+    ui->twFolders->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    for (int c = 1; c < ui->twFolders->columnCount(); ++c)
+        ui->twFolders->horizontalHeader()->setSectionResizeMode(c, QHeaderView::ResizeToContents);
+
+    connect(ui->btnBack, &QPushButton::clicked, this, &StatsPage::exitRequested);
+}
+
+StatsPage::~StatsPage() {
+    delete ui;
+}
+
+void StatsPage::showStats(const rewise::storage::ReviewRollups& rollups,
+                          const QVector<rewise::domain::Folder>& folders,
+                          qint32 today) {
+    const auto& total = rollups.total();
+    const auto& byDay = rollups.byDay();
+
+    if (total.checks == 0) {
+        ui->lblSummary->setText("Проверок пока не было.");
+    } else {
+        ui->lblSummary->setText(
+            QString("Всего проверок: %1 · среднее совпадение: %2 · сдано: %3 · сегодня: %4<br>"
+                    "Серия: %5 дн. подряд · лучшая серия: %6 дн.")
+                .arg(total.checks)
+                .arg(percentText(total.averagePercent()))
+                .arg(percentText(100.0 * total.passRate()))
+                .arg(byDay.value(today).checks)
+                .arg(rollups.currentStreak(today))
+                .arg(rollups.longestStreak()));
+    }
+
+    // Only the visible window is walked: O(kChartDays log days).
+    QVector<int> values(kChartDays, 0);
+    const qint32 firstDay = today - (kChartDays - 1);
+    for (auto it = byDay.lowerBound(firstDay); it != byDay.cend() && it.key() <= today; ++it)
+        values[it.key() - firstDay] = static_cast<int>(it->checks);
+    m_chart->setValues(std::move(values), QDate::fromJulianDay(today));
+
+    // Folders without checks are listed too; deleted folders keep their
+    // statistics in the file but are not shown.
+    auto* table = ui->twFolders;
+    table->setSortingEnabled(false);
+    table->setRowCount(folders.size());
+    for (int row = 0; row < folders.size(); ++row) {
+        const auto& f = folders[row];
+        const auto t = rollups.byFolder().value(f.id);
+        table->setItem(row, 0, new QTableWidgetItem(f.name));
+        table->setItem(row, 1, numberItem(t.checks, QString::number(t.checks)));
+        table->setItem(row, 2, t.checks ? numberItem(t.averagePercent(), percentText(t.averagePercent()))
+                                        : numberItem(-1, "—"));
+        table->setItem(row, 3, t.checks ? numberItem(t.passRate(), percentText(100.0 * t.passRate()))
+                                        : numberItem(-1, "—"));
+    }
+    table->setSortingEnabled(true);
+}
+
+} // namespace rewise::ui::pages
@@ -0,0 +1,49 @@
+#ifndef REWISE_UI_PAGES_STATSPAGE_H
+#define REWISE_UI_PAGES_STATSPAGE_H
+
+#include "domain/Folder.h"
+
+#include <QVector>
+#include <QWidget>
+
+QT_BEGIN_NAMESPACE
+namespace Ui { class StatsPage; }
+QT_END_NAMESPACE
+
+namespace rewise::storage {
+class ReviewRollups;
+}
+
+namespace rewise::ui::widgets {
+class DailyBarsWidget;
+}
+
+namespace rewise::ui::pages {
+
+// Review statistics: totals, streaks, checks per day and per-folder averages.
+// Everything comes from pre-aggregated rollups, so showing it never touches
+// the review history.
+class StatsPage final : public QWidget {
+    Q_OBJECT
+public:
+    static constexpr int kChartDays = 90;
+
+    explicit StatsPage(QWidget* parent = nullptr);
+    ~StatsPage() override;
+
+    // `today` is a local Julian day (see storage::ReviewLog::localDayOf).
+    void showStats(const rewise::storage::ReviewRollups& rollups,
+                   const QVector<rewise::domain::Folder>& folders,
+                   qint32 today);
+
+signals:
+    void exitRequested();
+
+private:
+    Ui::StatsPage* ui = nullptr;
+    rewise::ui::widgets::DailyBarsWidget* m_chart = nullptr;
+};
+
+} // namespace rewise::ui::pages
+
+#endif // REWISE_UI_PAGES_STATSPAGE_H
@@ -1,16 +1,51 @@
 #include "CardTableModel.h"
 
 #include <QDateTime>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
 
 namespace rewise::ui::widgets {
 
+namespace {
+
+// Text sort keys cover the start of the text only; longer prefixes almost never
+// decide the order and make keys (and their computation) expensive.
+constexpr int kSortKeyChars = 200;
+
+// Preview rows to index at once before one streamed pass over the bodies beats
+// a read per row.
+constexpr int kScanLazyRows = 64;
+
+// Stable LSD radix sort of (key, row) pairs by key, 8 bits per pass; passes where
+// every key has the same byte (e.g. the high bytes of nearby timestamps) are skipped.
+void radixSort(std::vector<std::pair<quint64, int>>* items) {
+    std::vector<std::pair<quint64, int>> tmp(items->size());
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t offsets[257] = {};
+        for (const auto& e : *items) ++offsets[((e.first >> shift) & 0xFF) + 1];
+        if (std::find(std::begin(offsets) + 1, std::end(offsets), items->size()) != std::end(offsets)) continue;
+
+        for (int b = 0; b < 256; ++b) offsets[b + 1] += offsets[b];
+        for (const auto& e : *items) tmp[offsets[(e.first >> shift) & 0xFF]++] = e;
+        items->swap(tmp);
+    }
+}
+
+} // namespace
+
 CardTableModel::CardTableModel(QObject* parent)
     : QAbstractTableModel(parent)
+    , m_display(4096) // rows; a few screens of scrolling back and forth
 {}
 
 int CardTableModel::rowCount(const QModelIndex& parent) const {
     if (parent.isValid()) return 0;
-    return m_view.size();
+    return m_state.view.size();
 }
 
 int CardTableModel::columnCount(const QModelIndex& parent) const {
@@ -34,6 +69,12 @@ Qt::ItemFlags CardTableModel::flags(const QModelIndex& index) const {
     return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
 }
 
+QCollator CardTableModel::sortCollator() {
+    QCollator collator;
+    collator.setCaseSensitivity(Qt::CaseInsensitive);
+    return collator;
+}
+
 QString CardTableModel::preview(const QString& s, int maxChars) {
     QString t = s;
     t.replace('\n', ' ');
@@ -42,131 +83,475 @@ QString CardTableModel::preview(const QString& s, int maxChars) {
     return t.left(maxChars - 1) + "…";
 }
 
-QString CardTableModel::folderNameById(const QVector<rewise::domain::Folder>& folders,
-                                      const rewise::domain::Id& id)
-{
-    for (const auto& f : folders) {
-        if (f.id == id) return f.name;
-    }
-    return QStringLiteral("?");
+const CardTableModel::DisplayRow& CardTableModel::displayRow(int storeRow) const {
+    if (const DisplayRow* cached = m_display.object(storeRow)) return *cached;
+
+    const bool lazy = !m_state.store.hasFullText(storeRow);
+    const auto shown = [lazy](const QString& s) -> QString {
+        QString t = preview(s, 120);
+        // A lazy row's preview may fit the width although the text goes on.
+        const bool cut = lazy && s.size() >= rewise::storage::CardBodyStore::kPreviewChars - 1;
+        if (cut && !t.endsWith(QStringLiteral("…"))) t = t.left(119) + "…";
+        return t;
+    };
+
+    auto* d = new DisplayRow;
+    d->question = shown(m_state.store.question(storeRow));
+    d->answer = shown(m_state.store.answer(storeRow));
+    const auto dt = QDateTime::fromMSecsSinceEpoch(m_state.store.updatedAt()[storeRow], Qt::UTC).toLocalTime();
+    d->updated = dt.toString("yyyy-MM-dd HH:mm");
+    m_display.insert(storeRow, d);
+    return *d;
+}
+
+void CardTableModel::refreshFolderNames() {
+    m_folderNames.clear();
+    m_folderNames.reserve(m_state.folders.size());
+    for (const auto& f : m_state.folders) m_folderNames.insert(f.id, f.name);
 }
 
 QVariant CardTableModel::data(const QModelIndex& index, int role) const {
     if (!index.isValid()) return {};
     const int row = index.row();
     const int col = index.column();
-    if (row < 0 || row >= m_view.size()) return {};
-    const int cardIdx = m_view[row];
-    if (cardIdx < 0 || cardIdx >= m_db.cards.size()) return {};
-
-    const auto& c = m_db.cards[cardIdx];
+    if (row < 0 || row >= m_state.view.size()) return {};
+    const int storeRow = m_state.view[row];
 
     if (role == Qt::DisplayRole) {
         switch (col) {
-            case QuestionCol: return preview(c.question, 120);
-            case AnswerCol:   return preview(c.answer, 120);
-            case FolderCol:   return folderNameById(m_db.folders, c.folderId);
-            case UpdatedCol: {
-                const auto dt = QDateTime::fromMSecsSinceEpoch(c.updatedAtMsUtc, Qt::UTC).toLocalTime();
-                return dt.toString("yyyy-MM-dd HH:mm");
-            }
+            case QuestionCol: return displayRow(storeRow).question;
+            case AnswerCol:   return displayRow(storeRow).answer;
+            case FolderCol:   return m_folderNames.value(m_state.store.folderIds()[storeRow], QStringLiteral("?"));
+            case UpdatedCol:  return displayRow(storeRow).updated;
             default: return {};
         }
     }
 
-    // Полезно: id карточки в UserRole.
-    if (role == Qt::UserRole) {
-        return c.id.toString();
+    switch (role) {
+        case Qt::UserRole: // Полезно: id карточки в UserRole.
+            return m_state.store.ids()[storeRow].toString();
+        case AnswerPreviewRole:
+            return displayRow(storeRow).answer;
+        case MetaRole:
+            return m_folderNames.value(m_state.store.folderIds()[storeRow], QStringLiteral("?"))
+                   + QStringLiteral(" · ") + displayRow(storeRow).updated;
+        case UpdatedAtRole:
+            return m_state.store.updatedAt()[storeRow];
+        default:
+            break;
     }
 
     return {};
 }
 
-void CardTableModel::setDatabase(rewise::storage::Database db) {
-    m_db = std::move(db);
-    rebuildView();
+void CardTableModel::setDatabase(rewise::storage::DatabaseSnapshot db) {
+    if (!db) return;
+    // The store is rebuilt on the worker; until then the old rows stay on screen.
+    m_pendingDb = std::move(db);
+    requestView();
+}
+
+void CardTableModel::applyChanges(const rewise::storage::DatabaseSnapshot& db,
+                                  const rewise::storage::ChangeEvents& events) {
+    using Kind = rewise::storage::ChangeEvent::Kind;
+    if (!db) return;
+
+    // A full rebuild is already under way: just rebuild from the newer version.
+    if (m_pendingDb) {
+        setDatabase(db);
+        return;
+    }
+
+    // Folder names first: sort keys of upserted cards may need them.
+    m_state.folders = db->folders;
+    refreshFolderNames();
+
+    bool foldersChanged = false;
+    for (const auto& e : events) {
+        switch (e.kind) {
+            case Kind::Reset:
+                setDatabase(db);
+                return;
+            case Kind::CardInserted:
+            case Kind::CardUpdated:
+                applyCardUpsert(*db, e.id);
+                break;
+            case Kind::CardRemoved:
+                applyCardRemoved(e.id);
+                break;
+            case Kind::FolderInserted:
+            case Kind::FolderRenamed:
+            case Kind::FolderRemoved:
+                foldersChanged = true;
+                break;
+            case Kind::FolderSettingsChanged:
+                break;
+        }
+    }
+
+    // Retired rows only cost memory; compact once they outnumber live ones.
+    if (m_state.store.deadRows() > 1024 && m_state.store.deadRows() > m_state.store.size() / 2) {
+        setDatabase(db);
+        return;
+    }
+
+    // The search index is not touched here: new rows are indexed by the next
+    // view job, on the worker (a GUI-thread update would deep-copy an index a
+    // running job shares, and read lazy bodies). Until then fuzzy scoring checks
+    // words the index doesn't know directly.
+
+    if (m_pending || (foldersChanged && m_state.params.sortColumn == FolderCol)) {
+        // The requested view was computed from older state (or folder-name keys changed).
+        requestView();
+    } else if (foldersChanged && !m_state.view.isEmpty()) {
+        emit dataChanged(index(0, FolderCol), index(m_state.view.size() - 1, FolderCol), {Qt::DisplayRole});
+    }
+}
+
+void CardTableModel::applyCardUpsert(const rewise::storage::Database& db, const rewise::domain::Id& id) {
+    const int dbIdx = db.cardIndexById(id);
+    if (dbIdx < 0) return;
+
+    ViewState& s = m_state;
+    const int oldRow = s.store.rowById(id);
+    const int oldPos = (oldRow >= 0) ? s.viewPosition(oldRow) : -1;
+    if (oldRow >= 0) m_display.remove(oldRow); // retired below
+
+    const int newRow = s.store.append(db, dbIdx);
+    if (s.usesRowKeys()) s.computeSortKey(newRow, sortCollator());
+    s.computeRelevance(newRow);
+    const bool visible = s.matchesFilter(newRow);
+
+    if (oldPos >= 0 && visible) {
+        // Still listed: update in place, or move (keeps selection) if the sort key moved.
+        const int pos = s.insertPosition(newRow); // in the current view, which still holds oldRow
+        if (pos == oldPos || pos == oldPos + 1) {
+            s.view[oldPos] = newRow;
+            emit dataChanged(index(oldPos, 0), index(oldPos, ColCount - 1));
+        } else {
+            beginMoveRows(QModelIndex(), oldPos, oldPos, QModelIndex(), pos);
+            s.view.remove(oldPos);
+            s.view.insert(pos > oldPos ? pos - 1 : pos, newRow);
+            endMoveRows();
+        }
+    } else if (oldPos >= 0) {
+        beginRemoveRows(QModelIndex(), oldPos, oldPos);
+        s.view.remove(oldPos);
+        endRemoveRows();
+    } else if (visible) {
+        const int pos = s.insertPosition(newRow);
+        beginInsertRows(QModelIndex(), pos, pos);
+        s.view.insert(pos, newRow);
+        endInsertRows();
+    }
+}
+
+void CardTableModel::applyCardRemoved(const rewise::domain::Id& id) {
+    const int row = m_state.store.rowById(id);
+    if (row < 0) return;
+
+    const int pos = m_state.viewPosition(row);
+    if (pos >= 0) {
+        beginRemoveRows(QModelIndex(), pos, pos);
+        m_state.view.remove(pos);
+        endRemoveRows();
+    }
+    m_display.remove(row);
+    m_state.store.remove(id);
 }
 
 void CardTableModel::setFolderFilter(const rewise::domain::Id& folderId) {
-    if (m_filterFolderId == folderId) return;
-    m_filterFolderId = folderId;
-    rebuildView();
+    if (m_params.filterFolderId == folderId) return;
+    m_params.filterFolderId = folderId;
+    requestView();
 }
 
 void CardTableModel::setSearchQuery(QString q) {
     q = q.simplified();
-    if (m_search == q) return;
-    m_search = std::move(q);
-    rebuildView();
+    if (m_params.search == q) return;
+    m_params.search = std::move(q);
+    requestView();
+}
+
+void CardTableModel::setFuzzySearch(bool on) {
+    if (m_params.fuzzy == on) return;
+    m_params.fuzzy = on;
+    requestView();
 }
 
 void CardTableModel::sort(int column, Qt::SortOrder order) {
     if (column < 0 || column >= ColCount) return;
-    m_sortColumn = column;
-    m_sortOrder = order;
-    rebuildView();
+    m_params.sortColumn = column;
+    m_params.sortOrder = order;
+    requestView();
 }
 
-void CardTableModel::rebuildView() {
-    beginResetModel();
-    m_view.clear();
-    m_view.reserve(m_db.cards.size());
+void CardTableModel::requestView() {
+    // Snapshot: shares every container with m_state; later edits on the GUI
+    // thread detach their own copy, so the worker never sees them.
+    ViewState job = m_state;
+    job.params = m_params;
+    job.fuzzyQuery = rewise::storage::FuzzySearch(m_params.search);
+    const rewise::storage::DatabaseSnapshot db = m_pendingDb;
+
+    const quint64 generation = ++m_generation;
+    m_pending = true;
+
+    auto* watcher = new QFutureWatcher<ViewState>(this);
+    connect(watcher, &QFutureWatcher<ViewState>::finished, this, [this, watcher, generation] {
+        watcher->deleteLater();
+        if (generation != m_generation) return; // superseded by a newer request
+
+        const bool databaseShown = static_cast<bool>(m_pendingDb);
+        beginResetModel();
+        m_state = watcher->result();
+        if (databaseShown) m_display.clear(); // store rows were renumbered
+        refreshFolderNames();
+        endResetModel();
+        if (databaseShown) m_pendingDb.reset();
+        m_pending = false;
+        emit viewReady();
+    });
+
+    watcher->setFuture(QtConcurrent::run([job, db]() {
+        ViewState s = job;
+        if (db) {
+            s.store = rewise::storage::CardStore::fromDatabase(*db);
+            s.folders = db->folders;
+            s.bodies = db->bodyStore();
+            s.index.clear(); // rebuilt on the next search
+            s.indexedRows = 0;
+        }
+        s.rebuild();
+        return s;
+    }));
+}
 
-    const QString s = m_search.toLower();
+const rewise::storage::TextIndex& CardTableModel::ViewState::searchIndex() {
+    if (indexedRows == store.size()) return index;
 
-    for (int i = 0; i < m_db.cards.size(); ++i) {
-        const auto& c = m_db.cards[i];
+    // Preview rows in bulk (the first search in lazy mode): their full text comes
+    // from one streamed pass over the bodies, in the backend's order, so the
+    // postings are sorted afterwards. Rows the pass missed are read one by one.
+    QHash<rewise::domain::Id, int> lazy;
+    for (int row = indexedRows; row < store.size(); ++row) {
+        if (store.isLive(row) && !store.hasFullText(row)) lazy.insert(store.ids()[row], row);
+    }
+    bool unordered = false;
+    if (bodies && lazy.size() >= kScanLazyRows) {
+        bodies->scan([&](const rewise::domain::Id& id, const rewise::storage::CardBody& body) {
+            const auto it = lazy.find(id);
+            if (it == lazy.end()) return;
+            index.addRow(*it, body.question, body.answer);
+            lazy.erase(it);
+            unordered = true;
+        });
+    }
 
-        if (m_filterFolderId.isValid() && c.folderId != m_filterFolderId) continue;
+    for (; indexedRows < store.size(); ++indexedRows) {
+        const int row = indexedRows;
+        if (!store.isLive(row)) continue;
+        if (!store.hasFullText(row) && !lazy.contains(store.ids()[row])) continue; // indexed by the pass
+        const rewise::storage::CardBody text = fullText(row);
+        index.addRow(row, text.question, text.answer);
+    }
+    if (unordered) index.sortPostings();
+    return index;
+}
 
-        if (!s.isEmpty()) {
-            const QString q = c.question.toLower();
-            const QString a = c.answer.toLower();
-            if (!q.contains(s) && !a.contains(s)) continue;
+rewise::storage::CardBody CardTableModel::ViewState::fullText(int storeRow) const {
+    rewise::storage::CardBody text{store.question(storeRow), store.answer(storeRow)};
+    if (!store.hasFullText(storeRow) && bodies) bodies->read(store.ids()[storeRow], &text, nullptr, false);
+    return text;
+}
+
+void CardTableModel::ViewState::rebuild() {
+    view.clear();
+    relevance.clear();
+
+    QVector<int> hits;
+    if (ranksByRelevance()) {
+        // Fuzzy: the index yields rows matching every query word; score them for ranking.
+        hits = fuzzyQuery.prepare(searchIndex());
+        relevance.fill(-1, store.size());
+        for (int row : hits) {
+            if (!store.isLive(row)) continue;
+            if (params.filterFolderId.isValid() && store.folderIds()[row] != params.filterFolderId) continue;
+            computeRelevance(row);
+            if (relevance[row] >= 0) view.push_back(row);
+        }
+    } else if (!params.search.isEmpty() && searchIndex().candidates(params.search, &hits)) {
+        // Search: only the index's candidates are verified.
+        view.reserve(hits.size());
+        for (int row : hits) {
+            if (store.isLive(row) && matchesFilter(row)) view.push_back(row);
         }
+    } else {
+        // Folder filter: the store's row list for the folder.
+        const QVector<int> candidates = params.filterFolderId.isValid() ? store.rowsInFolder(params.filterFolderId)
+                                                                        : store.liveRows();
+        if (params.search.isEmpty()) {
+            view = candidates;
+        } else {
+            view.reserve(candidates.size());
+            for (int row : candidates) {
+                if (matchesFilter(row)) view.push_back(row);
+            }
+        }
+    }
+
+    // Keys once per row, so comparisons neither collate text nor look folders up.
+    textKeys.clear();
+    folderRanks.clear();
+    folderRankById.clear();
+    if (usesRowKeys()) {
+        const QCollator collator = sortCollator();
+        if (params.sortColumn == FolderCol) rankFolders(collator);
+        for (int row : view) computeSortKey(row, collator);
+    }
+
+    if (params.sortColumn == UpdatedCol && !ranksByRelevance()) {
+        sortByTimestamp();
+    } else {
+        std::sort(view.begin(), view.end(), [this](int a, int b) { return lessRows(a, b); });
+    }
+}
+
+void CardTableModel::ViewState::rankFolders(const QCollator& collator) {
+    QVector<int> order(folders.size());
+    for (int i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        const int c = collator.compare(folders[a].name, folders[b].name);
+        return (c != 0) ? (c < 0) : rewise::domain::Id::compare(folders[a].id, folders[b].id) < 0;
+    });
+    folderRankById.reserve(order.size());
+    for (int rank = 0; rank < order.size(); ++rank) folderRankById.insert(folders[order[rank]].id, rank);
+}
 
-        m_view.push_back(i);
+void CardTableModel::ViewState::sortByTimestamp() {
+    // Radix on the timestamp (sign bit flipped so signed order = unsigned order) ...
+    std::vector<std::pair<quint64, int>> items;
+    items.reserve(view.size());
+    const QVector<qint64>& updated = store.updatedAt();
+    for (int row : view) items.emplace_back(static_cast<quint64>(updated[row]) ^ (quint64(1) << 63), row);
+    radixSort(&items);
+
+    // ... then the id tie-break of lessRows() within runs of equal timestamps (usually length 1).
+    const QVector<rewise::domain::Id>& ids = store.ids();
+    for (size_t i = 0; i < items.size();) {
+        size_t j = i + 1;
+        while (j < items.size() && items[j].first == items[i].first) ++j;
+        if (j - i > 1) {
+            std::sort(items.begin() + i, items.begin() + j, [&](const auto& a, const auto& b) {
+                return rewise::domain::Id::compare(ids[a.second], ids[b.second]) < 0;
+            });
+        }
+        i = j;
     }
 
-    auto cmp = [&](int aIdx, int bIdx) -> bool {
-        const auto& a = m_db.cards[aIdx];
-        const auto& b = m_db.cards[bIdx];
+    // The order is total, so descending is exactly the reverse.
+    const bool ascending = (params.sortOrder == Qt::AscendingOrder);
+    const int n = static_cast<int>(items.size());
+    for (int i = 0; i < n; ++i) view[i] = items[ascending ? i : n - 1 - i].second;
+}
+
+bool CardTableModel::ViewState::usesRowKeys() const {
+    return params.sortColumn == QuestionCol || params.sortColumn == AnswerCol || params.sortColumn == FolderCol;
+}
 
-        auto less = [&](auto x, auto y) { return (m_sortOrder == Qt::AscendingOrder) ? (x < y) : (x > y); };
+void CardTableModel::ViewState::computeRelevance(int storeRow) {
+    if (!ranksByRelevance()) return;
+    if (relevance.size() < store.size()) relevance.insert(relevance.size(), store.size() - relevance.size(), -1);
+    const rewise::storage::CardBody text = fullText(storeRow);
+    relevance[storeRow] = fuzzyQuery.score(index, text.question, text.answer);
+}
 
-        switch (m_sortColumn) {
-            case QuestionCol: return less(a.question.toLower(), b.question.toLower());
-            case AnswerCol:   return less(a.answer.toLower(), b.answer.toLower());
-            case FolderCol:   return less(folderNameById(m_db.folders, a.folderId).toLower(),
-                                          folderNameById(m_db.folders, b.folderId).toLower());
-            case UpdatedCol:
-            default:          return less(a.updatedAtMsUtc, b.updatedAtMsUtc);
+void CardTableModel::ViewState::computeSortKey(int storeRow, const QCollator& collator) {
+    switch (params.sortColumn) {
+        case QuestionCol:
+        case AnswerCol: {
+            if (textKeys.size() < store.size()) textKeys.resize(store.size());
+            const QString text = (params.sortColumn == QuestionCol) ? store.question(storeRow) : store.answer(storeRow);
+            textKeys[storeRow] = collator.sortKey(text.left(kSortKeyChars));
+            break;
         }
+        case FolderCol:
+            if (folderRanks.size() < store.size()) folderRanks.resize(store.size());
+            // Folders created since the last rebuild sort last until the next one.
+            folderRanks[storeRow] = folderRankById.value(store.folderIds()[storeRow], folderRankById.size());
+            break;
+        default:
+            break;
+    }
+}
+
+bool CardTableModel::ViewState::lessRows(int a, int b) const {
+    // Best match first, whatever the column order.
+    if (ranksByRelevance() && relevance[a] != relevance[b]) return relevance[a] < relevance[b];
+
+    int c = 0;
+    if (params.sortColumn == FolderCol) {
+        c = (folderRanks[a] < folderRanks[b]) ? -1 : (folderRanks[a] > folderRanks[b] ? 1 : 0);
+    } else if (usesRowKeys()) {
+        c = textKeys[a]->compare(*textKeys[b]);
+    } else {
+        const qint64 ua = store.updatedAt()[a];
+        const qint64 ub = store.updatedAt()[b];
+        c = (ua < ub) ? -1 : (ua > ub ? 1 : 0);
+    }
+
+    // Ties: binary id order keeps rows stable regardless of storage order (removeCard swaps)
+    // and makes the order total, so binary search finds exact positions.
+    if (c == 0) c = rewise::domain::Id::compare(store.ids()[a], store.ids()[b]);
+    return (params.sortOrder == Qt::AscendingOrder) ? (c < 0) : (c > 0);
+}
+
+bool CardTableModel::ViewState::matchesFilter(int storeRow) const {
+    if (params.filterFolderId.isValid() && store.folderIds()[storeRow] != params.filterFolderId) return false;
+    if (params.search.isEmpty()) return true;
+    if (ranksByRelevance()) return storeRow < relevance.size() && relevance[storeRow] >= 0;
+    const auto contains = [this](const QString& question, const QString& answer) {
+        return question.contains(params.search, Qt::CaseInsensitive)
+               || answer.contains(params.search, Qt::CaseInsensitive);
     };
+    if (contains(store.question(storeRow), store.answer(storeRow))) return true;
+    // A lazy row can still match past its preview.
+    if (store.hasFullText(storeRow)) return false;
+    const rewise::storage::CardBody text = fullText(storeRow);
+    return contains(text.question, text.answer);
+}
+
+int CardTableModel::ViewState::insertPosition(int storeRow) const {
+    const auto it = std::lower_bound(view.begin(), view.end(), storeRow,
+                                     [this](int a, int b) { return lessRows(a, b); });
+    return static_cast<int>(it - view.begin());
+}
 
-    std::sort(m_view.begin(), m_view.end(), cmp);
-    endResetModel();
+int CardTableModel::ViewState::viewPosition(int storeRow) const {
+    // A row's sort key is fixed once computed, so it can be located by binary search.
+    if (params.sortColumn == FolderCol && storeRow >= folderRanks.size()) return -1;
+    if (usesRowKeys() && params.sortColumn != FolderCol
+        && (storeRow >= textKeys.size() || !textKeys[storeRow])) return -1;
+    if (ranksByRelevance() && (storeRow >= relevance.size())) return -1;
+    const int pos = insertPosition(storeRow);
+    return (pos < view.size() && view[pos] == storeRow) ? pos : -1;
 }
 
 rewise::domain::Id CardTableModel::cardIdAtRow(int row) const {
-    const auto* c = cardAtRow(row);
-    return c ? c->id : rewise::domain::Id{};
+    const auto c = cardAtRow(row);
+    return c.isValid() ? c.id() : rewise::domain::Id{};
 }
 
-const rewise::domain::Card* CardTableModel::cardAtRow(int row) const {
-    if (row < 0 || row >= m_view.size()) return nullptr;
-    const int idx = m_view[row];
-    if (idx < 0 || idx >= m_db.cards.size()) return nullptr;
-    return &m_db.cards[idx];
+rewise::storage::CardStore::CardView CardTableModel::cardAtRow(int row) const {
+    if (row < 0 || row >= m_state.view.size()) return {};
+    return m_state.store.at(m_state.view[row]);
 }
 
 int CardTableModel::rowForCardId(const rewise::domain::Id& id) const {
     if (!id.isValid()) return -1;
-    for (int r = 0; r < m_view.size(); ++r) {
-        const int idx = m_view[r];
-        if (idx >= 0 && idx < m_db.cards.size() && m_db.cards[idx].id == id) return r;
-    }
-    return -1;
+    const int storeRow = m_state.store.rowById(id);
+    if (storeRow < 0) return -1;
+    return m_state.viewPosition(storeRow);
 }
 
 } // namespace rewise::ui::widgets
@@ -1,14 +1,33 @@
 #ifndef REWISE_UI_WIDGETS_CARDTABLEMODEL_H
 #define REWISE_UI_WIDGETS_CARDTABLEMODEL_H
 
+#include "storage/CardBodyStore.h"
+#include "storage/CardStore.h"
+#include "storage/ChangeEvents.h"
 #include "storage/Database.h"
+#include "storage/FuzzySearch.h"
+#include "storage/TextIndex.h"
 #include "domain/Id.h"
 
 #include <QAbstractTableModel>
+#include <QCache>
+#include <QCollator>
+#include <QHash>
 #include <QVector>
 
+#include <memory>
+#include <optional>
+
 namespace rewise::ui::widgets {
 
+// Cards of the library table.
+//
+// Filtering and sorting run on a worker thread over a snapshot of the model's
+// state (see ViewState); the rows on screen stay as they are until the result
+// arrives, then the view is swapped in with one model reset and viewReady() is
+// emitted. A newer request (keystroke, folder click, new database) supersedes
+// older ones: their results are dropped by generation number. Record-level
+// changes are still applied to the shown rows synchronously.
 class CardTableModel final : public QAbstractTableModel {
     Q_OBJECT
 public:
@@ -20,6 +39,14 @@ public:
         ColCount
     };
 
+    // Extra roles (any column) for views that show a whole card per index,
+    // e.g. the tile grid. Qt::UserRole holds the card id string.
+    enum Roles {
+        AnswerPreviewRole = Qt::UserRole + 1,
+        MetaRole,           // "folder · updated"
+        UpdatedAtRole       // qint64 ms UTC; changes with every edit
+    };
+
     explicit CardTableModel(QObject* parent = nullptr);
 
     int rowCount(const QModelIndex& parent = QModelIndex()) const override;
@@ -28,36 +55,123 @@ public:
     QVariant data(const QModelIndex& index, int role) const override;
     Qt::ItemFlags flags(const QModelIndex& index) const override;
 
-    void setDatabase(rewise::storage::Database db);
+    void setDatabase(rewise::storage::DatabaseSnapshot db);
+    // Applies record-level changes with row inserts/moves/removals at the sorted
+    // position (O(log n) comparisons each). `db` is the version after the events.
+    void applyChanges(const rewise::storage::DatabaseSnapshot& db, const rewise::storage::ChangeEvents& events);
 
+    // Setters below request a new view; getters report the latest request.
     void setFolderFilter(const rewise::domain::Id& folderId); // invalid => all
-    rewise::domain::Id folderFilter() const { return m_filterFolderId; }
+    rewise::domain::Id folderFilter() const { return m_params.filterFolderId; }
 
     void setSearchQuery(QString q);
-    QString searchQuery() const { return m_search; }
+    QString searchQuery() const { return m_params.search; }
+
+    // Typo-tolerant word search (see storage::FuzzySearch). While a fuzzy query is
+    // active, rows are ordered by relevance first, then by the sort column.
+    void setFuzzySearch(bool on);
+    bool fuzzySearch() const { return m_params.fuzzy; }
 
     void sort(int column, Qt::SortOrder order) override;
 
+    // True while a requested view is being computed.
+    bool isUpdating() const { return m_pending; }
+
     rewise::domain::Id cardIdAtRow(int row) const;
-    const rewise::domain::Card* cardAtRow(int row) const;
+    rewise::storage::CardStore::CardView cardAtRow(int row) const;
 
     int rowForCardId(const rewise::domain::Id& id) const;
 
+signals:
+    // A requested view has been swapped in (after the model reset).
+    void viewReady();
+
 private:
-    void rebuildView();
+    struct ViewParams final {
+        rewise::domain::Id filterFolderId; // invalid => all
+        QString search;
+        bool fuzzy = false;
+        int sortColumn = UpdatedCol;
+        Qt::SortOrder sortOrder = Qt::DescendingOrder;
+    };
+
+    // Everything a view is computed from, plus the result. All members are
+    // implicitly shared containers, so a copy is a cheap snapshot that a worker
+    // can rebuild while the GUI thread keeps editing its own copy.
+    struct ViewState final {
+        // Columnar view of the cards (filters/sorts scan dense columns; text is slices
+        // of the database's arena, not a copy) + folder names.
+        rewise::storage::CardStore store;
+        QVector<rewise::domain::Folder> folders;
+        std::shared_ptr<const rewise::storage::CardBodyStore> bodies; // lazy-body mode: full text of preview rows
+
+        // Inverted index over store rows; built on the worker by the first search,
+        // then extended there by later view jobs (rows appended since).
+        rewise::storage::TextIndex index;
+        int indexedRows = 0;              // store rows [0, indexedRows) are indexed
+
+        ViewParams params;
+        rewise::storage::FuzzySearch fuzzyQuery;
+
+        QVector<int> view;                // rows of store, sorted by lessRows()
+
+        // Sort keys, computed once per row (fixed until the next rebuild):
+        QVector<std::optional<QCollatorSortKey>> textKeys; // QuestionCol/AnswerCol
+        QHash<rewise::domain::Id, int> folderRankById;     // FolderCol: position of the name in collation order
+        QVector<int> folderRanks;                          // FolderCol, per store row
+        QVector<int> relevance;           // per store row while ranking: FuzzySearch score, -1 = no match
+
+        void rebuild();
+        void rankFolders(const QCollator& collator);
+        void sortByTimestamp();
+
+        // Brings the index up to date with the store (incremental) and returns it.
+        // Indexes the full text, lazy rows included.
+        const rewise::storage::TextIndex& searchIndex();
+
+        // Question/answer of a row. Preview rows are read through `bodies`, uncached
+        // (index builds would flush the LRU); the preview is the fallback if that fails.
+        rewise::storage::CardBody fullText(int storeRow) const;
+
+        bool usesRowKeys() const;
+        bool ranksByRelevance() const { return params.fuzzy && !fuzzyQuery.isEmpty(); }
+        void computeSortKey(int storeRow, const QCollator& collator);
+        void computeRelevance(int storeRow);
+        bool lessRows(int a, int b) const;
+        bool matchesFilter(int storeRow) const;
+        int viewPosition(int storeRow) const;   // -1 if not in the view
+        int insertPosition(int storeRow) const;
+    };
+
+    // Starts computing a view for m_params (and m_pendingDb, if set) on a worker.
+    void requestView();
+
+    void applyCardUpsert(const rewise::storage::Database& db, const rewise::domain::Id& id);
+    void applyCardRemoved(const rewise::domain::Id& id);
+
+    // Locale-aware, case-insensitive. Not shared between threads: each user makes its own.
+    static QCollator sortCollator();
 
     static QString preview(const QString& s, int maxChars = 80);
-    static QString folderNameById(const QVector<rewise::domain::Folder>& folders,
-                                  const rewise::domain::Id& id);
 
-    rewise::storage::Database m_db;
+    // Display strings of one store row. Store rows never change (edits append a
+    // new row), so entries only go stale when the store is rebuilt.
+    struct DisplayRow final {
+        QString question;
+        QString answer;
+        QString updated;
+    };
+    const DisplayRow& displayRow(int storeRow) const;
+    void refreshFolderNames();
 
-    QVector<int> m_view; // indices into m_db.cards
-    rewise::domain::Id m_filterFolderId; // invalid => all
-    QString m_search;
+    ViewState m_state;                           // what is on screen
+    mutable QCache<int, DisplayRow> m_display;   // by store row, filled by data()
+    QHash<rewise::domain::Id, QString> m_folderNames;
+    ViewParams m_params;                         // latest requested parameters
+    rewise::storage::DatabaseSnapshot m_pendingDb; // set until a view of it is shown
 
-    int m_sortColumn = UpdatedCol;
-    Qt::SortOrder m_sortOrder = Qt::DescendingOrder;
+    quint64 m_generation = 0;                    // of the latest request
+    bool m_pending = false;
 };
 
 } // namespace rewise::ui::widgets
@@ -0,0 +1,140 @@
+#include "CardTileDelegate.h"
+
+#include "CardTableModel.h"
+
+#include <QFontMetrics>
+#include <QPainter>
+#include <QPainterPath>
+#include <QTextLayout>
+
+namespace rewise::ui::widgets {
+
+namespace {
+
+constexpr int kTileWidth = 260;
+constexpr int kPreviewLines = 2;
+constexpr int kOuterMargin = 4;  // gap between tiles (half on each side)
+constexpr int kPadX = 12;
+constexpr int kPadY = 10;
+constexpr int kSpacing = 4;
+
+// Up to `maxLines` lines of `text` wrapped at `width`; the last one is elided if text remains.
+QStringList wrapLines(const QString& text, const QFont& font, int width, int maxLines) {
+    QStringList lines;
+    const QFontMetrics fm(font);
+
+    QTextLayout layout(text, font);
+    layout.beginLayout();
+    while (lines.size() < maxLines) {
+        QTextLine line = layout.createLine();
+        if (!line.isValid()) break;
+        line.setLineWidth(width);
+
+        const int end = line.textStart() + line.textLength();
+        if (lines.size() == maxLines - 1 && end < text.size()) {
+            lines << fm.elidedText(text.mid(line.textStart()), Qt::ElideRight, width);
+        } else {
+            lines << text.mid(line.textStart(), line.textLength()).trimmed();
+        }
+    }
+    layout.endLayout();
+    return lines;
+}
+
+} // namespace
+
+CardTileDelegate::CardTileDelegate(QObject* parent)
+    : QStyledItemDelegate(parent)
+    , m_text(2048) // tiles; several screens
+{}
+
+QFont CardTileDelegate::titleFont(const QFont& base) {
+    QFont f = base;
+    f.setBold(true);
+    return f;
+}
+
+QFont CardTileDelegate::metaFont(const QFont& base) {
+    QFont f = base;
+    if (f.pointSizeF() > 0) f.setPointSizeF(f.pointSizeF() * 0.9);
+    return f;
+}
+
+const CardTileDelegate::TileText& CardTileDelegate::textFor(const QStyleOptionViewItem& option,
+                                                            const QModelIndex& index,
+                                                            int width) const {
+    const QString meta = index.data(CardTableModel::MetaRole).toString();
+    // Meta is part of the key: folder renames change it without touching the card.
+    const QString key = index.data(Qt::UserRole).toString() + QLatin1Char('|')
+                        + QString::number(index.data(CardTableModel::UpdatedAtRole).toLongLong())
+                        + QLatin1Char('|') + QString::number(width) + QLatin1Char('|') + meta;
+    if (const TileText* cached = m_text.object(key)) return *cached;
+
+    QString q = index.data(Qt::DisplayRole).toString();
+    if (q.isEmpty()) q = QStringLiteral("Без вопроса");
+    QString a = index.data(CardTableModel::AnswerPreviewRole).toString();
+    if (a.isEmpty()) a = QStringLiteral("—");
+
+    auto* t = new TileText;
+    t->title = QFontMetrics(titleFont(option.font)).elidedText(q, Qt::ElideRight, width);
+    t->preview = wrapLines(a, option.font, width, kPreviewLines);
+    t->meta = QFontMetrics(metaFont(option.font)).elidedText(meta, Qt::ElideRight, width);
+    m_text.insert(key, t);
+    return *t;
+}
+
+QSize CardTileDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex&) const {
+    // Same for every tile (the view uses uniform item sizes).
+    const int title = QFontMetrics(titleFont(option.font)).height();
+    const int line = QFontMetrics(option.font).height();
+    const int meta = QFontMetrics(metaFont(option.font)).height();
+    const int h = 2 * kOuterMargin + 2 * kPadY + title + kPreviewLines * line + meta + 2 * kSpacing;
+    return {kTileWidth, h};
+}
+
+void CardTileDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const {
+    if (!index.isValid()) return;
+
+    const QRect tile = option.rect.adjusted(kOuterMargin, kOuterMargin, -kOuterMargin, -kOuterMargin);
+    const QRect content = tile.adjusted(kPadX, kPadY, -kPadX, -kPadY);
+    const bool selected = option.state.testFlag(QStyle::State_Selected);
+    const bool hovered = option.state.testFlag(QStyle::State_MouseOver);
+    const QPalette& pal = option.palette;
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing, true);
+
+    QPainterPath frame;
+    frame.addRoundedRect(QRectF(tile).adjusted(0.5, 0.5, -0.5, -0.5), 8, 8);
+    painter->fillPath(frame, hovered && !selected ? pal.color(QPalette::AlternateBase) : pal.color(QPalette::Base));
+    painter->setPen(QPen(selected ? pal.color(QPalette::Highlight) : pal.color(QPalette::Mid), selected ? 2 : 1));
+    painter->drawPath(frame);
+
+    const TileText& t = textFor(option, index, content.width());
+    int y = content.top();
+
+    painter->setPen(pal.color(QPalette::Text));
+    const QFont tf = titleFont(option.font);
+    painter->setFont(tf);
+    const int titleH = QFontMetrics(tf).height();
+    painter->drawText(QRect(content.left(), y, content.width(), titleH), Qt::AlignLeft | Qt::AlignVCenter, t.title);
+    y += titleH + kSpacing;
+
+    painter->setFont(option.font);
+    const int lineH = QFontMetrics(option.font).height();
+    for (const QString& l : t.preview) {
+        painter->drawText(QRect(content.left(), y, content.width(), lineH), Qt::AlignLeft | Qt::AlignVCenter, l);
+        y += lineH;
+    }
+    y = content.top() + titleH + kSpacing + kPreviewLines * lineH + kSpacing;
+
+    const QFont mf = metaFont(option.font);
+    painter->setFont(mf);
+    painter->setPen(pal.color(QPalette::Disabled, QPalette::Text));
+    painter->drawText(QRect(content.left(), y, content.width(), QFontMetrics(mf).height()),
+                      Qt::AlignLeft | Qt::AlignVCenter, t.meta);
+
+    painter->restore();
+}
+
+} // namespace rewise::ui::widgets
@@ -0,0 +1,42 @@
+#ifndef REWISE_UI_WIDGETS_CARDTILEDELEGATE_H
+#define REWISE_UI_WIDGETS_CARDTILEDELEGATE_H
+
+#include <QCache>
+#include <QStringList>
+#include <QStyledItemDelegate>
+
+namespace rewise::ui::widgets {
+
+// Paints one card as a tile (title / two-line answer preview / meta line) for a
+// QListView in IconMode over CardTableModel. No widgets per card: the view asks
+// for visible tiles only, and every tile has the same size, so the view can lay
+// out 100k cards without measuring them.
+//
+// Wrapped and elided text is cached per card version (id + update time) and
+// tile width, so scrolling repaints don't redo text layout.
+class CardTileDelegate final : public QStyledItemDelegate {
+    Q_OBJECT
+public:
+    explicit CardTileDelegate(QObject* parent = nullptr);
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+private:
+    struct TileText final {
+        QString title;
+        QStringList preview; // at most kPreviewLines, last one elided
+        QString meta;
+    };
+
+    const TileText& textFor(const QStyleOptionViewItem& option, const QModelIndex& index, int width) const;
+
+    static QFont titleFont(const QFont& base);
+    static QFont metaFont(const QFont& base);
+
+    mutable QCache<QString, TileText> m_text;
+};
+
+} // namespace rewise::ui::widgets
+
+#endif // REWISE_UI_WIDGETS_CARDTILEDELEGATE_H
@@ -0,0 +1,82 @@
+#include "DailyBarsWidget.h"
+
+#include <QEvent>
+#include <QHelpEvent>
+#include <QLocale>
+#include <QPainter>
+#include <QToolTip>
+
+#include <algorithm>
+#include <utility>
+
+namespace rewise::ui::widgets {
+
+DailyBarsWidget::DailyBarsWidget(QWidget* parent)
+    : QWidget(parent)
+{
+    setMinimumHeight(120);
+    setMouseTracking(true);
+}
+
+void DailyBarsWidget::setValues(QVector<int> values, const QDate& lastDay) {
+    m_values = std::move(values);
+    m_lastDay = lastDay;
+    m_max = m_values.isEmpty() ? 0 : *std::max_element(m_values.cbegin(), m_values.cend());
+    update();
+}
+
+int DailyBarsWidget::barAt(int x) const {
+    if (m_values.isEmpty() || width() <= 0) return -1;
+    const int i = x * m_values.size() / width();
+    return (i >= 0 && i < m_values.size()) ? i : -1;
+}
+
+void DailyBarsWidget::paintEvent(QPaintEvent*) {
+    QPainter p(this);
+    p.setRenderHint(QPainter::Antialiasing, false);
+
+    const QRect area = rect().adjusted(0, 4, 0, -1);
+    const QColor base = palette().color(QPalette::Highlight);
+
+    // Baseline
+    QColor axis = palette().color(QPalette::Text);
+    axis.setAlphaF(0.2);
+    p.setPen(axis);
+    p.drawLine(area.bottomLeft(), area.bottomRight());
+
+    if (m_values.isEmpty() || m_max <= 0) return;
+
+    const int n = m_values.size();
+    const double slot = double(area.width()) / n;
+    const int gap = slot >= 4 ? 1 : 0;
+    p.setPen(Qt::NoPen);
+    for (int i = 0; i < n; ++i) {
+        if (m_values[i] <= 0) continue;
+        const int h = std::max(1, int(double(area.height()) * m_values[i] / m_max));
+        const int x0 = area.left() + int(i * slot);
+        const int x1 = area.left() + int((i + 1) * slot) - gap;
+        QColor c = base;
+        if (i == n - 1) c = c.darker(115); // today
+        p.setBrush(c);
+        p.drawRect(QRect(x0, area.bottom() - h, std::max(1, x1 - x0), h));
+    }
+}
+
+bool DailyBarsWidget::event(QEvent* e) {
+    if (e->type() == QEvent::ToolTip) {
+        const auto* help = static_cast<QHelpEvent*>(e);
+        const int i = barAt(help->pos().x());
+        if (i < 0) {
+            QToolTip::hideText();
+        } else {
+            const QDate day = m_lastDay.addDays(i - (m_values.size() - 1));
+            QToolTip::showText(help->globalPos(),
+                               QString("%1: %2").arg(QLocale().toString(day, QLocale::ShortFormat)).arg(m_values[i]),
+                               this);
+        }
+        return true;
+    }
+    return QWidget::event(e);
+}
+
+} // namespace rewise::ui::widgets
@@ -0,0 +1,36 @@
+#ifndef REWISE_UI_WIDGETS_DAILYBARSWIDGET_H
+#define REWISE_UI_WIDGETS_DAILYBARSWIDGET_H
+
+#include <QDate>
+#include <QVector>
+#include <QWidget>
+
+namespace rewise::ui::widgets {
+
+// Bar chart of one value per day (oldest left), e.g. checks per day.
+// Painted directly; the cost is one rect per day.
+class DailyBarsWidget final : public QWidget {
+    Q_OBJECT
+public:
+    explicit DailyBarsWidget(QWidget* parent = nullptr);
+
+    // values[i] belongs to lastDay - (values.size() - 1 - i).
+    void setValues(QVector<int> values, const QDate& lastDay);
+
+    QSize sizeHint() const override { return {600, 160}; }
+
+protected:
+    bool event(QEvent* e) override; // per-day tooltip
+    void paintEvent(QPaintEvent* e) override;
+
+private:
+    int barAt(int x) const;
+
+    QVector<int> m_values;
+    QDate m_lastDay;
+    int m_max = 0;
+};
+
+} // namespace rewise::ui::widgets
+
+#endif // REWISE_UI_WIDGETS_DAILYBARSWIDGET_H
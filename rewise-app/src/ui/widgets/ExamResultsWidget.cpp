@@ -0,0 +1,138 @@
+#include "ExamResultsWidget.h"
+
+#include "review/ReviewEngine.h"
+#include "ui/widgets/DiffTextWidget.h"
+#include "ui/widgets/NumberItem.h"
+
+#include <QHeaderView>
+#include <QLabel>
+#include <QSplitter>
+#include <QTableWidget>
+#include <QTextBrowser>
+#include <QVBoxLayout>
+
+#include <utility>
+
+namespace rewise::ui::widgets {
+
+namespace {
+
+enum Column { ColNumber, ColQuestion, ColPercent, ColPassed, ColTime, ColumnCount };
+
+constexpr int kQuestionChars = 100;
+
+QString firstLine(const QString& s) {
+    QString line = s.section('\n', 0, 0).simplified();
+    if (line.size() > kQuestionChars || line.size() < s.simplified().size()) line = line.left(kQuestionChars) + "…";
+    return line;
+}
+
+} // namespace
+
+ExamResultsWidget::ExamResultsWidget(QWidget* parent)
+    : QWidget(parent)
+{
+    m_summary = new QLabel(this);
+    m_summary->setStyleSheet("font-size:18px; font-weight:700;");
+
+    m_table = new QTableWidget(0, ColumnCount, this);
+    m_table->setHorizontalHeaderLabels({"№", "Вопрос", "Совпадение", "Зачёт", "Время, с"});
+    m_table->verticalHeader()->setVisible(false);
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_table->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->horizontalHeader()->setSectionResizeMode(ColQuestion, QHeaderView::Stretch);
+    for (int c : {ColNumber, ColPercent, ColPassed, ColTime})
+        m_table->horizontalHeader()->setSectionResizeMode(c, QHeaderView::ResizeToContents);
+
+    auto* details = new QWidget(this);
+    m_reference = new QTextBrowser(details);
+    m_reference->setFrameShape(QFrame::NoFrame);
+    m_diff = new DiffTextWidget(details);
+    auto* detailsLayout = new QVBoxLayout(details);
+    detailsLayout->setContentsMargins(0, 0, 0, 0);
+    detailsLayout->addWidget(new QLabel("Эталонный ответ:", details));
+    detailsLayout->addWidget(m_reference, 1);
+    detailsLayout->addWidget(m_diff, 2);
+
+    auto* splitter = new QSplitter(Qt::Vertical, this);
+    splitter->addWidget(m_table);
+    splitter->addWidget(details);
+    splitter->setStretchFactor(0, 1);
+    splitter->setStretchFactor(1, 1);
+
+    auto* root = new QVBoxLayout(this);
+    root->setContentsMargins(0, 0, 0, 0);
+    root->addWidget(m_summary);
+    root->addWidget(splitter, 1);
+
+    connect(m_table, &QTableWidget::currentCellChanged, this, [this](int row) {
+        const auto* item = row >= 0 ? m_table->item(row, ColNumber) : nullptr;
+        showDetails(item ? item->data(Qt::UserRole).toInt() - 1 : -1);
+    });
+}
+
+void ExamResultsWidget::setResults(QVector<ExamGrade> grades) {
+    m_grades = std::move(grades);
+
+    int answered = 0;
+    int passed = 0;
+    qint64 percentSum = 0;
+    for (const auto& g : m_grades) {
+        answered += g.answered ? 1 : 0;
+        passed += g.passed ? 1 : 0;
+        percentSum += g.percent;
+    }
+    m_summary->setText(m_grades.isEmpty()
+                           ? QString("Нет результатов.")
+                           : QString("Зачтено %1 из %2 · среднее совпадение: %3% · без ответа: %4")
+                                 .arg(passed)
+                                 .arg(m_grades.size())
+                                 .arg(QString::number(double(percentSum) / m_grades.size(), 'f', 1))
+                                 .arg(m_grades.size() - answered));
+
+    m_table->setSortingEnabled(false);
+    m_table->clearContents();
+    m_table->setRowCount(m_grades.size());
+    for (int row = 0; row < m_grades.size(); ++row) {
+        const auto& g = m_grades[row];
+        m_table->setItem(row, ColNumber, numberItem(row + 1, QString::number(row + 1)));
+        m_table->setItem(row, ColQuestion, new QTableWidgetItem(g.error.isEmpty() ? firstLine(g.question) : "—"));
+        m_table->setItem(row, ColPercent, numberItem(g.percent, QString("%1%").arg(g.percent)));
+        m_table->setItem(row, ColPassed, numberItem(g.passed ? 1 : 0,
+                                                    !g.error.isEmpty() ? "ошибка"
+                                                    : !g.answered      ? "нет ответа"
+                                                    : g.passed         ? "да"
+                                                                       : "нет"));
+        m_table->setItem(row, ColTime, g.answered ? numberItem(g.answerMs, QString::number(g.answerMs / 1000.0, 'f', 1))
+                                                  : numberItem(-1, "—"));
+    }
+    m_table->setSortingEnabled(true);
+
+    if (m_grades.isEmpty()) showDetails(-1);
+    else m_table->setCurrentCell(0, ColNumber);
+}
+
+void ExamResultsWidget::clear() {
+    setResults({});
+}
+
+void ExamResultsWidget::showDetails(int grade) {
+    if (grade < 0 || grade >= m_grades.size()) {
+        m_reference->clear();
+        m_diff->clear();
+        return;
+    }
+
+    const auto& g = m_grades[grade];
+    if (!g.error.isEmpty()) {
+        m_reference->setHtml("<div style='opacity:0.7'>Не удалось прочитать карточку: " + g.error.toHtmlEscaped() + "</div>");
+        m_diff->clear();
+        return;
+    }
+    m_reference->setHtml("<div style='white-space:pre-wrap;'>" + g.reference.text.toHtmlEscaped() + "</div>");
+    // One answer at a time, on the GUI thread: the word diff of even a long answer is quick.
+    m_diff->setReviewResult(rewise::review::ReviewEngine::evaluate(g.reference, g.answer, g.metric));
+}
+
+} // namespace rewise::ui::widgets
@@ -0,0 +1,58 @@
+#ifndef REWISE_UI_WIDGETS_EXAMRESULTSWIDGET_H
+#define REWISE_UI_WIDGETS_EXAMRESULTSWIDGET_H
+
+#include "domain/Id.h"
+#include "domain/ReviewSettings.h"
+#include "review/ReviewTypes.h"
+
+#include <QString>
+#include <QVector>
+#include <QWidget>
+
+class QLabel;
+class QTableWidget;
+class QTextBrowser;
+
+namespace rewise::ui::widgets {
+
+class DiffTextWidget;
+
+// One exam question after grading.
+struct ExamGrade final {
+    rewise::domain::Id cardId;
+    QString question;                              // full text
+    QString answer;                                // as typed; empty if not answered
+    rewise::review::PreparedReference reference;
+    rewise::domain::ScoreMetric metric = rewise::domain::ScoreMetric::Characters;
+    int percent = 0;
+    int distance = 0;
+    bool passed = false;
+    bool answered = false;
+    quint32 answerMs = 0;
+    QString error;                                 // non-empty: the card could not be read
+};
+
+// Results of an exam: a sortable table, and the word diff of the selected
+// answer. Diffs are computed only when a row is selected.
+class ExamResultsWidget final : public QWidget {
+    Q_OBJECT
+public:
+    explicit ExamResultsWidget(QWidget* parent = nullptr);
+
+    void setResults(QVector<ExamGrade> grades);
+    void clear();
+
+private:
+    void showDetails(int grade);   // index into m_grades, -1 = none
+
+    QVector<ExamGrade> m_grades;   // in exam order
+
+    QLabel* m_summary = nullptr;
+    QTableWidget* m_table = nullptr;
+    QTextBrowser* m_reference = nullptr;
+    DiffTextWidget* m_diff = nullptr;
+};
+
+} // namespace rewise::ui::widgets
+
+#endif // REWISE_UI_WIDGETS_EXAMRESULTSWIDGET_H
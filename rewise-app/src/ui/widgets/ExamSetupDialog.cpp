@@ -0,0 +1,69 @@
+#include "ExamSetupDialog.h"
+
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QVBoxLayout>
+
+namespace rewise::ui::widgets {
+
+ExamSetupDialog::ExamSetupDialog(const QString& title, int available, QWidget* parent)
+    : QDialog(parent)
+{
+    setWindowTitle("Экзамен");
+    setModal(true);
+
+    auto* info = new QLabel(QString("%1 — карточек: %2. Ответы проверяются после сдачи.").arg(title).arg(available), this);
+    info->setWordWrap(true);
+
+    m_cards = new QSpinBox(this);
+    m_cards->setRange(1, qMax(1, available));
+    m_cards->setValue(qMin(20, qMax(1, available)));
+
+    m_minutes = new QSpinBox(this);
+    m_minutes->setRange(0, 600);
+    m_minutes->setSuffix(" мин");
+    m_minutes->setSpecialValueText("без ограничения");
+    m_minutes->setValue(15);
+
+    auto* form = new QFormLayout();
+    form->addRow("Вопросов:", m_cards);
+    form->addRow("Время:", m_minutes);
+
+    auto* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+    buttons->button(QDialogButtonBox::Ok)->setText("Начать");
+    buttons->button(QDialogButtonBox::Ok)->setEnabled(available > 0);
+
+    auto* root = new QVBoxLayout(this);
+    root->addWidget(info);
+    root->addLayout(form);
+    root->addWidget(buttons);
+
+    connect(buttons, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+}
+
+int ExamSetupDialog::cardCount() const {
+    return m_cards->value();
+}
+
+int ExamSetupDialog::timeLimitMinutes() const {
+    return m_minutes->value();
+}
+
+bool ExamSetupDialog::pick(QWidget* parent,
+                           const QString& title,
+                           int available,
+                           int* outCardCount,
+                           int* outTimeLimitMinutes)
+{
+    ExamSetupDialog dlg(title, available, parent);
+    if (dlg.exec() != QDialog::Accepted) return false;
+    if (outCardCount) *outCardCount = dlg.cardCount();
+    if (outTimeLimitMinutes) *outTimeLimitMinutes = dlg.timeLimitMinutes();
+    return true;
+}
+
+} // namespace rewise::ui::widgets
@@ -0,0 +1,34 @@
+#ifndef REWISE_UI_WIDGETS_EXAMSETUPDIALOG_H
+#define REWISE_UI_WIDGETS_EXAMSETUPDIALOG_H
+
+#include <QDialog>
+#include <QString>
+
+class QSpinBox;
+
+namespace rewise::ui::widgets {
+
+// Size and time limit of an exam over `available` cards.
+class ExamSetupDialog final : public QDialog {
+    Q_OBJECT
+public:
+    ExamSetupDialog(const QString& title, int available, QWidget* parent = nullptr);
+
+    int cardCount() const;
+    int timeLimitMinutes() const;   // 0 = no limit
+
+    // Утилита “в один вызов”
+    static bool pick(QWidget* parent,
+                     const QString& title,
+                     int available,
+                     int* outCardCount,
+                     int* outTimeLimitMinutes);
+
+private:
+    QSpinBox* m_cards = nullptr;
+    QSpinBox* m_minutes = nullptr;
+};
+
+} // namespace rewise::ui::widgets
+
+#endif // REWISE_UI_WIDGETS_EXAMSETUPDIALOG_H
@@ -0,0 +1,57 @@
+#include "FolderListDelegate.h"
+
+#include "FolderListModel.h"
+
+#include <QApplication>
+#include <QFontMetrics>
+#include <QPainter>
+
+namespace rewise::ui::widgets {
+
+void FolderListDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const {
+    const QVariant count = index.data(FolderListModel::CardCountRole);
+    if (!count.isValid()) {
+        QStyledItemDelegate::paint(painter, option, index);
+        return;
+    }
+
+    QStyleOptionViewItem opt(option);
+    initStyleOption(&opt, index);
+    const QString name = opt.text;
+    opt.text.clear();
+
+    // Item frame, hover and selection exactly as for plain items.
+    const QWidget* widget = opt.widget;
+    QStyle* style = widget ? widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_ItemViewItem, &opt, painter, widget);
+
+    const QRect textRect = style->subElementRect(QStyle::SE_ItemViewItemText, &opt, widget);
+    // "due / total" while something is due, just the total otherwise.
+    const int due = index.data(FolderListModel::DueCountRole).toInt();
+    const QString countText = (due > 0) ? QString("%1 / %2").arg(due).arg(count.toInt())
+                                        : QString::number(count.toInt());
+    const QFontMetrics fm(opt.font);
+    const int countWidth = fm.horizontalAdvance(countText);
+    const int gap = fm.averageCharWidth() * 2;
+
+    const bool selected = opt.state.testFlag(QStyle::State_Selected);
+    const QPalette::ColorGroup group = opt.state.testFlag(QStyle::State_Enabled) ? QPalette::Normal : QPalette::Disabled;
+    const QColor textColor = opt.palette.color(group, selected ? QPalette::HighlightedText : QPalette::Text);
+    QColor countColor = textColor;
+    countColor.setAlphaF(0.55);
+
+    painter->save();
+    painter->setFont(opt.font);
+
+    QRect nameRect = textRect;
+    nameRect.setRight(textRect.right() - countWidth - gap);
+    painter->setPen(textColor);
+    painter->drawText(nameRect, Qt::AlignLeft | Qt::AlignVCenter, fm.elidedText(name, Qt::ElideRight, nameRect.width()));
+
+    painter->setPen(countColor);
+    painter->drawText(textRect, Qt::AlignRight | Qt::AlignVCenter, countText);
+
+    painter->restore();
+}
+
+} // namespace rewise::ui::widgets
@@ -0,0 +1,21 @@
+#ifndef REWISE_UI_WIDGETS_FOLDERLISTDELEGATE_H
+#define REWISE_UI_WIDGETS_FOLDERLISTDELEGATE_H
+
+#include <QStyledItemDelegate>
+
+namespace rewise::ui::widgets {
+
+// Folder list item: name on the left, card count (FolderListModel::CardCountRole,
+// prefixed with DueCountRole when cards are due) right-aligned and dimmed.
+// Background/selection are left to the style (QSS).
+class FolderListDelegate final : public QStyledItemDelegate {
+    Q_OBJECT
+public:
+    using QStyledItemDelegate::QStyledItemDelegate;
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+};
+
+} // namespace rewise::ui::widgets
+
+#endif // REWISE_UI_WIDGETS_FOLDERLISTDELEGATE_H
@@ -1,5 +1,7 @@
 #include "FolderListModel.h"
 
+#include "storage/Database.h"
+
 namespace rewise::ui::widgets {
 
 FolderListModel::FolderListModel(QObject* parent)
@@ -20,6 +22,8 @@ QVariant FolderListModel::data(const QModelIndex& index, int role) const {
         if (role == Qt::DisplayRole) return QStringLiteral("Все карточки");
         if (role == IdRole) return QString(); // invalid id
         if (role == IsAllRole) return true;
+        if (role == CardCountRole) return m_total.cards;
+        if (role == DueCountRole) return m_total.due;
         return {};
     }
 
@@ -30,6 +34,8 @@ QVariant FolderListModel::data(const QModelIndex& index, int role) const {
     if (role == Qt::DisplayRole) return f.name;
     if (role == IdRole) return f.id.toString();
     if (role == IsAllRole) return false;
+    if (role == CardCountRole) return m_counts.value(f.id).cards;
+    if (role == DueCountRole) return m_counts.value(f.id).due;
 
     return {};
 }
@@ -45,6 +51,97 @@ void FolderListModel::setFolders(QVector<rewise::domain::Folder> folders) {
     endResetModel();
 }
 
+void FolderListModel::applyChanges(const QVector<rewise::domain::Folder>& folders,
+                                   const rewise::storage::ChangeEvents& events) {
+    using Kind = rewise::storage::ChangeEvent::Kind;
+    const int base = (m_includeAll ? 1 : 0);
+
+    auto indexIn = [](const QVector<rewise::domain::Folder>& list, const rewise::domain::Id& id) {
+        for (int i = 0; i < list.size(); ++i) {
+            if (list[i].id == id) return i;
+        }
+        return -1;
+    };
+
+    for (const auto& e : events) {
+        switch (e.kind) {
+            case Kind::Reset:
+                setFolders(folders);
+                return;
+            case Kind::FolderInserted: {
+                const int target = indexIn(folders, e.id);
+                if (target < 0 || indexOf(e.id) >= 0) break;
+                const int pos = qMin(target, m_folders.size());
+                beginInsertRows(QModelIndex(), base + pos, base + pos);
+                m_folders.insert(pos, folders[target]);
+                endInsertRows();
+                break;
+            }
+            case Kind::FolderRenamed: {
+                const int pos = indexOf(e.id);
+                const int target = indexIn(folders, e.id);
+                if (pos < 0 || target < 0) break;
+                m_folders[pos].name = folders[target].name;
+                emit dataChanged(index(base + pos), index(base + pos), {Qt::DisplayRole});
+                break;
+            }
+            case Kind::FolderSettingsChanged: {
+                const int pos = indexOf(e.id);
+                const int target = indexIn(folders, e.id);
+                if (pos >= 0 && target >= 0) m_folders[pos].scoring = folders[target].scoring;
+                break;
+            }
+            case Kind::FolderRemoved: {
+                const int pos = indexOf(e.id);
+                if (pos < 0) break;
+                beginRemoveRows(QModelIndex(), base + pos, base + pos);
+                m_folders.removeAt(pos);
+                endRemoveRows();
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    // Safety net: the list must match exactly (order included).
+    bool same = m_folders.size() == folders.size();
+    for (int i = 0; same && i < folders.size(); ++i) {
+        same = m_folders[i].id == folders[i].id && m_folders[i].name == folders[i].name;
+    }
+    if (!same) setFolders(folders);
+}
+
+void FolderListModel::refreshCounts(const rewise::storage::Database& db) {
+    const int base = (m_includeAll ? 1 : 0);
+
+    const Counts total{db.cards.size(), db.dueCount()};
+    if (total != m_total) {
+        m_total = total;
+        if (m_includeAll) emit dataChanged(index(0), index(0), {CardCountRole, DueCountRole});
+    }
+
+    QHash<rewise::domain::Id, Counts> counts;
+    counts.reserve(m_folders.size());
+    for (int i = 0; i < m_folders.size(); ++i) {
+        const auto& id = m_folders[i].id;
+        const Counts n{db.cardCountInFolder(id), db.dueCountInFolder(id)};
+        counts.insert(id, n);
+        const auto old = m_counts.constFind(id);
+        if (old == m_counts.constEnd() || *old != n) {
+            emit dataChanged(index(base + i), index(base + i), {CardCountRole, DueCountRole});
+        }
+    }
+    m_counts = std::move(counts);
+}
+
+int FolderListModel::indexOf(const rewise::domain::Id& id) const {
+    for (int i = 0; i < m_folders.size(); ++i) {
+        if (m_folders[i].id == id) return i;
+    }
+    return -1;
+}
+
 void FolderListModel::setIncludeAllItem(bool enabled) {
     if (m_includeAll == enabled) return;
     beginResetModel();
@@ -63,11 +160,8 @@ rewise::domain::Id FolderListModel::idAtRow(int row) const {
 int FolderListModel::rowForId(const rewise::domain::Id& id) const {
     if (!id.isValid()) return (m_includeAll ? 0 : -1);
 
-    const int base = (m_includeAll ? 1 : 0);
-    for (int i = 0; i < m_folders.size(); ++i) {
-        if (m_folders[i].id == id) return i + base;
-    }
-    return -1;
+    const int idx = indexOf(id);
+    return (idx >= 0) ? idx + (m_includeAll ? 1 : 0) : -1;
 }
 
 bool FolderListModel::isAllRow(int row) const {
@@ -3,10 +3,14 @@
 
 #include "domain/Folder.h"
 #include "domain/Id.h"
+#include "storage/ChangeEvents.h"
 
 #include <QAbstractListModel>
+#include <QHash>
 #include <QVector>
 
+namespace rewise::storage { struct Database; }
+
 namespace rewise::ui::widgets {
 
 class FolderListModel final : public QAbstractListModel {
@@ -14,7 +18,9 @@ class FolderListModel final : public QAbstractListModel {
 public:
     enum Roles {
         IdRole = Qt::UserRole + 1,
-        IsAllRole
+        IsAllRole,
+        CardCountRole,  // int; the "all" row counts every card
+        DueCountRole    // int; cards due by the database's due horizon (end of today)
     };
 
     explicit FolderListModel(QObject* parent = nullptr);
@@ -24,8 +30,18 @@ public:
     Qt::ItemFlags flags(const QModelIndex& index) const override;
 
     void setFolders(QVector<rewise::domain::Folder> folders);
+    // Row-level update to `folders` (the list after `events`); resets only if the
+    // events don't explain the new list.
+    void applyChanges(const QVector<rewise::domain::Folder>& folders, const rewise::storage::ChangeEvents& events);
     const QVector<rewise::domain::Folder>& folders() const { return m_folders; }
 
+    // Takes per-folder card and due counts from the database's folder indexes
+    // (O(folders), no card scan) and signals only the rows whose counts changed.
+    // Call after setFolders()/applyChanges().
+    void refreshCounts(const rewise::storage::Database& db);
+    int cardCount(const rewise::domain::Id& folderId) const { return m_counts.value(folderId).cards; }
+    int dueCount(const rewise::domain::Id& folderId) const { return m_counts.value(folderId).due; }
+
     // Row 0 (если включено) — виртуальный пункт "Все карточки".
     void setIncludeAllItem(bool enabled);
     bool includeAllItem() const { return m_includeAll; }
@@ -36,7 +52,17 @@ public:
     bool isAllRow(int row) const;
 
 private:
+    int indexOf(const rewise::domain::Id& id) const;
+
     QVector<rewise::domain::Folder> m_folders;
+    struct Counts final {
+        int cards = 0;
+        int due = 0;
+        bool operator==(const Counts& o) const { return cards == o.cards && due == o.due; }
+        bool operator!=(const Counts& o) const { return !(*this == o); }
+    };
+    QHash<rewise::domain::Id, Counts> m_counts; // folder id -> counts
+    Counts m_total;
     bool m_includeAll = true;
 };
 
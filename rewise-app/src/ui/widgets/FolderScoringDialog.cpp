@@ -0,0 +1,87 @@
+#include "FolderScoringDialog.h"
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QVBoxLayout>
+
+namespace rewise::ui::widgets {
+
+using rewise::domain::ReviewSettings;
+using rewise::domain::ScoreMetric;
+
+FolderScoringDialog::FolderScoringDialog(const QString& folderName,
+                                         const ReviewSettings& settings,
+                                         QWidget* parent)
+    : QDialog(parent)
+{
+    setWindowTitle(QString("Настройки проверки — %1").arg(folderName));
+    setModal(true);
+
+    m_ignoreCase = new QCheckBox("Не различать регистр", this);
+    m_simplifySpaces = new QCheckBox("Не учитывать лишние пробелы", this);
+    m_ignorePunctuation = new QCheckBox("Не учитывать знаки препинания", this);
+
+    m_metric = new QComboBox(this);
+    m_metric->addItem("По символам", static_cast<int>(ScoreMetric::Characters));
+    m_metric->addItem("По словам", static_cast<int>(ScoreMetric::Words));
+
+    m_passPercent = new QSpinBox(this);
+    m_passPercent->setRange(1, 100);
+    m_passPercent->setSuffix("%");
+
+    auto* form = new QFormLayout();
+    form->addRow("Сравнение:", m_metric);
+    form->addRow("Зачёт от:", m_passPercent);
+
+    auto* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel
+                                         | QDialogButtonBox::RestoreDefaults, this);
+
+    auto* root = new QVBoxLayout(this);
+    root->addWidget(m_ignoreCase);
+    root->addWidget(m_simplifySpaces);
+    root->addWidget(m_ignorePunctuation);
+    root->addLayout(form);
+    root->addWidget(buttons);
+
+    connect(buttons, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    connect(buttons->button(QDialogButtonBox::RestoreDefaults), &QPushButton::clicked, this,
+            [this] { setSettings(ReviewSettings{}); });
+
+    setSettings(settings);
+}
+
+void FolderScoringDialog::setSettings(const ReviewSettings& s) {
+    m_ignoreCase->setChecked(s.ignoreCase);
+    m_simplifySpaces->setChecked(s.simplifySpaces);
+    m_ignorePunctuation->setChecked(s.ignorePunctuation);
+    m_metric->setCurrentIndex(qMax(0, m_metric->findData(static_cast<int>(s.metric))));
+    m_passPercent->setValue(s.passPercent);
+}
+
+ReviewSettings FolderScoringDialog::settings() const {
+    ReviewSettings s;
+    s.ignoreCase = m_ignoreCase->isChecked();
+    s.simplifySpaces = m_simplifySpaces->isChecked();
+    s.ignorePunctuation = m_ignorePunctuation->isChecked();
+    s.metric = static_cast<ScoreMetric>(m_metric->currentData().toInt());
+    s.passPercent = m_passPercent->value();
+    return s;
+}
+
+bool FolderScoringDialog::edit(QWidget* parent,
+                               const QString& folderName,
+                               const ReviewSettings& settings,
+                               ReviewSettings* out)
+{
+    FolderScoringDialog dlg(folderName, settings, parent);
+    if (dlg.exec() != QDialog::Accepted) return false;
+    if (out) *out = dlg.settings();
+    return true;
+}
+
+} // namespace rewise::ui::widgets
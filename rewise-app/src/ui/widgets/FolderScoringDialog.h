@@ -0,0 +1,43 @@
+#ifndef REWISE_UI_WIDGETS_FOLDERSCORINGDIALOG_H
+#define REWISE_UI_WIDGETS_FOLDERSCORINGDIALOG_H
+
+#include "domain/ReviewSettings.h"
+
+#include <QDialog>
+#include <QString>
+
+class QCheckBox;
+class QComboBox;
+class QSpinBox;
+
+namespace rewise::ui::widgets {
+
+// Edits how answers to the cards of one folder are scored.
+class FolderScoringDialog final : public QDialog {
+    Q_OBJECT
+public:
+    FolderScoringDialog(const QString& folderName,
+                        const rewise::domain::ReviewSettings& settings,
+                        QWidget* parent = nullptr);
+
+    rewise::domain::ReviewSettings settings() const;
+
+    // Утилита “в один вызов”
+    static bool edit(QWidget* parent,
+                     const QString& folderName,
+                     const rewise::domain::ReviewSettings& settings,
+                     rewise::domain::ReviewSettings* out);
+
+private:
+    void setSettings(const rewise::domain::ReviewSettings& s);
+
+    QCheckBox* m_ignoreCase = nullptr;
+    QCheckBox* m_simplifySpaces = nullptr;
+    QCheckBox* m_ignorePunctuation = nullptr;
+    QComboBox* m_metric = nullptr;
+    QSpinBox* m_passPercent = nullptr;
+};
+
+} // namespace rewise::ui::widgets
+
+#endif // REWISE_UI_WIDGETS_FOLDERSCORINGDIALOG_H
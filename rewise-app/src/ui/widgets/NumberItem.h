@@ -0,0 +1,31 @@
+#ifndef REWISE_UI_WIDGETS_NUMBERITEM_H
+#define REWISE_UI_WIDGETS_NUMBERITEM_H
+
+#include <QString>
+#include <QTableWidgetItem>
+
+namespace rewise::ui::widgets {
+
+// Shows text, sorts by a number (Display and Edit roles share one value in
+// QTableWidgetItem, so the key lives in UserRole).
+class NumberItem final : public QTableWidgetItem {
+public:
+    NumberItem(double value, const QString& text)
+        : QTableWidgetItem(text)
+    {
+        setData(Qt::UserRole, value);
+        setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    }
+
+    bool operator<(const QTableWidgetItem& other) const override {
+        return data(Qt::UserRole).toDouble() < other.data(Qt::UserRole).toDouble();
+    }
+};
+
+inline QTableWidgetItem* numberItem(double value, const QString& text) {
+    return new NumberItem(value, text);
+}
+
+} // namespace rewise::ui::widgets
+
+#endif // REWISE_UI_WIDGETS_NUMBERITEM_H
@@ -0,0 +1,88 @@
+#include "ReviewFoldersDialog.h"
+
+#include <QComboBox>
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QListWidget>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+namespace rewise::ui::widgets {
+
+using rewise::review::SessionOrder;
+
+ReviewFoldersDialog::ReviewFoldersDialog(const rewise::storage::Database& db,
+                                         const QVector<rewise::domain::Id>& checked,
+                                         QWidget* parent)
+    : QDialog(parent)
+{
+    setWindowTitle("Повторение нескольких папок");
+    setModal(true);
+
+    m_folders = new QListWidget(this);
+    for (const auto& f : db.folders) {
+        const int due = db.dueCountInFolder(f.id);
+        const int total = db.cardCountInFolder(f.id);
+        auto* item = new QListWidgetItem(QString("%1 — к повторению %2 из %3").arg(f.name).arg(due).arg(total), m_folders);
+        item->setData(Qt::UserRole, f.id.value);
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(checked.contains(f.id) ? Qt::Checked : Qt::Unchecked);
+    }
+
+    m_order = new QComboBox(this);
+    m_order->addItem("По сроку", static_cast<int>(SessionOrder::Due));
+    m_order->addItem("Все вперемешку", static_cast<int>(SessionOrder::Shuffled));
+    m_order->addItem("Сначала трудные", static_cast<int>(SessionOrder::Weighted));
+
+    auto* form = new QFormLayout();
+    form->addRow("Порядок:", m_order);
+
+    auto* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+    buttons->button(QDialogButtonBox::Ok)->setText("Начать");
+
+    auto* root = new QVBoxLayout(this);
+    root->addWidget(m_folders);
+    root->addLayout(form);
+    root->addWidget(buttons);
+
+    connect(buttons, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    connect(m_folders, &QListWidget::itemChanged, this, [this] { validateNow(); });
+
+    validateNow();
+}
+
+void ReviewFoldersDialog::validateNow() {
+    auto* box = findChild<QDialogButtonBox*>();
+    if (box) box->button(QDialogButtonBox::Ok)->setEnabled(!folderIds().isEmpty());
+}
+
+QVector<rewise::domain::Id> ReviewFoldersDialog::folderIds() const {
+    QVector<rewise::domain::Id> out;
+    for (int i = 0; i < m_folders->count(); ++i) {
+        const auto* item = m_folders->item(i);
+        if (item->checkState() == Qt::Checked) out.push_back(rewise::domain::Id{item->data(Qt::UserRole).toUuid()});
+    }
+    return out;
+}
+
+SessionOrder ReviewFoldersDialog::order() const {
+    return static_cast<SessionOrder>(m_order->currentData().toInt());
+}
+
+bool ReviewFoldersDialog::pick(QWidget* parent,
+                               const rewise::storage::Database& db,
+                               const QVector<rewise::domain::Id>& checked,
+                               QVector<rewise::domain::Id>* outFolderIds,
+                               rewise::review::SessionOrder* outOrder)
+{
+    ReviewFoldersDialog dlg(db, checked, parent);
+    if (dlg.exec() != QDialog::Accepted) return false;
+    const auto ids = dlg.folderIds();
+    if (ids.isEmpty()) return false;
+    if (outFolderIds) *outFolderIds = ids;
+    if (outOrder) *outOrder = dlg.order();
+    return true;
+}
+
+} // namespace rewise::ui::widgets
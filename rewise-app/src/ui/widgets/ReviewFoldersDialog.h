@@ -0,0 +1,43 @@
+#ifndef REWISE_UI_WIDGETS_REVIEWFOLDERSDIALOG_H
+#define REWISE_UI_WIDGETS_REVIEWFOLDERSDIALOG_H
+
+#include "domain/Id.h"
+#include "review/CardOrder.h"
+#include "storage/Database.h"
+
+#include <QDialog>
+#include <QVector>
+
+class QComboBox;
+class QListWidget;
+
+namespace rewise::ui::widgets {
+
+// Picks the folders (any number) and the order of a review session.
+class ReviewFoldersDialog final : public QDialog {
+    Q_OBJECT
+public:
+    ReviewFoldersDialog(const rewise::storage::Database& db,
+                        const QVector<rewise::domain::Id>& checked,
+                        QWidget* parent = nullptr);
+
+    QVector<rewise::domain::Id> folderIds() const;   // in folder list order
+    rewise::review::SessionOrder order() const;
+
+    // Утилита “в один вызов”
+    static bool pick(QWidget* parent,
+                     const rewise::storage::Database& db,
+                     const QVector<rewise::domain::Id>& checked,
+                     QVector<rewise::domain::Id>* outFolderIds,
+                     rewise::review::SessionOrder* outOrder);
+
+private:
+    void validateNow();
+
+    QListWidget* m_folders = nullptr;
+    QComboBox* m_order = nullptr;
+};
+
+} // namespace rewise::ui::widgets
+
+#endif // REWISE_UI_WIDGETS_REVIEWFOLDERSDIALOG_H
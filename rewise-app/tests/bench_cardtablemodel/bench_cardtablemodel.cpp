@@ -0,0 +1,80 @@
+#include "domain/Card.h"
+#include "storage/Database.h"
+#include "ui/widgets/CardTableModel.h"
+
+#include <QRandomGenerator>
+#include <QSignalSpy>
+#include <QtTest>
+
+using rewise::domain::Card;
+using rewise::domain::Id;
+using rewise::ui::widgets::CardTableModel;
+
+// data() over sliding row windows of a 100k-row card table: what the view asks
+// for while the user scrolls. Rows outside the model's display cache cost a
+// preview and a date format each; rows inside it cost a cache lookup.
+class BenchCardTableModel final : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void dataInWindows_data();
+    void dataInWindows();
+
+private:
+    static constexpr int kCards = 100000;
+    static constexpr int kWindowRows = 40; // about one screen of the table
+
+    CardTableModel m_model;
+};
+
+void BenchCardTableModel::initTestCase() {
+    rewise::storage::Database db;
+    const Id folderId = db.ensureDefaultFolder();
+
+    QRandomGenerator rng(20240601); // fixed seed: the same table on every run
+    const qint64 base = 1700000000000;
+    const QString filler = QStringLiteral("Длинный текст ответа, который таблица обрезает до превью. ");
+    for (int i = 0; i < kCards; ++i) {
+        Card c;
+        c.id = Id::create();
+        c.folderId = folderId;
+        c.question = QString("Вопрос %1: что такое\nтермин номер %1?").arg(i);
+        c.answer = filler.repeated(1 + static_cast<int>(rng.bounded(4)));
+        c.createdAtMsUtc = base + static_cast<qint64>(rng.bounded(365 * 24 * 3600)) * 1000;
+        c.updatedAtMsUtc = c.createdAtMsUtc;
+        db.addCard(c);
+    }
+    db.clearPendingChanges();
+
+    QSignalSpy ready(&m_model, &CardTableModel::viewReady);
+    m_model.setDatabase(rewise::storage::makeSnapshot(db));
+    QVERIFY(ready.wait(60000));
+    QCOMPARE(m_model.rowCount(), kCards);
+}
+
+void BenchCardTableModel::dataInWindows_data() {
+    QTest::addColumn<int>("step");
+
+    QTest::newRow("scroll by one row") << 1;
+    QTest::newRow("page down") << kWindowRows;
+    QTest::newRow("jump") << 7919; // prime: windows land all over the table
+}
+
+void BenchCardTableModel::dataInWindows() {
+    QFETCH(int, step);
+
+    int first = 0;
+    QBENCHMARK {
+        for (int row = first; row < first + kWindowRows; ++row) {
+            for (int col = 0; col < CardTableModel::ColCount; ++col) {
+                m_model.data(m_model.index(row % kCards, col), Qt::DisplayRole);
+            }
+        }
+        first = (first + step) % kCards;
+    }
+}
+
+QTEST_GUILESS_MAIN(BenchCardTableModel)
+
+#include "bench_cardtablemodel.moc"
@@ -0,0 +1,17 @@
+include(../tests.pri)
+
+TARGET = bench_cardtablemodel
+
+SOURCES += \
+    bench_cardtablemodel.cpp \
+    $$APP_SRC/review/Levenshtein.cpp \
+    $$APP_SRC/storage/CardBodyStore.cpp \
+    $$APP_SRC/storage/CardStore.cpp \
+    $$APP_SRC/storage/Database.cpp \
+    $$APP_SRC/storage/FuzzySearch.cpp \
+    $$APP_SRC/storage/TextArena.cpp \
+    $$APP_SRC/storage/TextIndex.cpp \
+    $$APP_SRC/ui/widgets/CardTableModel.cpp
+
+HEADERS += \
+    $$APP_SRC/ui/widgets/CardTableModel.h
@@ -0,0 +1,84 @@
+#include "storage/TextIndex.h"
+
+#include <QRandomGenerator>
+#include <QtTest>
+
+using rewise::storage::TextIndex;
+
+// TextIndex::candidates() on 500k cards, for the query lengths a search goes
+// through while the user types: 1-2 characters hit the short-gram postings,
+// 3 and more intersect trigram postings. The target is a few milliseconds per
+// keystroke.
+class BenchTextIndex final : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void candidates_data();
+    void candidates();
+
+private:
+    static constexpr int kCards = 500000;
+    static constexpr int kWords = 20000;
+
+    QString randomWord(QRandomGenerator* rng) const;
+    QString randomText(QRandomGenerator* rng, int words) const;
+
+    QVector<QString> m_vocab;
+    TextIndex m_index;
+};
+
+QString BenchTextIndex::randomWord(QRandomGenerator* rng) const {
+    static const QString letters = QStringLiteral("абвгдеёжзийклмнопрстуфхцчшщъыьэюяabcdefghijklmnopqrstuvwxyz");
+    QString w;
+    const int n = 3 + static_cast<int>(rng->bounded(8));
+    for (int i = 0; i < n; ++i) w += letters[static_cast<int>(rng->bounded(letters.size()))];
+    return w;
+}
+
+QString BenchTextIndex::randomText(QRandomGenerator* rng, int words) const {
+    QStringList out;
+    for (int i = 0; i < words; ++i) out << m_vocab[static_cast<int>(rng->bounded(m_vocab.size()))];
+    return out.join(' ');
+}
+
+void BenchTextIndex::initTestCase() {
+    QRandomGenerator rng(20240602); // fixed seed: the same index on every run
+    m_vocab.reserve(kWords);
+    for (int i = 0; i < kWords; ++i) m_vocab.push_back(randomWord(&rng));
+
+    for (int row = 0; row < kCards; ++row) m_index.addRow(row, randomText(&rng, 6), randomText(&rng, 14));
+    QVERIFY(!m_index.isEmpty());
+}
+
+void BenchTextIndex::candidates_data() {
+    QTest::addColumn<int>("length");
+
+    QTest::newRow("1 char") << 1;
+    QTest::newRow("2 chars") << 2;
+    QTest::newRow("3 chars") << 3;
+    QTest::newRow("6 chars") << 6;
+}
+
+void BenchTextIndex::candidates() {
+    QFETCH(int, length);
+
+    // Prefixes of real words: what typing a word from the library produces.
+    QVector<QString> queries;
+    for (const QString& w : m_vocab) {
+        if (w.size() >= length) queries.push_back(w.left(length));
+        if (queries.size() == 64) break;
+    }
+    QVERIFY(!queries.isEmpty());
+
+    int next = 0;
+    QVector<int> hits;
+    QBENCHMARK {
+        QVERIFY(m_index.candidates(queries[next], &hits));
+        next = (next + 1) % queries.size();
+    }
+}
+
+QTEST_GUILESS_MAIN(BenchTextIndex)
+
+#include "bench_textindex.moc"
@@ -0,0 +1,7 @@
+include(../tests.pri)
+
+TARGET = bench_textindex
+
+SOURCES += \
+    bench_textindex.cpp \
+    $$APP_SRC/storage/TextIndex.cpp
@@ -0,0 +1,12 @@
+# Shared settings of the test/benchmark targets: each one compiles the app
+# sources it exercises (listed in its own .pro) against QtTest.
+TEMPLATE = app
+
+QT += testlib concurrent
+QT -= gui
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+APP_SRC = $$PWD/../src
+INCLUDEPATH += $$APP_SRC
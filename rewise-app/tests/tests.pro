@@ -0,0 +1,10 @@
+TEMPLATE = subdirs
+
+# QtTest targets over the app's sources. Build and run from a build directory:
+#   qmake <path>/tests/tests.pro && make && make check
+SUBDIRS += \
+    bench_cardtablemodel \
+    bench_textindex \
+    tst_cardorder \
+    tst_repository \
+    tst_reviewlog
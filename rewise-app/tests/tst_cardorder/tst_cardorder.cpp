@@ -0,0 +1,49 @@
+#include "review/CardOrder.h"
+
+#include <QtTest>
+
+using rewise::review::ShuffledDeck;
+
+// A shuffled session resumed from its file: the deck built again from the
+// recorded cards and seed must deal what the interrupted one would have.
+class TestCardOrder final : public QObject {
+    Q_OBJECT
+
+private slots:
+    void replayContinuesTheDeck_data();
+    void replayContinuesTheDeck();
+};
+
+void TestCardOrder::replayContinuesTheDeck_data() {
+    QTest::addColumn<int>("dealt");
+
+    QTest::newRow("nothing dealt") << 0;
+    QTest::newRow("first pass") << 5;
+    QTest::newRow("end of a pass") << 10;
+    QTest::newRow("third pass") << 27;
+}
+
+void TestCardOrder::replayContinuesTheDeck() {
+    QFETCH(int, dealt);
+
+    constexpr quint32 kSeed = 20240602;
+    QVector<int> cards;
+    for (int i = 0; i < 10; ++i) cards.push_back(i * 3);
+
+    ShuffledDeck original(cards, kSeed);
+    int lastDealt = -1;
+    for (int i = 0; i < dealt; ++i) lastDealt = original.next();
+    const int pass = original.round();
+
+    ShuffledDeck resumed(cards, kSeed);
+    resumed.replay(pass, lastDealt);
+    QCOMPARE(resumed.round(), pass);
+    for (int i = 0; i < 25; ++i) {
+        QCOMPARE(resumed.next(), original.next());
+        QCOMPARE(resumed.round(), original.round());
+    }
+}
+
+QTEST_GUILESS_MAIN(TestCardOrder)
+
+#include "tst_cardorder.moc"
@@ -0,0 +1,8 @@
+include(../tests.pri)
+
+TARGET = tst_cardorder
+
+SOURCES += \
+    tst_cardorder.cpp \
+    $$APP_SRC/review/AliasSampler.cpp \
+    $$APP_SRC/review/CardOrder.cpp
@@ -0,0 +1,145 @@
+#include "storage/Database.h"
+#include "storage/Repository.h"
+#include "storage/StorageJson.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+#include <QtTest>
+
+using rewise::domain::Card;
+using rewise::domain::Folder;
+using rewise::domain::Id;
+using rewise::storage::Database;
+using rewise::storage::Repository;
+using rewise::storage::StorageBackend;
+
+// Sharded layout: a card moved between folders is written to two shards. A
+// crash after the first write leaves a copy in each; the load must keep the
+// moved one.
+class TestRepository final : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void moveCardCopyWinsAfterCrashBetweenShards();
+    void updateCardMoveWinsAfterCrashBetweenShards();
+
+private:
+    // A saved database with folders A and B and one card in A.
+    void setUp(Repository* repo, Database* db);
+    QString shardPath(const Repository& repo, const Id& folderId) const;
+    static QByteArray readFile(const QString& path);
+    static void writeFile(const QString& path, const QByteArray& bytes);
+
+    Id m_a;
+    Id m_b;
+    Id m_card;
+};
+
+void TestRepository::initTestCase() {
+    QStandardPaths::setTestModeEnabled(true);
+    QCoreApplication::setApplicationName("tst_repository");
+}
+
+void TestRepository::init() {
+    QDir(StorageBackend::databaseDirPath()).removeRecursively();
+}
+
+void TestRepository::setUp(Repository* repo, Database* db) {
+    QString err;
+    QVERIFY2(repo->load(db, &err), qPrintable(err));
+
+    Folder a;
+    a.id = Id::create();
+    a.name = "A";
+    db->addFolder(a);
+    Folder b;
+    b.id = Id::create();
+    b.name = "B";
+    db->addFolder(b);
+
+    Card c;
+    c.id = Id::create();
+    c.folderId = a.id;
+    c.setText("question", "answer");
+    c.touchCreatedNow();
+    db->addCard(c);
+
+    QVERIFY2(repo->save(*db, &err), qPrintable(err));
+    db->clearPendingChanges();
+
+    m_a = a.id;
+    m_b = b.id;
+    m_card = c.id;
+}
+
+QString TestRepository::shardPath(const Repository& repo, const Id& folderId) const {
+    return QDir(repo.shardsDirPath()).filePath(folderId.toString() + rewise::storage::json_keys::kShardSuffix);
+}
+
+QByteArray TestRepository::readFile(const QString& path) {
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return {};
+    return f.readAll();
+}
+
+void TestRepository::writeFile(const QString& path, const QByteArray& bytes) {
+    QFile f(path);
+    QVERIFY(f.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QCOMPARE(f.write(bytes), qint64(bytes.size()));
+}
+
+void TestRepository::moveCardCopyWinsAfterCrashBetweenShards() {
+    Repository repo;
+    Database db;
+    setUp(&repo, &db);
+    if (QTest::currentTestFailed()) return;
+
+    const QByteArray oldA = readFile(shardPath(repo, m_a));
+    QVERIFY(!oldA.isEmpty());
+
+    // Same millisecond as the card's creation: the move must still win.
+    QVERIFY(db.moveCard(m_card, m_b));
+    QString err;
+    QVERIFY2(repo.save(db, &err), qPrintable(err));
+
+    // Crash after B was written, before A: A still holds its old copy.
+    writeFile(shardPath(repo, m_a), oldA);
+
+    Database loaded;
+    QVERIFY2(repo.load(&loaded, &err), qPrintable(err));
+    QCOMPARE(loaded.cards.size(), 1);
+    QCOMPARE(loaded.cardById(m_card)->folderId, m_b);
+    QCOMPARE(loaded.cardCountInFolder(m_a), 0);
+}
+
+void TestRepository::updateCardMoveWinsAfterCrashBetweenShards() {
+    Repository repo;
+    Database db;
+    setUp(&repo, &db);
+    if (QTest::currentTestFailed()) return;
+
+    const QByteArray oldA = readFile(shardPath(repo, m_a));
+
+    // An edit that only changes the folder, keeping updatedAtMsUtc as it was.
+    Card edited = *db.cardById(m_card);
+    edited.folderId = m_b;
+    QVERIFY(db.updateCard(edited));
+    QVERIFY(db.cardById(m_card)->updatedAtMsUtc > edited.updatedAtMsUtc);
+    QString err;
+    QVERIFY2(repo.save(db, &err), qPrintable(err));
+
+    writeFile(shardPath(repo, m_a), oldA);
+
+    Database loaded;
+    QVERIFY2(repo.load(&loaded, &err), qPrintable(err));
+    QCOMPARE(loaded.cards.size(), 1);
+    QCOMPARE(loaded.cardById(m_card)->folderId, m_b);
+}
+
+QTEST_GUILESS_MAIN(TestRepository)
+
+#include "tst_repository.moc"
@@ -0,0 +1,11 @@
+include(../tests.pri)
+
+TARGET = tst_repository
+
+SOURCES += \
+    tst_repository.cpp \
+    $$APP_SRC/storage/CardBodyStore.cpp \
+    $$APP_SRC/storage/Database.cpp \
+    $$APP_SRC/storage/Repository.cpp \
+    $$APP_SRC/storage/StorageBackend.cpp \
+    $$APP_SRC/storage/TextArena.cpp
@@ -0,0 +1,199 @@
+#include "storage/ReviewLog.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QtTest>
+
+using rewise::domain::Id;
+using rewise::storage::ReviewLog;
+using rewise::storage::ReviewRecord;
+
+// The history file across reopen: two sealed segments plus an unsealed tail,
+// both queries, and the torn-tail cut.
+class TestReviewLog final : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void historyOfCardAfterReopen();
+    void recordsOnDaysAfterReopen();
+    void queuedRecordsAreIncluded();
+    void tornTailIsCutOnOpen();
+
+private:
+    static constexpr int kRecords = 2 * ReviewLog::kSegmentRecords + 1000;
+    static constexpr int kCards = 37;          // coprime with the segment size: ids spread over all segments
+    static constexpr int kRecordsPerDay = 1000; // day runs cross segment boundaries
+    static constexpr qint32 kFirstDay = 2460000;
+    static constexpr qint64 kFirstMs = 1700000000000;
+
+    static ReviewRecord recordAt(int i);
+    static QVector<qint64> times(const QVector<ReviewRecord>& records);
+
+    QString path() const { return m_dir.filePath("history.bin"); }
+
+    QTemporaryDir m_dir;
+    QVector<Id> m_cards;
+    QVector<ReviewRecord> m_written; // everything in the file, in log order
+};
+
+ReviewRecord TestReviewLog::recordAt(int i) {
+    ReviewRecord r;
+    r.atMsUtc = kFirstMs + i; // unique: identifies the record below
+    r.day = kFirstDay + i / kRecordsPerDay;
+    r.answerMs = static_cast<quint32>(1000 + i % 5000);
+    r.optionsHash = 0x5eed;
+    r.distance = static_cast<quint16>(i % 7);
+    r.percent = static_cast<quint8>(i % 101);
+    return r;
+}
+
+QVector<qint64> TestReviewLog::times(const QVector<ReviewRecord>& records) {
+    QVector<qint64> out;
+    out.reserve(records.size());
+    for (const ReviewRecord& r : records) out.push_back(r.atMsUtc);
+    return out;
+}
+
+void TestReviewLog::initTestCase() {
+    QVERIFY(m_dir.isValid());
+    for (int i = 0; i < kCards; ++i) m_cards.push_back(Id::create());
+
+    ReviewLog log(path());
+    QString err;
+    QVERIFY2(log.open(&err), qPrintable(err));
+
+    // Uneven batches, so segments get sealed in the middle of a flush.
+    for (int i = 0; i < kRecords; ++i) {
+        ReviewRecord r = recordAt(i);
+        r.cardId = m_cards[i % kCards];
+        log.append(r);
+        m_written.push_back(r);
+        if (i % 3001 == 3000) QVERIFY2(log.flush(&err), qPrintable(err));
+    }
+    QVERIFY2(log.flush(&err), qPrintable(err));
+    QCOMPARE(log.recordCount(), qint64(kRecords));
+}
+
+void TestReviewLog::historyOfCardAfterReopen() {
+    ReviewLog log(path());
+    QString err;
+    QVERIFY2(log.open(&err), qPrintable(err));
+    QCOMPARE(log.recordCount(), qint64(kRecords));
+
+    for (int k : {0, 1, kCards - 1}) {
+        QVector<ReviewRecord> expected;
+        for (const ReviewRecord& r : m_written) {
+            if (r.cardId == m_cards[k]) expected.push_back(r);
+        }
+
+        QVector<ReviewRecord> history;
+        QVERIFY2(log.historyOfCard(m_cards[k], &history, &err), qPrintable(err));
+        QCOMPARE(times(history), times(expected));
+        for (const ReviewRecord& r : history) {
+            QCOMPARE(r.cardId, m_cards[k]);
+            const ReviewRecord& w = m_written[static_cast<int>(r.atMsUtc - kFirstMs)];
+            QCOMPARE(r.day, w.day);
+            QCOMPARE(r.answerMs, w.answerMs);
+            QCOMPARE(r.optionsHash, w.optionsHash);
+            QCOMPARE(r.distance, w.distance);
+            QCOMPARE(r.percent, w.percent);
+        }
+    }
+
+    QVector<ReviewRecord> none;
+    QVERIFY2(log.historyOfCard(Id::create(), &none, &err), qPrintable(err));
+    QVERIFY(none.isEmpty());
+}
+
+void TestReviewLog::recordsOnDaysAfterReopen() {
+    ReviewLog log(path());
+    QString err;
+    QVERIFY2(log.open(&err), qPrintable(err));
+
+    const qint32 lastDay = kFirstDay + (kRecords - 1) / kRecordsPerDay;
+    const QVector<QPair<qint32, qint32>> ranges = {
+        {kFirstDay, kFirstDay},         // first run of the first segment
+        {kFirstDay + 3, kFirstDay + 5}, // spans the first segment boundary
+        {lastDay - 1, lastDay},         // sealed segment + unsealed tail
+        {kFirstDay, lastDay},           // everything
+        {lastDay + 1, lastDay + 10},    // nothing
+    };
+    for (const auto& range : ranges) {
+        QVector<ReviewRecord> expected;
+        for (const ReviewRecord& r : m_written) {
+            if (r.day >= range.first && r.day <= range.second) expected.push_back(r);
+        }
+
+        QVector<ReviewRecord> got;
+        QVERIFY2(log.recordsOnDays(range.first, range.second, &got, &err), qPrintable(err));
+        QCOMPARE(times(got), times(expected));
+    }
+}
+
+void TestReviewLog::queuedRecordsAreIncluded() {
+    ReviewLog log(path());
+    QString err;
+    QVERIFY2(log.open(&err), qPrintable(err));
+
+    ReviewRecord queued = recordAt(kRecords);
+    queued.cardId = m_cards[0];
+    log.append(queued);
+
+    QVector<ReviewRecord> history;
+    QVERIFY2(log.historyOfCard(m_cards[0], &history, &err), qPrintable(err));
+    QVERIFY(!history.isEmpty());
+    QCOMPARE(history.last().atMsUtc, queued.atMsUtc);
+
+    QVector<ReviewRecord> onDay;
+    QVERIFY2(log.recordsOnDays(queued.day, queued.day, &onDay, &err), qPrintable(err));
+    QVERIFY(!onDay.isEmpty());
+    QCOMPARE(onDay.last().atMsUtc, queued.atMsUtc);
+    // Not flushed: the file is left as initTestCase() wrote it.
+}
+
+void TestReviewLog::tornTailIsCutOnOpen() {
+    const qint64 intactBytes = QFileInfo(path()).size();
+
+    // A crash in the middle of writing a record leaves part of it behind.
+    {
+        QFile f(path());
+        QVERIFY(f.open(QIODevice::Append));
+        const QByteArray partial(ReviewLog::kRecordBytes / 2, '\x7f');
+        QCOMPARE(f.write(partial), qint64(partial.size()));
+    }
+    QCOMPARE(QFileInfo(path()).size(), intactBytes + ReviewLog::kRecordBytes / 2);
+
+    QString err;
+    ReviewRecord next = recordAt(kRecords);
+    next.cardId = m_cards[1];
+    {
+        ReviewLog log(path());
+        QVERIFY2(log.open(&err), qPrintable(err));
+        QCOMPARE(log.recordCount(), qint64(kRecords));
+        QCOMPARE(QFileInfo(path()).size(), intactBytes);
+
+        // The next record lands where the torn one started.
+        log.append(next);
+        QVERIFY2(log.flush(&err), qPrintable(err));
+    }
+
+    ReviewLog log(path());
+    QVERIFY2(log.open(&err), qPrintable(err));
+    QCOMPARE(log.recordCount(), qint64(kRecords) + 1);
+
+    QVector<ReviewRecord> history;
+    QVERIFY2(log.historyOfCard(m_cards[1], &history, &err), qPrintable(err));
+    QVERIFY(!history.isEmpty());
+    QCOMPARE(history.last().atMsUtc, next.atMsUtc);
+    QCOMPARE(history.last().percent, next.percent);
+
+    QVector<ReviewRecord> onDay;
+    QVERIFY2(log.recordsOnDays(next.day, next.day, &onDay, &err), qPrintable(err));
+    QCOMPARE(onDay.last().atMsUtc, next.atMsUtc);
+}
+
+QTEST_GUILESS_MAIN(TestReviewLog)
+
+#include "tst_reviewlog.moc"
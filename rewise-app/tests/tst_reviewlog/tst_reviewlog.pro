@@ -0,0 +1,7 @@
+include(../tests.pri)
+
+TARGET = tst_reviewlog
+
+SOURCES += \
+    tst_reviewlog.cpp \
+    $$APP_SRC/storage/ReviewLog.cpp